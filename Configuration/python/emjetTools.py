@@ -34,6 +34,9 @@ def addSkim(process, isData=False, doJetFilter=True, doHLT=False):
     process.jetFilter = cms.EDFilter("JetFilter",
         doFilter = cms.bool( doFilter ),
         srcJets = cms.InputTag("ak4PFJetsCHS"),
+        # If True, selectedJets is a PFJetRefVector into srcJets instead of a copied PFJetCollection
+        # emJetAnalyzer accepts either form, EmergingJetAnalyzer requires copies
+        outputRefs = cms.untracked.bool( False ),
         # srcJets = cms.InputTag("patJets"),
         # additionalCut = cms.string(""),
         additionalCut = cms.string("abs(eta) < 2.5 && pt > 50.0"),
@@ -100,10 +103,14 @@ def addWJetSkim(process, isData=False):
         daqPartitions = cms.uint32( 1 ),
         throw = cms.bool( False )
     )
+    from EmergingJetAnalysis.LeptonPreselector.leptonPreselector_cff import leptonPreselector
+    process.leptonPreselector = leptonPreselector.clone(
+        electronIDs = cms.vstring('cutBasedElectronID-Spring15-25ns-V1-standalone-medium'),
+        # electronIDs = cms.vstring('cutBasedElectronID-CSA14-50ns-V1-standalone-medium'),
+    )
     process.wJetFilter = cms.EDFilter("WJetFilter",
         isData = cms.bool( False ),
-        srcMuons = cms.InputTag("slimmedMuons"),
-        srcElectrons = cms.InputTag("slimmedElectrons"),
+        srcLeptons = cms.InputTag("leptonPreselector"),
         srcJets = cms.InputTag("slimmedJets"),
         srcMET = cms.InputTag("slimmedMETs"),
         minPtMuon = cms.double(20.0),
@@ -115,13 +122,22 @@ def addWJetSkim(process, isData=False):
         maxDeltaPhi = cms.double(0.4), # Doesn't do anything
         minPtSelectedJet = cms.double(20.0),
         maxPtAdditionalJets = cms.double(20.0), # Doesn't do anything
-        electronID = cms.string('cutBasedElectronID-Spring15-25ns-V1-standalone-medium'),
-        # electronID = cms.string('cutBasedElectronID-CSA14-50ns-V1-standalone-medium'),
+        electronIDBit = cms.uint32(0), # Index in leptonPreselector.electronIDs
+        muonIDBit = cms.uint32(0), # Index in leptonPreselector.muonIDs
     )
     if isData: process.wJetFilter.isData = cms.bool(True)
     process.eventCountPreTrigger = cms.EDAnalyzer('EventCounter')
     process.eventCountPreFilter = cms.EDAnalyzer('EventCounter')
     process.eventCountPostFilter = cms.EDAnalyzer('EventCounter')
+    process = addMiniAOD(process, isData)
+    # Ignore trigger selection if MC
+    if isData:
+        return cms.Sequence(process.eventCountPreTrigger * (process.triggerSelection) * process.eventCountPreFilter * process.leptonPreselector * process.wJetFilter * process.eventCountPostFilter)
+    else:
+        return cms.Sequence(process.eventCountPreTrigger * cms.ignore(process.triggerSelection) * process.eventCountPreFilter * process.leptonPreselector * process.wJetFilter * process.eventCountPostFilter)
+
+def addMiniAOD(process, isData=False):
+    """Recreate miniAOD collections (slimmed*) from AOD"""
     ############################################################
     # Recreate miniAOD
     ############################################################
@@ -140,11 +156,24 @@ def addWJetSkim(process, isData=False):
         #call to customisation function miniAOD_customizeAllMC imported from PhysicsTools.PatAlgos.slimming.miniAOD_tools
         process = miniAOD_customizeAllMC(process)
     ############################################################
-    # Ignore trigger selection if MC
-    if isData:
-        return cms.Sequence(process.eventCountPreTrigger * (process.triggerSelection) * process.eventCountPreFilter * process.wJetFilter * process.eventCountPostFilter)
-    else:
-        return cms.Sequence(process.eventCountPreTrigger * cms.ignore(process.triggerSelection) * process.eventCountPreFilter * process.wJetFilter * process.eventCountPostFilter)
+    return process
+
+def addMultiSkim(process, isData=False, regions=None):
+    """Evaluate signal, W+jet, Z+jet and gen HT skims in one pass over the input.
+    Check multiSkimFilter:regionMask to select events for a given region."""
+    print "Adding MultiSkim step."
+    print "multiSkimLeptonPreselector.electronIDs should be modified for each global tag."
+    from EmergingJetAnalysis.MultiSkimFilter.multiSkimFilter_cff import multiSkimFilter, multiSkimLeptonPreselector
+    process.multiSkimFilter = multiSkimFilter.clone()
+    if regions is not None: process.multiSkimFilter.regions = cms.vstring(*regions)
+    if isData: process.multiSkimFilter.regions = cms.vstring(*[r for r in process.multiSkimFilter.regions if r != 'genht'])
+    process.eventCountPreFilter = cms.EDAnalyzer('EventCounter')
+    process.eventCountPostFilter = cms.EDAnalyzer('EventCounter')
+    if 'wjet' in process.multiSkimFilter.regions or 'zjet' in process.multiSkimFilter.regions:
+        process = addMiniAOD(process, isData)
+        process.multiSkimLeptonPreselector = multiSkimLeptonPreselector.clone()
+        return cms.Sequence(process.eventCountPreFilter * process.multiSkimLeptonPreselector * process.multiSkimFilter * process.eventCountPostFilter)
+    return cms.Sequence(process.eventCountPreFilter * process.multiSkimFilter * process.eventCountPostFilter)
 
 def addAnalyze(process, isData=False, sample=''):
     addPFHT(process, isData=False, sample='')
@@ -172,6 +201,20 @@ def addAnalyze(process, isData=False, sample=''):
             finder = cms.string( "avr" )
         ),
         hlTriggerResults = cms.InputTag("TriggerResults", "", "HLT"),
+        # Stored as bits of HLT_bits, in order. Wildcards match any version.
+        hltPaths = cms.vstring(
+            # EXO-16-003 Triggers
+            "HLT_HT250_DisplacedDijet40_DisplacedTrack_v*",
+            "HLT_HT350_DisplacedDijet40_DisplacedTrack_v*",
+            "HLT_HT400_DisplacedDijet40_Inclusive_v*",
+            "HLT_HT500_DisplacedDijet40_Inclusive_v*",
+            # Emerging Jets Analysis Triggers
+            "HLT_PFHT400_v*",
+            "HLT_PFHT475_v*",
+            "HLT_PFHT600_v*",
+            "HLT_PFHT800_v*",
+            "HLT_PFHT900_v*",
+        ),
         jets = cms.untracked.InputTag("ak4CaloJets"),
         associatorVTX = cms.untracked.InputTag("ak4JTAatVX"),
         associatorCALO = cms.untracked.InputTag("ak4JTAatCAL"),
@@ -179,6 +222,48 @@ def addAnalyze(process, isData=False, sample=''):
         scanRandomJet = cms.bool(False),
         debug = cms.untracked.bool(False),
         saveTracks = cms.bool(True),
+        genVertexMatchTrackableOnly = cms.untracked.bool(True),
+        # Reject events on cheap quantities before tracks etc. are read. Rejected events are not stored in emJetTree.
+        # hltMask selects bits of HLT_bits (0: no requirement)
+        earlyExit = cms.untracked.PSet(
+            hltMask = cms.untracked.uint32(0),
+            minNGoodVtx = cms.untracked.int32(0),
+            minNSelectedJets = cms.untracked.uint32(0),
+            minLeadingJetPt = cms.untracked.double(0.0),
+            minHT = cms.untracked.double(0.0),
+        ),
+        # Per-event caps for pathological events (0: disabled). Degraded events are flagged in budgetFlags.
+        budget = cms.untracked.PSet(
+            maxTracksGlobalVertexing = cms.untracked.uint32(0),
+            maxTracksJetVertexing = cms.untracked.uint32(0),
+            maxStageSeconds = cms.untracked.double(0.0),
+            degradedMaxJets = cms.untracked.int32(2),
+        ),
+        # EDM side products to put in the event (only needed for scans/event displays). Unlisted products are not computed.
+        sideProducts = cms.untracked.vstring(
+            "scanJet", "scanJetTracks", "scanJetSelectedTracks",
+            "avrVerticesGlobalOutput", "avrVerticesLocalOutput",
+            "avrVerticesRFTracksGlobalOutput", "avrVerticesRFTracksLocalOutput",
+            "darkPionVertices", "tkvfGlobalOutput",
+        ),
+        # Histograms of ntuple variables (by branch name), filled directly from the in-memory event
+        # If histogramMode is True, only these histograms are written and emJetTree is not created
+        histogramMode = cms.untracked.bool(False),
+        histograms = cms.untracked.VPSet(
+            # cms.PSet(
+            #     name = cms.string("alphaMax_pf"), var = cms.string("jet_alphaMax"),
+            #     nbins = cms.int32(100), low = cms.double(0.0), high = cms.double(1.0),
+            #     cuts = cms.untracked.VPSet( cms.PSet(var = cms.string("jet_pt"), min = cms.double(100.0), max = cms.double(1e9)) ),
+            # ),
+        ),
+        # Sidecar ROOT files of jet-independent track features (inner hit, hit pattern, PV/gen matching), keyed by event and track
+        # Features are read from input (ignored if written by a different release/version/configuration) and written to output ("": disabled)
+        trackFeatureStore = cms.untracked.PSet(
+            input = cms.untracked.string(""),
+            output = cms.untracked.string(""),
+        ),
+        # Write (run, lumi, event) -> tree entry index next to the ntuple (ntuple.evtidx), for emjetEventIndex
+        eventIndex = cms.untracked.bool(False),
     )
     if isData: process.emJetAnalyzer.isData = cms.bool( True )
     if sample=='wjet'     : process.emJetAnalyzer.srcJets = cms.InputTag("wJetFilter")
@@ -187,6 +272,18 @@ def addAnalyze(process, isData=False, sample=''):
     # return cms.Sequence(process.emergingJetAnalyzer+process.emJetAnalyzer)
     return cms.Sequence(process.emJetAnalyzer)
 
+def addReplayExport(process, isData=False, sample='', fileName='replay.bin'):
+    """Write EmJetAnalyzer inputs to a replay snapshot, to be read by emjetReplay outside CMSSW."""
+    process.emJetReplayExporter = cms.EDAnalyzer('EmJetReplayExporter',
+        srcJets = cms.InputTag("jetFilter", "selectedJets"),
+        isData = cms.bool(isData),
+        fileName = cms.untracked.string(fileName),
+        srcSecondaryVertices = cms.untracked.InputTag("inclusiveSecondaryVertices"),
+    )
+    if sample=='wjet'     : process.emJetReplayExporter.srcJets = cms.InputTag("wJetFilter")
+    if sample=='recotest' : process.emJetReplayExporter.srcJets = cms.InputTag("ak4PFJetsCHS")
+    return cms.Sequence(process.emJetReplayExporter)
+
 def addEdmOutput(process, isData=False, sample=''):
     from Configuration.EventContent.EventContent_cff import AODSIMEventContent
     from Configuration.EventContent.EventContent_cff import AODEventContent
@@ -206,8 +303,17 @@ def addEdmOutput(process, isData=False, sample=''):
     )
     if isData : process.out.outputCommands.extend(AODEventContent.outputCommands)
     else      : process.out.outputCommands.extend(AODSIMEventContent.outputCommands)
-    if sample=='wjet' : process.out.outputCommands.extend(cms.untracked.vstring('keep *_wJetFilter_*_*',))
-    else              : process.out.outputCommands.extend(cms.untracked.vstring('keep *_jetFilter_*_*',))
+    if sample=='wjet'    : process.out.outputCommands.extend(cms.untracked.vstring('keep *_wJetFilter_*_*',))
+    elif sample=='multi' : process.out.outputCommands.extend(cms.untracked.vstring('keep *_multiSkimFilter_*_*',))
+    else                 : process.out.outputCommands.extend(cms.untracked.vstring('keep *_jetFilter_*_*',))
+
+def addEventIndex(process, outputFile):
+    """Write (run, lumi, event) of events passing the skim to an index next to the EDM outputFile, for emjetEventIndex.
+    Returns module to be appended to the path selected by the PoolOutputModule."""
+    process.eventIndexWriter = cms.EDAnalyzer('EventIndexWriter',
+        outputFile = cms.untracked.string(outputFile),
+    )
+    return process.eventIndexWriter
 
 def addPFHT(process, isData=False, sample=''):
     """Copied from http://cmslxr.fnal.gov/dxr/CMSSW/source/HLTrigger/Configuration/python/HLT_25ns14e33_v1_cff.py#27446"""
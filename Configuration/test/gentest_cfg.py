@@ -112,9 +112,9 @@ process.options.allowUnscheduled = cms.untracked.bool(True)
 #     if options.sample=='wjet':
 #         skimStep = addWJetSkim(process, options.data)
 #         if 'CMSSW_7_4_12' in cmssw_version:
-#             process.wJetFilter.electronID = cms.string('cutBasedElectronID-Spring15-25ns-V1-standalone-medium')
+#             process.leptonPreselector.electronIDs = cms.vstring('cutBasedElectronID-Spring15-25ns-V1-standalone-medium')
 #         elif 'CMSSW_7_4_1_patch4' in cmssw_version:
-#             process.wJetFilter.electronID = cms.string('cutBasedElectronID-CSA14-50ns-V1-standalone-medium')
+#             process.leptonPreselector.electronIDs = cms.vstring('cutBasedElectronID-CSA14-50ns-V1-standalone-medium')
 #     else:
 #         skimStep = addSkim(process, options.data, doJetFilter=options.doJetFilter, doHLT=options.doHLT)
 
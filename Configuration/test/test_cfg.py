@@ -38,6 +38,31 @@ options.register ('doJetFilter',
                   VarParsing.VarParsing.multiplicity.singleton, # singleton or list
                   VarParsing.VarParsing.varType.int,          # string, int, or float
                   "Set to 1 to turn on JetFilter for skim step.")
+options.register ('replaySnapshot',
+                  '', # default value
+                  VarParsing.VarParsing.multiplicity.singleton, # singleton or list
+                  VarParsing.VarParsing.varType.string,          # string, int, or float
+                  "If set, write EmJetAnalyzer inputs to this replay snapshot file (for emjetReplay).")
+options.register ('wantSummary',
+                  0, # default value
+                  VarParsing.VarParsing.multiplicity.singleton, # singleton or list
+                  VarParsing.VarParsing.varType.int,          # string, int, or float
+                  "Set to 1 to print the framework summary (including per-module TimeReport).")
+options.register ('lumis',
+                  [],
+                  VarParsing.VarParsing.multiplicity.list, # singleton or list
+                  VarParsing.VarParsing.varType.string,          # string, int, or float
+                  "Only process these luminosity block ranges, e.g. 1:10-1:20 (used by crabUtils/localRunner.py).")
+options.register ('eventsToProcess',
+                  [],
+                  VarParsing.VarParsing.multiplicity.list, # singleton or list
+                  VarParsing.VarParsing.varType.string,          # string, int, or float
+                  "Only process these events, run:lumi:event (printed by emjetEventIndex lookup).")
+options.register ('eventIndex',
+                  0, # default value
+                  VarParsing.VarParsing.multiplicity.singleton, # singleton or list
+                  VarParsing.VarParsing.varType.int,          # string, int, or float
+                  "Set to 1 to write event indices (.evtidx) next to the ntuple and skimmed EDM output, for emjetEventIndex.")
 # options.register ('ntupleFile',
 #                   'ntuple.root', # default value
 #                   VarParsing.VarParsing.multiplicity.singleton, # singleton or list
@@ -53,7 +78,7 @@ options.parseArguments()
 print ''
 print 'Printing options:'
 print options
-print 'Only the following options are used: crab, data, sample, steps, doHLT, doJetFilter'
+print 'Only the following options are used: crab, data, sample, steps, doHLT, doJetFilter, replaySnapshot, wantSummary, lumis, eventsToProcess, eventIndex, outputLabel, inputFiles, maxEvents'
 print ''
 
 # Check validity of command line arguments
@@ -89,7 +114,7 @@ process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
 process.load("Configuration.StandardSequences.MagneticField_cff")
 
 ## Options and Output Report
-process.options = cms.untracked.PSet( wantSummary = cms.untracked.bool(False),
+process.options = cms.untracked.PSet( wantSummary = cms.untracked.bool(bool(options.wantSummary)),
         # SkipEvent = cms.untracked.vstring('ProductNotFound')
 )
 
@@ -112,9 +137,9 @@ if 'skim' in options.steps:
     if options.sample=='wjet':
         skimStep = addWJetSkim(process, options.data)
         if 'CMSSW_7_4_12' in cmssw_version:
-            process.wJetFilter.electronID = cms.string('cutBasedElectronID-Spring15-25ns-V1-standalone-medium')
+            process.leptonPreselector.electronIDs = cms.vstring('cutBasedElectronID-Spring15-25ns-V1-standalone-medium')
         elif 'CMSSW_7_4_1_patch4' in cmssw_version:
-            process.wJetFilter.electronID = cms.string('cutBasedElectronID-CSA14-50ns-V1-standalone-medium')
+            process.leptonPreselector.electronIDs = cms.vstring('cutBasedElectronID-CSA14-50ns-V1-standalone-medium')
     else:
         skimStep = addSkim(process, options.data, doJetFilter=options.doJetFilter, doHLT=options.doHLT)
 
@@ -138,7 +163,14 @@ testingStep = cms.Sequence()
 if testing:
     testingStep = addTesting(process, options.data, options.sample)
 
-process.p = cms.Path( skimStep * testingStep * analyzeStep )
+########################################
+# Replay snapshot export
+########################################
+replayStep = cms.Sequence()
+if options.replaySnapshot:
+    replayStep = addReplayExport(process, options.data, options.sample, options.replaySnapshot)
+
+process.p = cms.Path( skimStep * testingStep * replayStep * analyzeStep )
 
 ########################################
 # Configure EDM Output
@@ -325,6 +357,11 @@ process.source = cms.Source("PoolSource",
         # 'file:/home/yhshin/EmJetMCProd/CMSSW_8_0_21/src/EmJetDigiReco/aodsim-DarkPionGun-NoPileUp.root'
     ),
 )
+# Command line inputFiles/maxEvents override the defaults above (e.g. for pinned regression samples)
+if options.inputFiles: process.source.fileNames = cms.untracked.vstring(*options.inputFiles)
+if options.maxEvents != -1: process.maxEvents.input = options.maxEvents
+if options.lumis: process.source.lumisToProcess = cms.untracked.VLuminosityBlockRange(*options.lumis)
+if options.eventsToProcess: process.source.eventsToProcess = cms.untracked.VEventRange(*options.eventsToProcess)
 
 producePdfWeights = 0
 if producePdfWeights:
@@ -357,11 +394,20 @@ if testVertexReco:
     process.out.outputCommands.extend(cms.untracked.vstring('keep *_emJetAnalyzer_*_*',))
     # Keep genParticles
     process.out.outputCommands.extend(cms.untracked.vstring('keep *_genParticles_*_*',))
+elif hasattr(process, 'emJetAnalyzer'):
+    # emJetAnalyzer side products are not kept, skip filling them
+    process.emJetAnalyzer.sideProducts = cms.untracked.vstring()
 
 if options.outputLabel:
     process.out.fileName = cms.untracked.string('output-%s.root' % options.outputLabel)
     process.TFileService.fileName = cms.string('ntuple-%s.root' % options.outputLabel)
 
+if options.eventIndex:
+    if hasattr(process, 'emJetAnalyzer'): process.emJetAnalyzer.eventIndex = cms.untracked.bool(True)
+    # Skimmed EDM output is only written when running the skim step alone
+    if 'skim' in options.steps and len(options.steps)==1:
+        process.p += addEventIndex(process, process.out.fileName.value())
+
 # storage
 process.outpath = cms.EndPath(process.out)
 
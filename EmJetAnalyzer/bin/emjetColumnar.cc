@@ -0,0 +1,159 @@
+// Multithreaded emerging jet tagging histograms from EmJetAnalyzer ntuples
+// Reads only the columns used by the selection (EmJetColumns.h) on all cores (ColumnEngine.h), and applies the
+// column kernels of EmJetCore.h per event. Replaces event loops over all branches in ROOT macros.
+//
+// Usage: emjetColumnar [-j nThreads] [-t tree] [-o output.root] [-a maxAlphaMax] [-s minMedianIPSig] ntuple.root...
+//   -j : number of threads, default all cores
+//   -t : tree name, default emJetAnalyzer/emJetTree
+//   -o : output file for histograms, default emjetColumnar.root
+//   -a : emerging jet alphaMax cut, default 0.04
+//   -s : emerging jet median track ipXYSig cut, default 10
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TFile.h"
+#include "TH1F.h"
+
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/ColumnEngine.h"
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/EmJetCore.h"
+
+using namespace emjet;
+
+namespace
+{
+  const int trackSource = 0; // generalTracks with simple deltaR :TRACKSOURCE:
+  const double minJetPt = 100.;
+  const double maxJetEta = 2.0;
+
+  // Histograms of one thread
+  struct Histograms {
+    std::vector< std::unique_ptr<TH1F> > all;
+    TH1F* ht;
+    TH1F* nJets;
+    TH1F* nEmerging;
+    TH1F* jet_pt;
+    TH1F* jet_alphaMax;
+    TH1F* jet_medianIPSig;
+    TH1F* jet_nTracks;
+    TH1F* emerging_pt;
+    TH1F* emerging_eta;
+
+    explicit Histograms(unsigned slot) {
+      ht              = book("ht"              , 100, 0., 5000., slot);
+      nJets           = book("nJets"           , 20 , 0., 20.  , slot);
+      nEmerging       = book("nEmerging"       , 10 , 0., 10.  , slot);
+      jet_pt          = book("jet_pt"          , 100, 0., 2000., slot);
+      jet_alphaMax    = book("jet_alphaMax"    , 100, 0., 1.   , slot);
+      jet_medianIPSig = book("jet_medianIPSig" , 100, 0., 100. , slot);
+      jet_nTracks     = book("jet_nTracks"     , 50 , 0., 50.  , slot);
+      emerging_pt     = book("emerging_pt"     , 100, 0., 2000., slot);
+      emerging_eta    = book("emerging_eta"    , 50 , -2.5, 2.5, slot);
+    }
+    TH1F* book(const char* name, int nbins, double min, double max, unsigned slot) {
+      all.emplace_back(new TH1F((std::string(name) + "_" + std::to_string(slot)).c_str(), name, nbins, min, max));
+      return all.back().get();
+    }
+    void Add(const Histograms& other) {
+      for (unsigned i = 0; i < all.size(); i++) all[i]->Add(other.all[i].get());
+    }
+    void Write(TFile& file) {
+      file.cd();
+      for (auto& h : all) h->Write(h->GetTitle());
+    }
+  };
+
+  // Per-event work buffers of one thread
+  struct Buffers {
+    std::vector<char> kinematic, emerging;
+    std::vector<int> nTracks;
+    std::vector<float> medianIPSig;
+  };
+}
+
+int main(int argc, char* argv[])
+{
+  unsigned nThreads = 0;
+  std::string treeName = "emJetAnalyzer/emJetTree";
+  std::string outputName = "emjetColumnar.root";
+  double maxAlphaMax = 0.04, minMedianIPSig = 10.;
+  std::vector<std::string> files;
+  bool usage = false;
+  for (int i = 1; i < argc; i++) {
+    if      ( !std::strcmp(argv[i], "-j") && i+1 < argc ) nThreads = std::atoi(argv[++i]);
+    else if ( !std::strcmp(argv[i], "-t") && i+1 < argc ) treeName = argv[++i];
+    else if ( !std::strcmp(argv[i], "-o") && i+1 < argc ) outputName = argv[++i];
+    else if ( !std::strcmp(argv[i], "-a") && i+1 < argc ) maxAlphaMax = std::atof(argv[++i]);
+    else if ( !std::strcmp(argv[i], "-s") && i+1 < argc ) minMedianIPSig = std::atof(argv[++i]);
+    else if ( argv[i][0] != '-' ) files.push_back(argv[i]);
+    else usage = true;
+  }
+  if (usage || files.empty()) {
+    std::cerr << "Usage: " << argv[0] << " [-j nThreads] [-t tree] [-o output.root] [-a maxAlphaMax] [-s minMedianIPSig] ntuple.root...\n";
+    return 1;
+  }
+
+  TH1::AddDirectory(kFALSE); // Histograms are owned by Histograms, not by the current file
+  ColumnEngine engine(files, treeName, nThreads);
+  std::vector< std::unique_ptr<Histograms> > histograms;
+  std::vector<Buffers> buffers(engine.nThreads());
+  for (unsigned slot = 0; slot < engine.nThreads(); slot++) histograms.emplace_back(new Histograms(slot));
+
+  std::vector<std::string> columns = { "jet_pt", "jet_eta", "jet_alphaMax", "track_source", "track_pt", "track_quality", "track_ipXYSig" };
+  auto start = std::chrono::steady_clock::now();
+  engine.Run(columns, [&](const ColumnReader& r, unsigned slot) {
+      Histograms& h = *histograms[slot];
+      Buffers& b = buffers[slot];
+      // Kinematic jet selection :CUT:
+      b.kinematic.clear();
+      selectJets(*r.jet_pt, [](float pt) { return pt > minJetPt; }, b.kinematic);
+      selectJets(*r.jet_eta, [](float eta) { return std::fabs(eta) < maxJetEta; }, b.kinematic);
+      // Emerging jet tagging :CUT:
+      countTracks(*r.track_source, trackSource, *r.track_pt, *r.track_quality, b.nTracks);
+      medianTrackColumn(*r.track_ipXYSig, *r.track_source, trackSource, *r.track_pt, *r.track_quality, b.medianIPSig);
+      b.emerging = b.kinematic;
+      selectAlphaMax(*r.jet_alphaMax, maxAlphaMax, b.emerging);
+      selectJets(b.nTracks, [](int n) { return n > 0; }, b.emerging);
+      selectJets(b.medianIPSig, [minMedianIPSig](float s) { return s > minMedianIPSig; }, b.emerging);
+
+      double ht = 0.;
+      int nJets = 0, nEmerging = 0;
+      for (unsigned ijet = 0; ijet < r.jet_pt->size(); ijet++) {
+        if (!b.kinematic[ijet]) continue;
+        float pt = (*r.jet_pt)[ijet];
+        ht += pt;
+        nJets++;
+        h.jet_pt->Fill(pt);
+        h.jet_alphaMax->Fill((*r.jet_alphaMax)[ijet]);
+        h.jet_medianIPSig->Fill(b.medianIPSig[ijet]);
+        h.jet_nTracks->Fill(b.nTracks[ijet]);
+        if (!b.emerging[ijet]) continue;
+        nEmerging++;
+        h.emerging_pt->Fill(pt);
+        h.emerging_eta->Fill((*r.jet_eta)[ijet]);
+      }
+      h.ht->Fill(ht);
+      h.nJets->Fill(nJets);
+      h.nEmerging->Fill(nEmerging);
+    });
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  for (unsigned slot = 1; slot < histograms.size(); slot++) histograms[0]->Add(*histograms[slot]);
+  TFile output(outputName.c_str(), "RECREATE");
+  if (output.IsZombie()) {
+    std::cerr << "emjetColumnar: can not open " << outputName << "\n";
+    return 1;
+  }
+  histograms[0]->Write(output);
+  output.Close();
+
+  std::cerr << "emjetColumnar: " << engine.entries() << " events, " << engine.nThreads() << " threads, "
+            << seconds << " s, " << (seconds > 0 ? engine.entries()/seconds : 0.) << " events/s\n";
+  return 0;
+}
@@ -0,0 +1,315 @@
+// Build, merge and query event indices (Utils/interface/EventIndex.h) of ntuples and EDM files
+// Jumps straight to listed events instead of streaming through whole files, e.g. to revisit events with the
+// jetscan/vertexscan configs or to extract them from ntuples.
+// Indices are written by EmJetAnalyzer and EventIndexWriter (test_cfg.py eventIndex=1), or built from existing files.
+//
+// Usage:
+//   emjetEventIndex build [-t tree] -o index.evtidx file.root...
+//     Index ntuples (tree entries of run, lumi, event) or EDM files (Events entries of EventAuxiliary)
+//   emjetEventIndex merge -o index.evtidx index.evtidx...
+//   emjetEventIndex lookup -i index.evtidx [-f events.txt] [run:lumi:event | run:event]...
+//     Print file and entry of each event, and the cmsRun options to process the events found in EDM files
+//   emjetEventIndex pick -i index.evtidx [-t tree] -o picked.root [-f events.txt] [run:lumi:event | run:event]...
+//     Copy the entries of the events found in ntuples to a new ntuple
+//   -i can be repeated. Events are given as arguments or in a file (-f), one per line, '#' starts a comment.
+//   -t : ntuple tree name, default emJetAnalyzer/emJetTree
+// File names in an index are relative to the directory of the index.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "TChain.h"
+#include "TFile.h"
+#include "TTree.h"
+
+#include "DataFormats/Provenance/interface/EventAuxiliary.h"
+#include "FWCore/FWLite/interface/FWLiteEnabler.h"
+
+#include "EmergingJetAnalysis/Utils/interface/EventIndex.h"
+
+using namespace emjet;
+
+namespace
+{
+  struct EventId {
+    uint32_t run, lumi; // lumi = 0 matches any lumi
+    uint64_t event;
+  };
+
+  std::string directoryOf(const std::string& path)
+  {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? "" : path.substr(0, slash);
+  }
+
+  bool isAbsolute(const std::string& name)
+  {
+    return name.empty() || name[0] == '/' || name.find(':') != std::string::npos; // Paths, file: and root:// urls
+  }
+
+  // File name as seen from the current directory
+  std::string resolve(const std::string& indexName, const std::string& name)
+  {
+    std::string dir = directoryOf(indexName);
+    return (dir.empty() || isAbsolute(name)) ? name : dir + "/" + name;
+  }
+
+  // File name as stored in an index written to indexName
+  std::string storedName(const std::string& indexName, const std::string& name)
+  {
+    if (directoryOf(indexName).empty() || isAbsolute(name)) return name;
+    char cwd[4096];
+    if (!getcwd(cwd, sizeof(cwd))) throw std::runtime_error("emjetEventIndex: getcwd failed");
+    return std::string(cwd) + "/" + name;
+  }
+
+  void load(const std::string& indexName, EventIndex& combined)
+  {
+    EventIndex index(indexName);
+    for (const auto& e : index.entries())
+      combined.Add(e.run, e.lumi, e.event, resolve(indexName, index.fileName(e.file)), e.entry);
+  }
+
+  bool parseEvent(std::string text, EventId& id)
+  {
+    for (auto& c : text) if (c == ':') c = ' ';
+    std::istringstream is(text);
+    std::vector<unsigned long long> numbers;
+    unsigned long long n;
+    while (is >> n) numbers.push_back(n);
+    if (!is.eof() || numbers.size() < 2 || numbers.size() > 3) return false;
+    id.run = numbers.front();
+    id.lumi = numbers.size() == 3 ? numbers[1] : 0;
+    id.event = numbers.back();
+    return true;
+  }
+
+  bool readEvents(const std::string& filename, std::vector<EventId>& events)
+  {
+    std::ifstream is(filename.c_str());
+    if (!is) return false;
+    std::string line;
+    while (std::getline(is, line)) {
+      line = line.substr(0, line.find('#'));
+      if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+      EventId id;
+      if (!parseEvent(line, id)) throw std::runtime_error("emjetEventIndex: invalid event " + line + " in " + filename);
+      events.push_back(id);
+    }
+    return true;
+  }
+
+  std::string toString(const EventIndex::Entry& e)
+  {
+    return std::to_string(e.run) + ":" + std::to_string(e.lumi) + ":" + std::to_string(e.event);
+  }
+
+  // Directory of tree inside file, as created by TFileService
+  TDirectory* makeDirectory(TFile& file, const std::string& treeName)
+  {
+    size_t slash = treeName.rfind('/');
+    if (slash == std::string::npos) return &file;
+    std::string path = treeName.substr(0, slash);
+    TDirectory* dir = file.GetDirectory(path.c_str());
+    return dir ? dir : file.mkdir(path.c_str());
+  }
+
+  void buildFile(const std::string& filename, const std::string& treeName, const std::string& stored, EventIndex& index)
+  {
+    std::unique_ptr<TFile> file(TFile::Open(filename.c_str()));
+    if (!file || file->IsZombie()) throw std::runtime_error("emjetEventIndex: can not open " + filename);
+    TTree* tree = 0;
+    if ( (tree = dynamic_cast<TTree*>(file->Get(treeName.c_str()))) ) {
+      // Ntuple, event is stored as int
+      int run = 0, lumi = 0, event = 0;
+      tree->SetBranchStatus("*", 0);
+      for (const char* name : { "run", "lumi", "event" }) tree->SetBranchStatus(name, 1);
+      tree->SetBranchAddress("run", &run);
+      tree->SetBranchAddress("lumi", &lumi);
+      tree->SetBranchAddress("event", &event);
+      for (Long64_t i = 0; i < tree->GetEntries(); i++) {
+        tree->GetEntry(i);
+        index.Add(run, lumi, static_cast<uint32_t>(event), stored, i);
+      }
+    }
+    else if ( (tree = dynamic_cast<TTree*>(file->Get("Events"))) ) {
+      // EDM file
+      edm::EventAuxiliary aux;
+      edm::EventAuxiliary* paux = &aux;
+      tree->SetBranchStatus("*", 0);
+      tree->SetBranchStatus("EventAuxiliary", 1);
+      tree->SetBranchAddress("EventAuxiliary", &paux);
+      for (Long64_t i = 0; i < tree->GetEntries(); i++) {
+        tree->GetEntry(i);
+        index.Add(aux.run(), aux.luminosityBlock(), aux.event(), stored, i);
+      }
+      tree->ResetBranchAddresses();
+    }
+    else {
+      throw std::runtime_error("emjetEventIndex: " + filename + " has neither " + treeName + " nor Events");
+    }
+  }
+
+  // EDM files have an Events tree, anything else is taken to be an ntuple
+  class FileTypes {
+  public:
+    explicit FileTypes(const EventIndex& index) : index_(index) {}
+    bool isEdm(uint32_t file) {
+      auto it = isEdm_.find(file);
+      if (it != isEdm_.end()) return it->second;
+      std::unique_ptr<TFile> f(TFile::Open(index_.fileName(file).c_str()));
+      return isEdm_[file] = f && !f->IsZombie() && dynamic_cast<TTree*>(f->Get("Events"));
+    }
+  private:
+    const EventIndex& index_;
+    std::map<uint32_t, bool> isEdm_;
+  };
+
+  int pick(const std::vector<EventIndex::Entry>& found, const EventIndex& index, FileTypes& types,
+           const std::string& treeName, const std::string& outputName)
+  {
+    // Entries of each ntuple in file order, EDM events are left to cmsRun
+    std::map< uint32_t, std::set<uint64_t> > entries;
+    for (const auto& e : found) {
+      if (e.entry != EventIndex::kNoEntry && !types.isEdm(e.file)) entries[e.file].insert(e.entry);
+    }
+    if (entries.empty()) {
+      std::cerr << "emjetEventIndex: no events found in ntuples\n";
+      return 1;
+    }
+    TChain chain(treeName.c_str());
+    for (const auto& file : entries) chain.Add(index.fileName(file.first).c_str());
+    chain.GetEntries(); // Fills tree offsets
+    TFile output(outputName.c_str(), "RECREATE");
+    if (output.IsZombie()) {
+      std::cerr << "emjetEventIndex: can not open " << outputName << "\n";
+      return 1;
+    }
+    TDirectory* dir = makeDirectory(output, treeName);
+    dir->cd();
+    TTree* picked = chain.CloneTree(0);
+    int itree = 0;
+    for (const auto& file : entries) {
+      for (uint64_t entry : file.second) {
+        chain.GetEntry(chain.GetTreeOffset()[itree] + entry);
+        picked->Fill();
+      }
+      itree++;
+    }
+    dir->cd();
+    picked->Write();
+    std::cerr << "emjetEventIndex: wrote " << picked->GetEntries() << " events to " << outputName << "\n";
+    output.Close();
+    return 0;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  std::string command = argc > 1 ? argv[1] : "";
+  std::string treeName = "emJetAnalyzer/emJetTree";
+  std::string outputName;
+  std::vector<std::string> indices, files;
+  std::vector<EventId> events;
+  bool usage = !(command == "build" || command == "merge" || command == "lookup" || command == "pick");
+  try {
+    for (int i = 2; i < argc && !usage; i++) {
+      if      ( !std::strcmp(argv[i], "-t") && i+1 < argc ) treeName = argv[++i];
+      else if ( !std::strcmp(argv[i], "-o") && i+1 < argc ) outputName = argv[++i];
+      else if ( !std::strcmp(argv[i], "-i") && i+1 < argc ) indices.push_back(argv[++i]);
+      else if ( !std::strcmp(argv[i], "-f") && i+1 < argc ) {
+        if (!readEvents(argv[++i], events)) throw std::runtime_error(std::string("emjetEventIndex: can not open ") + argv[i]);
+      }
+      else if ( argv[i][0] != '-' ) files.push_back(argv[i]);
+      else usage = true;
+    }
+    if (command == "lookup" || command == "pick") {
+      for (const auto& text : files) {
+        EventId id;
+        if (!parseEvent(text, id)) throw std::runtime_error("emjetEventIndex: invalid event " + text);
+        events.push_back(id);
+      }
+      usage = usage || indices.empty() || events.empty() || (command == "pick" && outputName.empty());
+    }
+    else {
+      usage = usage || files.empty() || outputName.empty();
+    }
+    if (usage) {
+      std::cerr << "Usage: " << argv[0] << " build [-t tree] -o index.evtidx file.root...\n"
+                << "       " << argv[0] << " merge -o index.evtidx index.evtidx...\n"
+                << "       " << argv[0] << " lookup -i index.evtidx [-f events.txt] [run:lumi:event | run:event]...\n"
+                << "       " << argv[0] << " pick -i index.evtidx [-t tree] -o picked.root [-f events.txt] [run:lumi:event | run:event]...\n";
+      return 1;
+    }
+
+    EventIndex index;
+    if (command == "build") {
+      FWLiteEnabler::enable(); // EventAuxiliary dictionary
+      for (const auto& file : files) buildFile(file, treeName, storedName(outputName, file), index);
+      index.Write(outputName);
+      std::cerr << "emjetEventIndex: wrote " << index.size() << " events of " << files.size() << " files to " << outputName << "\n";
+      return 0;
+    }
+    if (command == "merge") {
+      for (const auto& file : files) {
+        EventIndex input(file);
+        for (const auto& e : input.entries())
+          index.Add(e.run, e.lumi, e.event, storedName(outputName, resolve(file, input.fileName(e.file))), e.entry);
+      }
+      index.Write(outputName);
+      std::cerr << "emjetEventIndex: wrote " << index.size() << " events of " << index.fileNames().size() << " files to " << outputName << "\n";
+      return 0;
+    }
+
+    // lookup and pick
+    for (const auto& file : indices) load(file, index);
+    index.Sort();
+    std::vector<EventIndex::Entry> found;
+    int nMissing = 0;
+    for (const auto& id : events) {
+      std::vector<EventIndex::Entry> matches = index.Find(id.run, id.event, id.lumi);
+      if (matches.empty()) {
+        std::cerr << "emjetEventIndex: " << id.run << ":" << (id.lumi ? std::to_string(id.lumi) + ":" : "") << id.event << " not found\n";
+        nMissing++;
+      }
+      found.insert(found.end(), matches.begin(), matches.end());
+    }
+    FileTypes types(index);
+    if (command == "pick") return pick(found, index, types, treeName, outputName) || nMissing;
+
+    std::map< uint32_t, std::vector<std::string> > edmEvents;
+    for (const auto& e : found) {
+      std::cout << toString(e) << " " << index.fileName(e.file) << " ";
+      if (e.entry == EventIndex::kNoEntry) std::cout << "-\n";
+      else std::cout << e.entry << "\n";
+    }
+    for (const auto& e : found) {
+      if (types.isEdm(e.file)) edmEvents[e.file].push_back(toString(e));
+    }
+    if (!edmEvents.empty()) {
+      std::string inputFiles, eventsToProcess;
+      for (const auto& file : edmEvents) {
+        const std::string& name = index.fileName(file.first);
+        inputFiles += (inputFiles.empty() ? "" : ",") + (isAbsolute(name) && name[0] != '/' ? name : "file:" + name);
+        for (const auto& event : file.second) eventsToProcess += (eventsToProcess.empty() ? "" : ",") + event;
+      }
+      std::cout << "# cmsRun options for EDM files, e.g. with Configuration/test/test_cfg.py:\n"
+                << "# inputFiles=" << inputFiles << " eventsToProcess=" << eventsToProcess << "\n";
+    }
+    return nMissing ? 1 : 0;
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,116 @@
+// Benchmark of Utils/interface/Kinematics.h against TLorentzVector
+// Matches random positions (e.g. muon segments, vertices) to random jets within deltaR < 0.5, as in the per-jet loops
+// of EmJetAnalyzer and EmergingJetAnalyzer, and prints the time per comparison and the largest deltaR difference.
+//
+// Usage: emjetKinematicsBenchmark [-n nPoints] [-j nJets] [-r repetitions]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "TLorentzVector.h"
+
+#include "EmergingJetAnalysis/Utils/interface/Kinematics.h"
+
+using namespace emjet;
+
+namespace
+{
+  struct Point { double x, y, z; };
+
+  template <class F>
+  double nsPerComparison(F f, int repetitions, size_t nComparisons, long& result)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++) result += f();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return 1e9 * seconds / (double(repetitions) * nComparisons);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  size_t nPoints = 1000, nJets = 10;
+  int repetitions = 200;
+  for (int i = 1; i < argc; i++) {
+    if      ( !std::strcmp(argv[i], "-n") && i+1 < argc ) nPoints = std::atoi(argv[++i]);
+    else if ( !std::strcmp(argv[i], "-j") && i+1 < argc ) nJets = std::atoi(argv[++i]);
+    else if ( !std::strcmp(argv[i], "-r") && i+1 < argc ) repetitions = std::atoi(argv[++i]);
+    else {
+      std::cerr << "Usage: " << argv[0] << " [-n nPoints] [-j nJets] [-r repetitions]\n";
+      return 1;
+    }
+  }
+
+  std::mt19937 rng(12345);
+  std::uniform_real_distribution<double> uniform(-1., 1.);
+  std::vector<Point> points(nPoints);
+  for (auto& p : points) p = Point{ 500.*uniform(rng), 500.*uniform(rng), 1000.*uniform(rng) };
+  std::vector<kin::EtaPhi> jets(nJets);
+  for (auto& j : jets) j = kin::EtaPhi::fromPtEtaPhi(100., 2.5*uniform(rng), M_PI*uniform(rng));
+  const double maxDeltaR = 0.5;
+  const size_t nComparisons = nPoints * nJets;
+  long nTLV = 0, nScalar = 0, nBatch = 0;
+
+  // Previous code: TLorentzVector per point and jet
+  double tTLV = nsPerComparison([&]() {
+      long n = 0;
+      for (const auto& j : jets) {
+        TLorentzVector jetVector;
+        jetVector.SetPtEtaPhiM(j.pt, j.eta, j.phi, 0.);
+        for (const auto& p : points) {
+          TLorentzVector pointVector;
+          pointVector.SetXYZT(p.x, p.y, p.z, 0.);
+          n += pointVector.DeltaR(jetVector) < maxDeltaR;
+        }
+      }
+      return n;
+    }, repetitions, nComparisons, nTLV);
+
+  // Directions computed once per event, scalar deltaR per jet
+  double tScalar = nsPerComparison([&]() {
+      std::vector<kin::EtaPhi> directions;
+      directions.reserve(points.size());
+      for (const auto& p : points) directions.push_back(kin::EtaPhi::fromXYZ(p.x, p.y, p.z));
+      long n = 0;
+      for (const auto& j : jets) {
+        for (const auto& d : directions) n += kin::deltaR2(d, j) < maxDeltaR*maxDeltaR;
+      }
+      return n;
+    }, repetitions, nComparisons, nScalar);
+
+  // Directions computed once per event, batch count per jet
+  double tBatch = nsPerComparison([&]() {
+      kin::EtaPhiArray directions;
+      directions.reserve(points.size());
+      for (const auto& p : points) directions.push_back(kin::EtaPhi::fromXYZ(p.x, p.y, p.z));
+      long n = 0;
+      for (const auto& j : jets) n += directions.countWithin(j.eta, j.phi, maxDeltaR);
+      return n;
+    }, repetitions, nComparisons, nBatch);
+
+  // Agreement with TLorentzVector
+  double maxDiff = 0.;
+  for (const auto& j : jets) {
+    TLorentzVector jetVector;
+    jetVector.SetPtEtaPhiM(j.pt, j.eta, j.phi, 0.);
+    for (const auto& p : points) {
+      TLorentzVector pointVector;
+      pointVector.SetXYZT(p.x, p.y, p.z, 0.);
+      maxDiff = std::max(maxDiff, std::fabs(pointVector.DeltaR(jetVector) - kin::deltaR(kin::EtaPhi::fromXYZ(p.x, p.y, p.z), j)));
+    }
+  }
+
+  std::printf("%zu points x %zu jets, %d repetitions\n", nPoints, nJets, repetitions);
+  std::printf("%-16s %10s %10s %12s\n", "method", "ns/dR", "speedup", "matched");
+  std::printf("%-16s %10.2f %10.2f %12ld\n", "TLorentzVector", tTLV, 1., nTLV);
+  std::printf("%-16s %10.2f %10.2f %12ld\n", "kin scalar", tScalar, tTLV/tScalar, nScalar);
+  std::printf("%-16s %10.2f %10.2f %12ld\n", "kin batch", tBatch, tTLV/tBatch, nBatch);
+  std::printf("max |deltaR difference| to TLorentzVector: %g\n", maxDiff);
+  return 0;
+}
@@ -0,0 +1,214 @@
+// Aggregate the per luminosity block event counts of EventCounter over many files, for normalization
+// Only reads the small lumiSummary trees (Utils/interface/LumiSummary.h) of each selection stage, never the event
+// trees, with several files opened in parallel.
+// Counts of the same (stage, run, lumi) in several files are added, e.g. for luminosity blocks split across jobs.
+//
+// Usage: emjetLumiSummary [-j nThreads] [-n stage] [-x xsec] [-L lumi] [-o merged.root] [-l lumis.json] [-f files.txt] file.root...
+//   -j : number of threads, default all cores
+//   -n : stage used for normalization, default the stage with the most events (usually eventCountPreTrigger)
+//   -x : cross section in pb, prints the weight per event xsec * lumi / sumWeights of the normalization stage
+//   -L : integrated luminosity in /pb for -x, default 1
+//   -o : write the aggregated lumiSummary trees to this file, which can itself be aggregated again
+//   -l : write the luminosity blocks of the normalization stage as JSON lumi mask, e.g. for brilcalc
+//   -f : read input files from this file, one per line, '#' starts a comment
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "TFile.h"
+#include "TKey.h"
+#include "TROOT.h"
+
+#include "EmergingJetAnalysis/Utils/interface/LumiSummary.h"
+
+using namespace emjet;
+
+namespace
+{
+  typedef std::tuple<std::string, UInt_t, UInt_t> LumiKey; // (stage, run, lumi)
+  typedef std::map<LumiKey, LumiCounts> LumiMap;
+
+  // Add lumiSummary trees of all directories in file to lumis, return false if file can not be read
+  bool readFile(const std::string& filename, LumiMap& lumis)
+  {
+    std::unique_ptr<TFile> file(TFile::Open(filename.c_str()));
+    if (!file || file->IsZombie()) return false;
+    TIter next(file->GetListOfKeys());
+    while (TKey* key = static_cast<TKey*>(next())) {
+      if (!key->IsFolder()) continue;
+      TDirectory* dir = dynamic_cast<TDirectory*>(key->ReadObj());
+      TTree* tree = dir ? dynamic_cast<TTree*>(dir->Get(LumiSummaryRow::treeName())) : 0;
+      if (!tree) continue;
+      std::string stage = dir->GetName(); // EventCounter module label
+      LumiSummaryRow row;
+      row.SetAddresses(tree);
+      for (Long64_t i = 0; i < tree->GetEntries(); i++) {
+        tree->GetEntry(i);
+        lumis[LumiKey(stage, row.run, row.lumi)].add(row.counts);
+      }
+    }
+    return true;
+  }
+
+  void writeTrees(const LumiMap& lumis, const std::string& outputName)
+  {
+    TFile output(outputName.c_str(), "RECREATE");
+    if (output.IsZombie()) throw std::runtime_error("emjetLumiSummary: can not open " + outputName);
+    std::string stage;
+    TTree* tree = 0;
+    LumiSummaryRow row;
+    for (const auto& lumi : lumis) {
+      if (std::get<0>(lumi.first) != stage) {
+        if (tree) tree->Write();
+        stage = std::get<0>(lumi.first);
+        output.mkdir(stage.c_str())->cd();
+        tree = new TTree(LumiSummaryRow::treeName(), LumiSummaryRow::treeName());
+        row.Branch(tree);
+      }
+      row.run = std::get<1>(lumi.first);
+      row.lumi = std::get<2>(lumi.first);
+      row.counts = lumi.second;
+      tree->Fill();
+    }
+    if (tree) tree->Write();
+    output.Close();
+  }
+
+  // JSON lumi mask, {"run": [[first, last], ...], ...}
+  void writeLumiMask(const LumiMap& lumis, const std::string& stage, const std::string& outputName)
+  {
+    std::ofstream os(outputName.c_str());
+    if (!os) throw std::runtime_error("emjetLumiSummary: can not open " + outputName);
+    os << "{";
+    UInt_t run = 0, first = 0, last = 0;
+    bool open = false;
+    auto closeRange = [&]() { os << "[" << first << ", " << last << "]"; };
+    for (const auto& lumi : lumis) {
+      if (std::get<0>(lumi.first) != stage) continue;
+      UInt_t r = std::get<1>(lumi.first), l = std::get<2>(lumi.first);
+      if (open && r == run && l == last + 1) { last = l; continue; }
+      if (open) closeRange();
+      if (!open || r != run) os << (open ? "], " : "") << "\"" << r << "\": [";
+      else os << ", ";
+      run = r; first = last = l; open = true;
+    }
+    if (open) { closeRange(); os << "]"; }
+    os << "}\n";
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  unsigned nThreads = 0;
+  std::string normStage, outputName, maskName;
+  double xsec = -1., lumi = 1.;
+  std::vector<std::string> files;
+  bool usage = false;
+  for (int i = 1; i < argc; i++) {
+    if      ( !std::strcmp(argv[i], "-j") && i+1 < argc ) nThreads = std::atoi(argv[++i]);
+    else if ( !std::strcmp(argv[i], "-n") && i+1 < argc ) normStage = argv[++i];
+    else if ( !std::strcmp(argv[i], "-x") && i+1 < argc ) xsec = std::atof(argv[++i]);
+    else if ( !std::strcmp(argv[i], "-L") && i+1 < argc ) lumi = std::atof(argv[++i]);
+    else if ( !std::strcmp(argv[i], "-o") && i+1 < argc ) outputName = argv[++i];
+    else if ( !std::strcmp(argv[i], "-l") && i+1 < argc ) maskName = argv[++i];
+    else if ( !std::strcmp(argv[i], "-f") && i+1 < argc ) {
+      std::ifstream is(argv[++i]);
+      if (!is) { std::cerr << "emjetLumiSummary: can not open " << argv[i] << "\n"; return 1; }
+      std::string line;
+      while (is >> line) {
+        if (line[0] == '#') { std::getline(is, line); continue; }
+        files.push_back(line);
+      }
+    }
+    else if ( argv[i][0] != '-' ) files.push_back(argv[i]);
+    else usage = true;
+  }
+  if (usage || files.empty()) {
+    std::cerr << "Usage: " << argv[0] << " [-j nThreads] [-n stage] [-x xsec] [-L lumi] [-o merged.root] [-l lumis.json] [-f files.txt] file.root...\n";
+    return 1;
+  }
+
+  // Files are taken from a shared counter, each thread aggregates into its own map
+  ROOT::EnableThreadSafety();
+  if (nThreads == 0) nThreads = std::max(1u, std::thread::hardware_concurrency());
+  nThreads = std::min<size_t>(nThreads, files.size());
+  std::vector<LumiMap> threadLumis(nThreads);
+  std::atomic<size_t> nextFile(0);
+  std::mutex failedMutex;
+  std::vector<std::string> failed;
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (unsigned slot = 0; slot < nThreads; slot++) {
+    threads.emplace_back([&, slot]() {
+        for (size_t i = nextFile++; i < files.size(); i = nextFile++) {
+          if (readFile(files[i], threadLumis[slot])) continue;
+          std::lock_guard<std::mutex> lock(failedMutex);
+          failed.push_back(files[i]);
+        }
+      });
+  }
+  for (auto& thread : threads) thread.join();
+  LumiMap& lumis = threadLumis[0];
+  for (unsigned slot = 1; slot < nThreads; slot++) {
+    for (const auto& l : threadLumis[slot]) lumis[l.first].add(l.second);
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // Totals per stage
+  std::map<std::string, LumiCounts> totals;
+  std::map<std::string, int> nLumis;
+  for (const auto& l : lumis) {
+    totals[std::get<0>(l.first)].add(l.second);
+    nLumis[std::get<0>(l.first)]++;
+  }
+  if (totals.empty()) {
+    std::cerr << "emjetLumiSummary: no lumiSummary trees found\n";
+    return 1;
+  }
+  if (normStage.empty()) {
+    for (const auto& t : totals) {
+      if (normStage.empty() || t.second.events > totals[normStage].events) normStage = t.first;
+    }
+  }
+  if (!totals.count(normStage)) {
+    std::cerr << "emjetLumiSummary: no stage " << normStage << "\n";
+    return 1;
+  }
+
+  std::printf("%-28s %8s %14s %16s %16s %10s\n", "stage", "lumis", "events", "sumWeights", "errSumWeights", "fraction");
+  const LumiCounts& norm = totals[normStage];
+  for (const auto& t : totals) {
+    std::printf("%-28s %8d %14llu %16.6g %16.6g %10.4g\n", t.first.c_str(), nLumis[t.first], (unsigned long long)t.second.events,
+                t.second.sumWeights, std::sqrt(t.second.sumWeights2), norm.sumWeights != 0. ? t.second.sumWeights/norm.sumWeights : 0.);
+  }
+  if (xsec >= 0.) {
+    std::printf("normalization (%s): xsec %g pb * lumi %g /pb / sumWeights %g = %.6g per unit weight\n",
+                normStage.c_str(), xsec, lumi, norm.sumWeights, norm.sumWeights != 0. ? xsec*lumi/norm.sumWeights : 0.);
+  }
+
+  try {
+    if (!outputName.empty()) writeTrees(lumis, outputName);
+    if (!maskName.empty()) writeLumiMask(lumis, normStage, maskName);
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  std::cerr << "emjetLumiSummary: " << files.size() - failed.size() << " files, " << nThreads << " threads, " << seconds << " s\n";
+  for (const auto& file : failed) std::cerr << "emjetLumiSummary: can not read " << file << "\n";
+  return failed.empty() ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+// Replay driver for EmJetAnalyzer snapshots
+// Runs the track selection, alpha and vertex distance code of EmJetAnalyzer (EmJetCore.h, VertexIndex.h) on
+// events written by EmJetReplayExporter, without CMSSW. Only depends on the standard library, so besides scram it
+// can be built on any machine with
+//   g++ -std=c++11 -O2 -I<directory containing EmergingJetAnalysis> emjetReplay.cc -o emjetReplay
+//
+// Usage: emjetReplay [-n maxEvents] [-r repeat] [-d] snapshot.bin
+//   -n : process at most maxEvents events
+//   -r : process each event repeat times (for timing)
+//   -d : dump per-jet and per-event quantities, one line per object, for regression tests
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/ReplaySnapshot.h"
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/EmJetCore.h"
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/VertexIndex.h"
+
+using namespace emjet::replay;
+
+namespace
+{
+  // dz windows of Jet::alphaMax_dz*, in cm
+  const double dzWindows[] = { 0.00001, 0.00002, 0.00005, 0.0001, 0.0002, 0.0005, 0.001, 0.002, 0.005,
+                               0.01, 0.02, 0.05, 0.10, 0.20, 0.50, 1.0, 2.0, 5.0, 10.0, 20.0, 50.0 };
+  const int nDzWindows = sizeof(dzWindows)/sizeof(dzWindows[0]);
+  const double maxDxy = 0.1; // dxy to beam spot < 0.1cm
+
+  struct JetResult {
+    double alpha, alphaMax, alpha2, alphaMax2, alphaGen;
+    double alphaMax_dz[nDzWindows];
+    double alphaMax2_dz[nDzWindows];
+  };
+
+  // Same quantities as EmJetAnalyzer::prepareJet, for one jet and one set of tracks
+  void computeAlphas(const Event& event, const std::vector<uint32_t>& tracks, double& alpha, double& alphaMax, double* alphaMax_dz)
+  {
+    const Vertex& primary_vertex = event.primaryVertices[event.primaryVertexIndex];
+    auto pt = [&](uint32_t itk) { return event.tracks[itk].pt(); };
+    alpha = emjet::computeAlpha(tracks, pt, [&](uint32_t itk) { return primary_vertex.trackWeight(itk) > 0; });
+    alphaMax = emjet::computeAlphaMax(tracks, event.primaryVertices, pt,
+                                      [&](const Vertex& vtx, uint32_t itk) { return vtx.trackWeight(itk) > 0; });
+    for (int i = 0; i < nDzWindows; i++) {
+      double max_dz = dzWindows[i];
+      alphaMax_dz[i] = emjet::computeAlphaMax(tracks, event.primaryVertices, pt,
+                                              [&](const Vertex& vtx, uint32_t itk) {
+                                                const Track& trk = event.tracks[itk];
+                                                return std::fabs(trk.dxy(event.beamSpot)) < maxDxy && std::fabs(trk.dz(vtx.position())) < max_dz;
+                                              });
+    }
+  }
+
+  void processJet(const Event& event, const Jet& jet, JetResult& result)
+  {
+    // Jet constituent tracks
+    computeAlphas(event, jet.trackIndex, result.alpha, result.alphaMax, result.alphaMax_dz);
+    // generalTracks within deltaR, as in EmJetAnalyzer::getJetTrackVectorDeltaR
+    std::vector<uint32_t> tracks;
+    for (uint32_t itk = 0; itk < event.tracks.size(); itk++) {
+      const Track& trk = event.tracks[itk];
+      if ( !emjet::selectTrack(trk.pt(), trk.qualityMask) ) continue;
+      if ( !emjet::selectJetTrackDeltaR(trk.eta(), trk.phi(), jet.eta, jet.phi) ) continue;
+      tracks.push_back(itk);
+    }
+    computeAlphas(event, tracks, result.alpha2, result.alphaMax2, result.alphaMax2_dz);
+    result.alphaGen = emjet::computeAlphaGen(event.genParticles, jet.eta, jet.phi);
+  }
+
+  // Gen vertex, computeMinVertexDistance needs position()
+  struct GenVertex {
+    Point p;
+    const Point& position() const { return p; }
+  };
+
+  // Decay vertices of dark pions, as in EmJetAnalyzer::findDarkPionVertices
+  void findDarkPionVertices(const Event& event, std::vector<GenVertex>& vertices)
+  {
+    vertices.clear();
+    for (const auto& gp : event.genParticles) {
+      if (gp.pdgId()==4900111 && gp.firstDaughter >= 0) {
+        GenVertex vtx = { event.genParticles[gp.firstDaughter].position() };
+        vertices.push_back(vtx);
+      }
+    }
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  long maxEvents = -1;
+  int repeat = 1;
+  bool dump = false;
+  std::string filename;
+  for (int i = 1; i < argc; i++) {
+    if      ( !std::strcmp(argv[i], "-n") && i+1 < argc ) maxEvents = std::atol(argv[++i]);
+    else if ( !std::strcmp(argv[i], "-r") && i+1 < argc ) repeat = std::atoi(argv[++i]);
+    else if ( !std::strcmp(argv[i], "-d") ) dump = true;
+    else if ( argv[i][0] != '-' && filename.empty() ) filename = argv[i];
+    else {
+      std::cerr << "Usage: " << argv[0] << " [-n maxEvents] [-r repeat] [-d] snapshot.bin\n";
+      return 1;
+    }
+  }
+  if (filename.empty()) {
+    std::cerr << "Usage: " << argv[0] << " [-n maxEvents] [-r repeat] [-d] snapshot.bin\n";
+    return 1;
+  }
+
+  ReplayReader reader(filename);
+  Event event;
+  long nEvents = 0, nSkipped = 0, nJets = 0;
+  double alphaMaxSum = 0.;
+  double seconds = 0., secondsJets = 0., secondsVertices = 0.; // Total, and per stage
+  emjet::VertexIndex vertexIndex;
+  std::vector<JetResult> results;
+  while ( (maxEvents < 0 || nEvents < maxEvents) && reader.read(event) ) {
+    nEvents++;
+    // Jet quantities are undefined without a primary vertex
+    if (event.primaryVertexIndex < 0) { nSkipped++; continue; }
+    results.resize(event.jets.size());
+    std::vector<GenVertex> genVertices;
+    std::tuple< std::vector<double>, std::vector<double>, std::vector<double>, std::vector<double> > distances;
+    std::vector<float> matchDist2D;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) {
+      auto startJets = std::chrono::steady_clock::now();
+      for (unsigned ijet = 0; ijet < event.jets.size(); ijet++) processJet(event, event.jets[ijet], results[ijet]);
+      auto startVertices = std::chrono::steady_clock::now();
+      secondsJets += std::chrono::duration<double>(startVertices - startJets).count();
+      // Gen to reco vertex distances
+      findDarkPionVertices(event, genVertices);
+      distances = computeMinVertexDistance(&genVertices, &event.secondaryVertices);
+      vertexIndex.Build(event.secondaryVertices);
+      matchDist2D.clear();
+      if (vertexIndex.size() > 0) {
+        for (const auto& v : genVertices) matchDist2D.push_back(vertexIndex.Dist2D(vertexIndex.Nearest2D(v.p.x(), v.p.y()), v.p.x(), v.p.y()));
+      }
+      secondsVertices += std::chrono::duration<double>(std::chrono::steady_clock::now() - startVertices).count();
+    }
+    seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    nJets += event.jets.size();
+    for (const auto& result : results) alphaMaxSum += result.alphaMax;
+
+    if (dump) {
+      for (unsigned ijet = 0; ijet < results.size(); ijet++) {
+        const JetResult& result = results[ijet];
+        std::printf("jet %u %u %llu %u %.6g %.6g %.6g %.6g %.6g", event.run, event.lumi, (unsigned long long)event.event, ijet,
+                    result.alpha, result.alphaMax, result.alpha2, result.alphaMax2, result.alphaGen);
+        for (int i = 0; i < nDzWindows; i++) std::printf(" %.6g", result.alphaMax_dz[i]);
+        for (int i = 0; i < nDzWindows; i++) std::printf(" %.6g", result.alphaMax2_dz[i]);
+        std::printf("\n");
+      }
+      std::printf("vtx %u %u %llu", event.run, event.lumi, (unsigned long long)event.event);
+      for (double d : std::get<0>(distances)) std::printf(" %.6g", d);
+      for (float d : matchDist2D) std::printf(" %.6g", d);
+      std::printf("\n");
+    }
+  }
+
+  std::cerr << "emjetReplay: " << nEvents << " events (" << nSkipped << " without primary vertex), " << nJets << " jets\n";
+  std::cerr << "emjetReplay: mean alphaMax " << (nJets ? alphaMaxSum/nJets : 0.) << "\n";
+  std::cerr << "emjetReplay: " << seconds << " s for " << repeat << " pass(es), "
+            << (nEvents > nSkipped ? 1e3*seconds/((nEvents-nSkipped)*repeat) : 0.) << " ms per event per pass\n";
+  std::cerr << "emjetReplay: stage jets " << secondsJets << " s\n";
+  std::cerr << "emjetReplay: stage vertices " << secondsVertices << " s\n";
+  return 0;
+}
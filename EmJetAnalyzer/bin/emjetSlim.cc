@@ -0,0 +1,196 @@
+// Multithreaded slimming and skimming of EmJetAnalyzer ntuples
+// Copies the entries passing a selection, with a subset of the OutputTree branches, to a new ntuple.
+// The entries of all input files are split into ranges (ColumnEngine.h), each thread writes its own part file,
+// and the parts are merged at the end without recompression.
+// Only the branches of the selection are read for every entry, the remaining output branches only for selected
+// entries. Branches that are not written are never read.
+// Without selection, input trees that lie entirely inside a thread's range are fast-cloned (baskets are copied
+// without decompression), only the entries of trees split between two ranges are copied one by one.
+//
+// Usage: emjetSlim [-j nThreads] [-t tree] [-s selection] [-b branches] [-z compression] [-k] -o output.root ntuple.root...
+//   -j : number of threads, default all cores
+//   -t : tree name, default emJetAnalyzer/emJetTree
+//   -s : selection, TTreeFormula expression as in TTree::Draw, e.g. "Sum$(jet_pt>100 && abs(jet_eta)<2)>=4"
+//        An entry is kept if any instance of the expression is non-zero, as in TTree::CopyTree
+//   -b : comma separated list of branches to keep, a trailing '*' keeps all branches with that prefix, e.g.
+//        "run,lumi,event,jet_*" (see ColumnReader::Request). Can be repeated, default all branches.
+//   -z : compression setting of output, 100*algorithm+level, default 204 (LZMA level 4)
+//        Fast-cloned baskets keep the compression of the input
+//   -k : keep per-thread part files instead of merging them
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TBranch.h"
+#include "TFile.h"
+#include "TFileMerger.h"
+#include "TLeaf.h"
+#include "TTreeFormula.h"
+
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/ColumnEngine.h"
+
+using namespace emjet;
+
+namespace
+{
+  std::string partFileName(const std::string& output, unsigned slot)
+  {
+    std::string base = output;
+    if (base.size() > 5 && base.compare(base.size()-5, 5, ".root") == 0) base.erase(base.size()-5);
+    return base + ".part" + std::to_string(slot) + ".root";
+  }
+
+  // Directory of tree inside file, as created by TFileService
+  TDirectory* makeDirectory(TFile& file, const std::string& treeName)
+  {
+    size_t slash = treeName.rfind('/');
+    if (slash == std::string::npos) return &file;
+    std::string path = treeName.substr(0, slash);
+    TDirectory* dir = file.GetDirectory(path.c_str());
+    return dir ? dir : file.mkdir(path.c_str());
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  unsigned nThreads = 0;
+  std::string treeName = "emJetAnalyzer/emJetTree";
+  std::string selection;
+  std::string outputName;
+  int compression = 204;
+  bool keepParts = false;
+  ColumnReader columns; // Only used to validate and expand the branch list against the OutputTree schema
+  bool allColumns = true;
+  std::vector<std::string> files;
+  bool usage = false;
+  for (int i = 1; i < argc; i++) {
+    if      ( !std::strcmp(argv[i], "-j") && i+1 < argc ) nThreads = std::atoi(argv[++i]);
+    else if ( !std::strcmp(argv[i], "-t") && i+1 < argc ) treeName = argv[++i];
+    else if ( !std::strcmp(argv[i], "-s") && i+1 < argc ) selection = argv[++i];
+    else if ( !std::strcmp(argv[i], "-o") && i+1 < argc ) outputName = argv[++i];
+    else if ( !std::strcmp(argv[i], "-z") && i+1 < argc ) compression = std::atoi(argv[++i]);
+    else if ( !std::strcmp(argv[i], "-k") ) keepParts = true;
+    else if ( !std::strcmp(argv[i], "-b") && i+1 < argc ) {
+      std::istringstream branches(argv[++i]);
+      std::string branch;
+      while (std::getline(branches, branch, ',')) {
+        if (branch.empty()) continue;
+        try { columns.Request(branch); }
+        catch (const std::exception& e) { std::cerr << "emjetSlim: " << e.what() << "\n"; return 1; }
+        allColumns = false;
+      }
+    }
+    else if ( argv[i][0] != '-' ) files.push_back(argv[i]);
+    else usage = true;
+  }
+  if (usage || files.empty() || outputName.empty()) {
+    std::cerr << "Usage: " << argv[0] << " [-j nThreads] [-t tree] [-s selection] [-b branches] [-z compression] [-k] -o output.root ntuple.root...\n";
+    return 1;
+  }
+
+  ColumnEngine engine(files, treeName, nThreads);
+  std::vector<Long64_t> selected(engine.nThreads(), 0);
+  std::vector<int> nBranches(engine.nThreads(), 0);
+  auto start = std::chrono::steady_clock::now();
+  try {
+    engine.ForEachRange([&](TChain& chain, Long64_t first, Long64_t last, unsigned slot) {
+        // Part file is created even for an empty range, so that all parts can be merged
+        TFile output(partFileName(outputName, slot).c_str(), "RECREATE", "", compression);
+        if (output.IsZombie()) throw std::runtime_error("emjetSlim: can not open " + partFileName(outputName, slot));
+        TDirectory* dir = makeDirectory(output, treeName);
+        if (first >= last || chain.LoadTree(first) < 0) {
+          output.Write();
+          output.Close();
+          return;
+        }
+        // Output branches, branches missing in the input (older ntuples) are skipped
+        if (!allColumns) {
+          chain.SetBranchStatus("*", 0);
+          for (int i = 0; i < col::NCOLUMNS; i++) {
+            if ( columns.Requested(col::Id(i)) && chain.GetBranch(col::names[i]) ) {
+              chain.SetBranchStatus(col::names[i], 1);
+              nBranches[slot]++;
+            }
+          }
+        }
+        else {
+          nBranches[slot] = chain.GetListOfBranches()->GetEntries();
+        }
+
+        dir->cd();
+        TTree* slim = chain.CloneTree(0);
+
+        // Branches of the selection are enabled after cloning, so that they are read but not written
+        std::unique_ptr<TTreeFormula> formula;
+        if (!selection.empty()) {
+          formula.reset(new TTreeFormula("selection", selection.c_str(), &chain));
+          if (formula->GetNdim() == 0) throw std::runtime_error("emjetSlim: invalid selection " + selection);
+          for (int i = 0; i < formula->GetNcodes(); i++) {
+            if (formula->GetLeaf(i)) chain.SetBranchStatus(formula->GetLeaf(i)->GetBranch()->GetName(), 1);
+          }
+          chain.SetNotify(formula.get());
+        }
+
+        for (Long64_t i = first; i < last; i++) {
+          if (chain.LoadTree(i) < 0) break;
+          if (!formula && i == chain.GetChainOffset() && i + chain.GetTree()->GetEntries() <= last) {
+            // Whole input tree inside range
+            Long64_t n = chain.GetTree()->GetEntries();
+            dir->cd();
+            slim->CopyEntries(chain.GetTree(), -1, "fast");
+            selected[slot] += n;
+            i += n - 1;
+            continue;
+          }
+          if (formula) {
+            int ndata = formula->GetNdata();
+            bool pass = false;
+            for (int k = 0; k < ndata && !pass; k++) pass = formula->EvalInstance(k) != 0;
+            if (!pass) continue;
+          }
+          chain.GetEntry(i);
+          slim->Fill();
+          selected[slot]++;
+        }
+        chain.SetNotify(0);
+        dir->cd();
+        slim->Write();
+        output.Close();
+      });
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+
+  // Merge parts, baskets are copied without recompression
+  if (!keepParts) {
+    TFileMerger merger(kFALSE, kFALSE);
+    merger.SetFastMethod(kTRUE);
+    merger.SetPrintLevel(0);
+    if (!merger.OutputFile(outputName.c_str(), "RECREATE", compression)) {
+      std::cerr << "emjetSlim: can not open " << outputName << "\n";
+      return 1;
+    }
+    for (unsigned slot = 0; slot < engine.nThreads(); slot++) merger.AddFile(partFileName(outputName, slot).c_str(), kFALSE);
+    if (!merger.Merge()) {
+      std::cerr << "emjetSlim: merging parts into " << outputName << " failed\n";
+      return 1;
+    }
+    for (unsigned slot = 0; slot < engine.nThreads(); slot++) std::remove(partFileName(outputName, slot).c_str());
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  Long64_t nSelected = 0;
+  for (Long64_t n : selected) nSelected += n;
+  std::cerr << "emjetSlim: " << nSelected << " of " << engine.entries() << " events selected, "
+            << nBranches[0] << " branches, " << engine.nThreads() << " threads, " << seconds << " s\n";
+  return 0;
+}
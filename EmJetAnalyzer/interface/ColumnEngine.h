@@ -0,0 +1,120 @@
+#ifndef EmergingJetAnalysis_EmJetAnalyzer_ColumnEngine_h
+#define EmergingJetAnalysis_EmJetAnalyzer_ColumnEngine_h
+
+// Multithreaded loop over EmJetAnalyzer ntuples with ColumnReader
+// The entries of all input files are split into contiguous ranges, one per thread. Each thread opens its own
+// TChain and ColumnReader, since ROOT trees can not be shared between threads, and calls
+//   process(reader, slot)
+// for every entry of its range. slot is the thread number in [0, nThreads), per-slot results (histograms,
+// counters) are merged by the caller after Run() returns.
+//
+// Usage:
+//   ColumnEngine engine(files, "emJetAnalyzer/emJetTree", nThreads);
+//   engine.Run({"jet_alphaMax", "track_*"}, [&](const ColumnReader& r, unsigned slot) { ... });
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TChain.h"
+#include "TROOT.h"
+
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/EmJetColumns.h"
+
+namespace emjet
+{
+  class ColumnEngine {
+  public:
+    // nThreads = 0 uses all cores
+    ColumnEngine(const std::vector<std::string>& files, const std::string& treeName, unsigned nThreads = 0);
+
+    unsigned nThreads() const { return nThreads_; }
+    Long64_t entries() const { return entries_; }
+    // Entry range [begin, end) processed by slot
+    Long64_t begin(unsigned slot) const { return entries_ * slot / nThreads_; }
+    Long64_t end(unsigned slot) const { return entries_ * (slot+1) / nThreads_; }
+
+    // Read requested columns of all entries, see ColumnReader::Request for column names
+    void Run(const std::vector<std::string>& columns,
+             const std::function<void (const ColumnReader&, unsigned)>& process) const;
+    // Lower level loop, calls process(chain, begin, end, slot) once per thread with the thread's own chain
+    void ForEachRange(const std::function<void (TChain&, Long64_t, Long64_t, unsigned)>& process) const;
+
+  private:
+    void MakeChain(TChain& chain) const;
+
+    std::vector<std::string> files_;
+    std::string treeName_;
+    unsigned nThreads_;
+    Long64_t entries_;
+  };
+}
+
+inline
+emjet::ColumnEngine::ColumnEngine(const std::vector<std::string>& files, const std::string& treeName, unsigned nThreads) :
+  files_(files), treeName_(treeName), nThreads_(nThreads)
+{
+  ROOT::EnableThreadSafety();
+  if (nThreads_==0) nThreads_ = std::max(1u, std::thread::hardware_concurrency());
+  TChain chain;
+  MakeChain(chain);
+  entries_ = chain.GetEntries();
+  // No point in threads without entries
+  if (entries_ < nThreads_) nThreads_ = std::max(Long64_t(1), entries_);
+}
+
+inline void
+emjet::ColumnEngine::MakeChain(TChain& chain) const
+{
+  chain.SetName(treeName_.c_str());
+  for (const auto& file : files_) {
+    if (chain.Add(file.c_str(), 0)==0) throw std::runtime_error("ColumnEngine: can not read " + treeName_ + " from " + file);
+  }
+}
+
+inline void
+emjet::ColumnEngine::ForEachRange(const std::function<void (TChain&, Long64_t, Long64_t, unsigned)>& process) const
+{
+  std::vector<std::thread> threads;
+  std::vector<std::string> errors(nThreads_);
+  for (unsigned slot = 0; slot < nThreads_; slot++) {
+    threads.emplace_back([&, slot]() {
+      try {
+        TChain chain;
+        MakeChain(chain);
+        process(chain, begin(slot), end(slot), slot);
+      }
+      catch (const std::exception& e) {
+        errors[slot] = e.what();
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  for (const auto& error : errors) {
+    if (!error.empty()) throw std::runtime_error(error);
+  }
+}
+
+inline void
+emjet::ColumnEngine::Run(const std::vector<std::string>& columns,
+                         const std::function<void (const ColumnReader&, unsigned)>& process) const
+{
+  ForEachRange([&](TChain& chain, Long64_t first, Long64_t last, unsigned slot) {
+      ColumnReader reader;
+      for (const auto& column : columns) reader.Request(column);
+      reader.Attach(&chain);
+      // Only enabled branches are added to the cache
+      chain.SetCacheSize(30*1024*1024);
+      chain.AddBranchToCache("*", true);
+      chain.SetCacheEntryRange(first, last);
+      for (Long64_t i = first; i < last; i++) {
+        chain.GetEntry(i);
+        process(reader, slot);
+      }
+    });
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef EmergingJetAnalysis_EmJetAnalyzer_EarlyExit_h
+#define EmergingJetAnalysis_EmJetAnalyzer_EarlyExit_h
+
+// Early event rejection for EmJetAnalyzer
+// Evaluated on cheap event quantities (HLT_bits, good primary vertex count, selectedJets) before
+// tracks, PF candidates, MET, b-tags and gen particles are read and TransientTracks are built.
+// Rejected events are not written to emJetTree.
+// All cuts default to "pass", so an empty (or missing) earlyExit PSet keeps every event.
+//
+// earlyExit PSet (untracked, all optional):
+//   hltMask          : uint32, require (HLT_bits & hltMask) != 0, 0 disables
+//   minNGoodVtx      : int, minimum event_.nGoodVtx
+//   minNSelectedJets : uint32, minimum number of selectedJets
+//   minLeadingJetPt  : double, minimum pt of leading selected jet
+//   minHT            : double, minimum scalar pt sum of selected jets
+
+#include <vector>
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/JetReco/interface/PFJet.h"
+
+namespace emjet
+{
+  class EarlyExit {
+  public:
+    EarlyExit() : hltMask_(0), minNGoodVtx_(0), minNSelectedJets_(0), minLeadingJetPt_(0.), minHT_(0.) {}
+    explicit EarlyExit(const edm::ParameterSet& pset) :
+      hltMask_          ( pset.getUntrackedParameter<unsigned> ( "hltMask"          , 0  ) ) ,
+      minNGoodVtx_      ( pset.getUntrackedParameter<int>      ( "minNGoodVtx"      , 0  ) ) ,
+      minNSelectedJets_ ( pset.getUntrackedParameter<unsigned> ( "minNSelectedJets" , 0  ) ) ,
+      minLeadingJetPt_  ( pset.getUntrackedParameter<double>   ( "minLeadingJetPt"  , 0. ) ) ,
+      minHT_            ( pset.getUntrackedParameter<double>   ( "minHT"            , 0. ) )
+    {}
+
+    // Return true if event should be processed further
+    bool accept(int hltBits, int nGoodVtx, const edm::View<reco::PFJet>& jets) const {
+      if ( hltMask_ && !(unsigned(hltBits) & hltMask_) ) return false;
+      if ( nGoodVtx < minNGoodVtx_ ) return false;
+      if ( jets.size() < minNSelectedJets_ ) return false;
+      if ( minLeadingJetPt_ > 0. || minHT_ > 0. ) {
+        double leadingPt = 0., ht = 0.;
+        for (const auto& jet : jets) {
+          if ( jet.pt() > leadingPt ) leadingPt = jet.pt();
+          ht += jet.pt();
+        }
+        if ( leadingPt < minLeadingJetPt_ ) return false;
+        if ( ht < minHT_ ) return false;
+      }
+      return true;
+    }
+
+  private:
+    unsigned hltMask_;
+    int minNGoodVtx_;
+    unsigned minNSelectedJets_;
+    double minLeadingJetPt_;
+    double minHT_;
+  };
+}
+
+#endif
@@ -1,68 +1,8 @@
-// :VERTEXTESTING:
-template <class T>
-std::tuple< std::vector<double>, std::vector<double>, std::vector<double>, std::vector<double>  >
-computeMinVertexDistance(const reco::VertexCollection* vertexVector_gen, const T* vertexVector_reco)
-{
-  // Gen vertex to Reco vertex distance
-  vector<double> GenToReco;
-  for (auto vtx_gen: *vertexVector_gen) {
-    double minDistance = 999;
-    for (auto vtx_reco: *vertexVector_reco) {
-      double x = vtx_reco.position().x() - vtx_gen.position().x();
-      double y = vtx_reco.position().y() - vtx_gen.position().y();
-      double z = vtx_reco.position().z() - vtx_gen.position().z();
-      TVector3 delta(x, y, z);
-      double distance = delta.Mag();
-      if (distance < minDistance) minDistance = distance;
-    }
-    GenToReco.push_back(minDistance);
-  }
-  // Reco vertex to Gen vertex distance
-  vector<double> RecoToGen;
-  for (auto vtx_reco: *vertexVector_reco) {
-    double minDistance = 999;
-    for (auto vtx_gen: *vertexVector_gen) {
-      double x = vtx_reco.position().x() - vtx_gen.position().x();
-      double y = vtx_reco.position().y() - vtx_gen.position().y();
-      double z = vtx_reco.position().z() - vtx_gen.position().z();
-      TVector3 delta(x, y, z);
-      double distance = delta.Mag();
-      if (distance < minDistance) minDistance = distance;
-    }
-    RecoToGen.push_back(minDistance);
-  }
-  // Gen vertex to Reco vertex distance
-  vector<double> GenToReco2D;
-  for (auto vtx_gen: *vertexVector_gen) {
-    double minDistance = 999;
-    for (auto vtx_reco: *vertexVector_reco) {
-      double x = vtx_reco.position().x() - vtx_gen.position().x();
-      double y = vtx_reco.position().y() - vtx_gen.position().y();
-      double z = vtx_reco.position().z() - vtx_gen.position().z();
-      TVector3 delta(x, y, z);
-      double distance = delta.Perp();
-      if (distance < minDistance) minDistance = distance;
-    }
-    GenToReco2D.push_back(minDistance);
-  }
-  // Reco vertex to Gen vertex distance
-  vector<double> RecoToGen2D;
-  for (auto vtx_reco: *vertexVector_reco) {
-    double minDistance = 999;
-    for (auto vtx_gen: *vertexVector_gen) {
-      double x = vtx_reco.position().x() - vtx_gen.position().x();
-      double y = vtx_reco.position().y() - vtx_gen.position().y();
-      double z = vtx_reco.position().z() - vtx_gen.position().z();
-      TVector3 delta(x, y, z);
-      double distance = delta.Perp();
-      if (distance < minDistance) minDistance = distance;
-    }
-    RecoToGen2D.push_back(minDistance);
-  }
-  // Return std::tuple
-  return std::make_tuple(GenToReco, GenToReco2D, RecoToGen, RecoToGen2D);
-}
+// computeMinVertexDistance is shared with emjetReplay
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/EmJetCore.h"
+#include "EmergingJetAnalysis/Utils/interface/Kinematics.h"
 
+// :VERTEXTESTING:
 template <class T>
 std::tuple< std::vector<double>, std::vector<double>, std::vector<double>, std::vector<double>  >
 computeVertexDistance(const reco::VertexCollection* vertexVector_gen, const T* vertexVector_reco)
@@ -74,8 +14,7 @@ computeVertexDistance(const reco::VertexCollection* vertexVector_gen, const T* v
       double x = vtx_reco.position().x() - vtx_gen.position().x();
       double y = vtx_reco.position().y() - vtx_gen.position().y();
       double z = vtx_reco.position().z() - vtx_gen.position().z();
-      TVector3 delta(x, y, z);
-      double distance = delta.Mag();
+      double distance = emjet::kin::mag(x, y, z);
       GenToReco.push_back(distance);
     }
   }
@@ -86,8 +25,7 @@ computeVertexDistance(const reco::VertexCollection* vertexVector_gen, const T* v
       double x = vtx_reco.position().x() - vtx_gen.position().x();
       double y = vtx_reco.position().y() - vtx_gen.position().y();
       double z = vtx_reco.position().z() - vtx_gen.position().z();
-      TVector3 delta(x, y, z);
-      double distance = delta.Mag();
+      double distance = emjet::kin::mag(x, y, z);
       RecoToGen.push_back(distance);
     }
   }
@@ -97,9 +35,7 @@ computeVertexDistance(const reco::VertexCollection* vertexVector_gen, const T* v
     for (auto vtx_reco: *vertexVector_reco) {
       double x = vtx_reco.position().x() - vtx_gen.position().x();
       double y = vtx_reco.position().y() - vtx_gen.position().y();
-      double z = vtx_reco.position().z() - vtx_gen.position().z();
-      TVector3 delta(x, y, z);
-      double distance = delta.Perp();
+      double distance = emjet::kin::perp(x, y);
       GenToReco2D.push_back(distance);
     }
   }
@@ -109,9 +45,7 @@ computeVertexDistance(const reco::VertexCollection* vertexVector_gen, const T* v
     for (auto vtx_gen: *vertexVector_gen) {
       double x = vtx_reco.position().x() - vtx_gen.position().x();
       double y = vtx_reco.position().y() - vtx_gen.position().y();
-      double z = vtx_reco.position().z() - vtx_gen.position().z();
-      TVector3 delta(x, y, z);
-      double distance = delta.Perp();
+      double distance = emjet::kin::perp(x, y);
       RecoToGen2D.push_back(distance);
     }
   }
@@ -136,15 +70,8 @@ double computeGenTrackDistance (const reco::GenParticle* gp, const T* track)
   //   return distance;
   // }
   else {
-    float c_pt = 1.0;
-    double d_pt = ( track->pt() - gp->pt() ) / gp->pt();
-    double d_eta =  track->eta() - gp->eta() ;
-    double d_phi =  track->phi() - gp->phi() ;
-    TLorentzVector d;
-    d.SetPtEtaPhiE(c_pt*d_pt, d_eta, d_phi, 0);
-    // d.SetPtEtaPhiE(c_pt*d_pt, 0, 0, 0);
-    d.SetPtEtaPhiE(0, d_eta, d_phi, 0);
-    distance = d.Vect().Mag();
+    // Distance in (eta, phi), the relative pt difference is not used
+    distance = emjet::kin::deltaR(double(track->eta()), double(track->phi()), double(gp->eta()), double(gp->phi()));
     return distance;
   }
 }
@@ -198,3 +125,40 @@ const T* findMinDistanceTransientTrack (const reco::GenParticle* gp, const vecto
   return minDistance_ttrack;
 }
 
+// Associate each jet in jets with an entry of bTags, index-aligned with jets
+// Jets referring to the tagged jet collection are matched by reference key, other jets by deltaR < maxDeltaR
+// Entry is the index into bTags, or -1 if the jet does not have exactly one matching tag
+template <class T>
+vector<int> associateJetTags (const edm::View<T>& jets, const reco::JetTagCollection& bTags, double maxDeltaR=0.01)
+{
+  unsigned nJets = jets.size();
+  vector<int> tagIndex(nJets, -1);
+  if (bTags.size()==0) return tagIndex;
+  edm::ProductID tagJetsID = bTags.keyProduct().id();
+  double maxDeltaR2 = maxDeltaR*maxDeltaR;
+  vector<double> tagEta, tagPhi; // Filled on first deltaR match
+  for (unsigned ijet = 0; ijet < nJets; ijet++) {
+    edm::RefToBase<T> jetRef = jets.refAt(ijet);
+    // JetTagCollection entries are aligned with the keys of the tagged jet collection
+    if ( jetRef.id() == tagJetsID && jetRef.key() < bTags.size() ) {
+      tagIndex[ijet] = jetRef.key();
+      continue;
+    }
+    if ( tagEta.empty() ) {
+      for (unsigned itag = 0; itag < bTags.size(); itag++) {
+        tagEta.push_back(bTags[itag].first->eta());
+        tagPhi.push_back(bTags[itag].first->phi());
+      }
+    }
+    int nMatched = 0;
+    for (unsigned itag = 0; itag < bTags.size(); itag++) {
+      if ( emjet::kin::deltaR2(tagEta[itag], tagPhi[itag], double(jets[ijet].eta()), double(jets[ijet].phi())) < maxDeltaR2 ) {
+        tagIndex[ijet] = itag;
+        nMatched++;
+      }
+    }
+    if (nMatched!=1) tagIndex[ijet] = -1;
+  }
+  return tagIndex;
+}
+
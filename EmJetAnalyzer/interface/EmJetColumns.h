@@ -0,0 +1,1283 @@
+#ifndef EmergingJetAnalysis_EmJetAnalyzer_EmJetColumns_h
+#define EmergingJetAnalysis_EmJetAnalyzer_EmJetColumns_h
+
+// Columnar reader for EmJetAnalyzer ntuples
+// Generated by cog from the same Var lists as OutputTree (cogFiles/vars_EmJetAnalyzer.py), so that the reader
+// always matches the ntuple layout. Only requested columns are enabled and read, all other branches of the
+// tree are disabled.
+// Column types follow OutputTree: event columns are scalars, jet (gp_, pv_) columns are vector<T>* indexed by
+// jet, track and vertex columns are vector<vector<T> >* indexed by [jet][track].
+//
+// Usage:
+//   ColumnReader reader;
+//   reader.Request("jet_alphaMax"); reader.Request("track_*");
+//   reader.Attach(tree);
+//   tree->GetEntry(i); (*reader.jet_alphaMax)[ijet] ...
+
+#include <bitset>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TTree.h"
+
+using std::vector;
+
+namespace emjet
+{
+  namespace col
+  {
+    // Column identifiers, one per branch
+    enum Id {
+      // Generated by cog
+      // Do NOT edit until "end"
+      //[[[cog
+      //import cog
+      //import vars_EmJetAnalyzer as mod; mod.gen_ColumnIds()
+      //]]]
+      run                 ,
+      lumi                ,
+      event               ,
+      bx                  ,
+      nVtx                ,
+      nGoodVtx            ,
+      nTrueInt            ,
+      met_pt              ,
+      met_phi             ,
+      nTracks             ,
+      alpha_event         ,
+      pdf_id1             ,
+      pdf_id2             ,
+      pdf_x1              ,
+      pdf_x2              ,
+      pdf_pdf1            ,
+      pdf_pdf2            ,
+      pdf_scalePDF        ,
+      HLT_PFHT400         ,
+      HLT_PFHT475         ,
+      HLT_PFHT600         ,
+      HLT_PFHT800         ,
+      HLT_PFHT900         ,
+      HLT_HT250           ,
+      HLT_HT350           ,
+      HLT_HT400           ,
+      HLT_HT500           ,
+      HLT_bits            ,
+      budgetFlags         ,
+      jet_index               ,
+      jet_source              ,
+      jet_ptRaw               ,
+      jet_eta                 ,
+      jet_phi                 ,
+      jet_pt                  ,
+      jet_ptUp                ,
+      jet_ptDown              ,
+      jet_csv                 ,
+      jet_cef                 ,
+      jet_nef                 ,
+      jet_chf                 ,
+      jet_nhf                 ,
+      jet_pef                 ,
+      jet_mef                 ,
+      jet_missHits            ,
+      jet_muonHits            ,
+      jet_alpha               ,
+      jet_alpha2              ,
+      jet_alphaMax            ,
+      jet_alphaMax2           ,
+      jet_alpha_gen           ,
+      jet_alphaMax_dz100nm    ,
+      jet_alphaMax_dz200nm    ,
+      jet_alphaMax_dz500nm    ,
+      jet_alphaMax_dz1um      ,
+      jet_alphaMax_dz2um      ,
+      jet_alphaMax_dz5um      ,
+      jet_alphaMax_dz10um     ,
+      jet_alphaMax_dz20um     ,
+      jet_alphaMax_dz50um     ,
+      jet_alphaMax_dz100um    ,
+      jet_alphaMax_dz200um    ,
+      jet_alphaMax_dz500um    ,
+      jet_alphaMax_dz1mm      ,
+      jet_alphaMax_dz2mm      ,
+      jet_alphaMax_dz5mm      ,
+      jet_alphaMax_dz1cm      ,
+      jet_alphaMax_dz2cm      ,
+      jet_alphaMax_dz5cm      ,
+      jet_alphaMax_dz10cm     ,
+      jet_alphaMax_dz20cm     ,
+      jet_alphaMax_dz50cm     ,
+      jet_alphaMax2_dz100nm   ,
+      jet_alphaMax2_dz200nm   ,
+      jet_alphaMax2_dz500nm   ,
+      jet_alphaMax2_dz1um     ,
+      jet_alphaMax2_dz2um     ,
+      jet_alphaMax2_dz5um     ,
+      jet_alphaMax2_dz10um    ,
+      jet_alphaMax2_dz20um    ,
+      jet_alphaMax2_dz50um    ,
+      jet_alphaMax2_dz100um   ,
+      jet_alphaMax2_dz200um   ,
+      jet_alphaMax2_dz500um   ,
+      jet_alphaMax2_dz1mm     ,
+      jet_alphaMax2_dz2mm     ,
+      jet_alphaMax2_dz5mm     ,
+      jet_alphaMax2_dz1cm     ,
+      jet_alphaMax2_dz2cm     ,
+      jet_alphaMax2_dz5cm     ,
+      jet_alphaMax2_dz10cm    ,
+      jet_alphaMax2_dz20cm    ,
+      jet_alphaMax2_dz50cm    ,
+      jet_nDarkPions          ,
+      jet_nDarkGluons         ,
+      jet_minDRDarkPion       ,
+      jet_theta2D             ,
+      track_index               ,
+      track_source              ,
+      track_jet_index           ,
+      track_vertex_index        ,
+      track_vertex_weight       ,
+      track_nHitsInFrontOfVert  ,
+      track_missHitsAfterVert   ,
+      track_pt                  ,
+      track_eta                 ,
+      track_phi                 ,
+      track_ref_x               ,
+      track_ref_y               ,
+      track_ref_z               ,
+      track_d0Error             ,
+      track_dzError             ,
+      track_pca_r               ,
+      track_pca_eta             ,
+      track_pca_phi             ,
+      track_innerHit_r          ,
+      track_innerHit_eta        ,
+      track_innerHit_phi        ,
+      track_quality             ,
+      track_algo                ,
+      track_originalAlgo        ,
+      track_nHits               ,
+      track_nMissInnerHits      ,
+      track_nTrkLayers          ,
+      track_nMissInnerTrkLayers ,
+      track_nMissOuterTrkLayers ,
+      track_nMissTrkLayers      ,
+      track_nPxlLayers          ,
+      track_nMissInnerPxlLayers ,
+      track_nMissOuterPxlLayers ,
+      track_nMissPxlLayers      ,
+      track_ipXY                ,
+      track_ipZ                 ,
+      track_ipXYSig             ,
+      track_ip3D                ,
+      track_ip3DSig             ,
+      track_dRToJetAxis         ,
+      track_distanceToJet       ,
+      track_minVertexDz         ,
+      track_pvWeight            ,
+      track_minGenDistance      ,
+      vertex_index               ,
+      vertex_source              ,
+      vertex_jet_index           ,
+      vertex_x                   ,
+      vertex_y                   ,
+      vertex_z                   ,
+      vertex_xError              ,
+      vertex_yError              ,
+      vertex_zError              ,
+      vertex_deltaR              ,
+      vertex_Lxy                 ,
+      vertex_mass                ,
+      vertex_chi2                ,
+      vertex_ndof                ,
+      vertex_pt2sum              ,
+      gp_index               ,
+      gp_status              ,
+      gp_pdgId               ,
+      gp_charge              ,
+      gp_mass                ,
+      gp_pt                  ,
+      gp_eta                 ,
+      gp_phi                 ,
+      gp_vx                  ,
+      gp_vy                  ,
+      gp_vz                  ,
+      gp_min2Ddist           ,
+      gp_min2Dsig            ,
+      gp_min3Ddist           ,
+      gp_min3Dsig            ,
+      gp_minDeltaR           ,
+      gp_matched2Ddist       ,
+      gp_matched2Dsig        ,
+      gp_matched3Ddist       ,
+      gp_matched3Dsig        ,
+      gp_matchedDeltaR       ,
+      gp_Lxy                 ,
+      gp_isDark              ,
+      gp_nDaughters          ,
+      gp_hasSMDaughter       ,
+      gp_hasDarkMother       ,
+      gp_hasDarkPionMother   ,
+      gp_isTrackable         ,
+      pv_index               ,
+      pv_x                   ,
+      pv_y                   ,
+      pv_z                   ,
+      pv_xError              ,
+      pv_yError              ,
+      pv_zError              ,
+      pv_chi2                ,
+      pv_ndof                ,
+      pv_pt2sum              ,
+      pv_nTracks             ,
+      //[[[end]]]
+      NCOLUMNS
+    };
+
+    // Branch name of each column
+    static const char* const names[NCOLUMNS] = {
+      // Generated by cog
+      // Do NOT edit until "end"
+      //[[[cog
+      //import cog
+      //import vars_EmJetAnalyzer as mod; mod.gen_ColumnNames()
+      //]]]
+      "run",
+      "lumi",
+      "event",
+      "bx",
+      "nVtx",
+      "nGoodVtx",
+      "nTrueInt",
+      "met_pt",
+      "met_phi",
+      "nTracks",
+      "alpha_event",
+      "pdf_id1",
+      "pdf_id2",
+      "pdf_x1",
+      "pdf_x2",
+      "pdf_pdf1",
+      "pdf_pdf2",
+      "pdf_scalePDF",
+      "HLT_PFHT400",
+      "HLT_PFHT475",
+      "HLT_PFHT600",
+      "HLT_PFHT800",
+      "HLT_PFHT900",
+      "HLT_HT250",
+      "HLT_HT350",
+      "HLT_HT400",
+      "HLT_HT500",
+      "HLT_bits",
+      "budgetFlags",
+      "jet_index",
+      "jet_source",
+      "jet_ptRaw",
+      "jet_eta",
+      "jet_phi",
+      "jet_pt",
+      "jet_ptUp",
+      "jet_ptDown",
+      "jet_csv",
+      "jet_cef",
+      "jet_nef",
+      "jet_chf",
+      "jet_nhf",
+      "jet_pef",
+      "jet_mef",
+      "jet_missHits",
+      "jet_muonHits",
+      "jet_alpha",
+      "jet_alpha2",
+      "jet_alphaMax",
+      "jet_alphaMax2",
+      "jet_alpha_gen",
+      "jet_alphaMax_dz100nm",
+      "jet_alphaMax_dz200nm",
+      "jet_alphaMax_dz500nm",
+      "jet_alphaMax_dz1um",
+      "jet_alphaMax_dz2um",
+      "jet_alphaMax_dz5um",
+      "jet_alphaMax_dz10um",
+      "jet_alphaMax_dz20um",
+      "jet_alphaMax_dz50um",
+      "jet_alphaMax_dz100um",
+      "jet_alphaMax_dz200um",
+      "jet_alphaMax_dz500um",
+      "jet_alphaMax_dz1mm",
+      "jet_alphaMax_dz2mm",
+      "jet_alphaMax_dz5mm",
+      "jet_alphaMax_dz1cm",
+      "jet_alphaMax_dz2cm",
+      "jet_alphaMax_dz5cm",
+      "jet_alphaMax_dz10cm",
+      "jet_alphaMax_dz20cm",
+      "jet_alphaMax_dz50cm",
+      "jet_alphaMax2_dz100nm",
+      "jet_alphaMax2_dz200nm",
+      "jet_alphaMax2_dz500nm",
+      "jet_alphaMax2_dz1um",
+      "jet_alphaMax2_dz2um",
+      "jet_alphaMax2_dz5um",
+      "jet_alphaMax2_dz10um",
+      "jet_alphaMax2_dz20um",
+      "jet_alphaMax2_dz50um",
+      "jet_alphaMax2_dz100um",
+      "jet_alphaMax2_dz200um",
+      "jet_alphaMax2_dz500um",
+      "jet_alphaMax2_dz1mm",
+      "jet_alphaMax2_dz2mm",
+      "jet_alphaMax2_dz5mm",
+      "jet_alphaMax2_dz1cm",
+      "jet_alphaMax2_dz2cm",
+      "jet_alphaMax2_dz5cm",
+      "jet_alphaMax2_dz10cm",
+      "jet_alphaMax2_dz20cm",
+      "jet_alphaMax2_dz50cm",
+      "jet_nDarkPions",
+      "jet_nDarkGluons",
+      "jet_minDRDarkPion",
+      "jet_theta2D",
+      "track_index",
+      "track_source",
+      "track_jet_index",
+      "track_vertex_index",
+      "track_vertex_weight",
+      "track_nHitsInFrontOfVert",
+      "track_missHitsAfterVert",
+      "track_pt",
+      "track_eta",
+      "track_phi",
+      "track_ref_x",
+      "track_ref_y",
+      "track_ref_z",
+      "track_d0Error",
+      "track_dzError",
+      "track_pca_r",
+      "track_pca_eta",
+      "track_pca_phi",
+      "track_innerHit_r",
+      "track_innerHit_eta",
+      "track_innerHit_phi",
+      "track_quality",
+      "track_algo",
+      "track_originalAlgo",
+      "track_nHits",
+      "track_nMissInnerHits",
+      "track_nTrkLayers",
+      "track_nMissInnerTrkLayers",
+      "track_nMissOuterTrkLayers",
+      "track_nMissTrkLayers",
+      "track_nPxlLayers",
+      "track_nMissInnerPxlLayers",
+      "track_nMissOuterPxlLayers",
+      "track_nMissPxlLayers",
+      "track_ipXY",
+      "track_ipZ",
+      "track_ipXYSig",
+      "track_ip3D",
+      "track_ip3DSig",
+      "track_dRToJetAxis",
+      "track_distanceToJet",
+      "track_minVertexDz",
+      "track_pvWeight",
+      "track_minGenDistance",
+      "vertex_index",
+      "vertex_source",
+      "vertex_jet_index",
+      "vertex_x",
+      "vertex_y",
+      "vertex_z",
+      "vertex_xError",
+      "vertex_yError",
+      "vertex_zError",
+      "vertex_deltaR",
+      "vertex_Lxy",
+      "vertex_mass",
+      "vertex_chi2",
+      "vertex_ndof",
+      "vertex_pt2sum",
+      "gp_index",
+      "gp_status",
+      "gp_pdgId",
+      "gp_charge",
+      "gp_mass",
+      "gp_pt",
+      "gp_eta",
+      "gp_phi",
+      "gp_vx",
+      "gp_vy",
+      "gp_vz",
+      "gp_min2Ddist",
+      "gp_min2Dsig",
+      "gp_min3Ddist",
+      "gp_min3Dsig",
+      "gp_minDeltaR",
+      "gp_matched2Ddist",
+      "gp_matched2Dsig",
+      "gp_matched3Ddist",
+      "gp_matched3Dsig",
+      "gp_matchedDeltaR",
+      "gp_Lxy",
+      "gp_isDark",
+      "gp_nDaughters",
+      "gp_hasSMDaughter",
+      "gp_hasDarkMother",
+      "gp_hasDarkPionMother",
+      "gp_isTrackable",
+      "pv_index",
+      "pv_x",
+      "pv_y",
+      "pv_z",
+      "pv_xError",
+      "pv_yError",
+      "pv_zError",
+      "pv_chi2",
+      "pv_ndof",
+      "pv_pt2sum",
+      "pv_nTracks",
+      //[[[end]]]
+    };
+  }
+
+  class ColumnReader {
+  public:
+    ColumnReader();
+    ~ColumnReader();
+
+    // Request column by branch name, a trailing '*' requests all columns with that prefix
+    void Request(const std::string& name);
+    void Request(col::Id id) { requested_.set(id); }
+    bool Requested(col::Id id) const { return requested_.test(id); }
+    // Disable all branches of tree, enable and set addresses of requested columns
+    void Attach(TTree* tree);
+
+    // Generated by cog
+    // Do NOT edit until "end"
+    //[[[cog
+    //import cog
+    //import vars_EmJetAnalyzer as mod; mod.gen_ColumnMembers()
+    //]]]
+    int                     run                 ;
+    int                     lumi                ;
+    int                     event               ;
+    int                     bx                  ;
+    int                     nVtx                ;
+    int                     nGoodVtx            ;
+    int                     nTrueInt            ;
+    float                   met_pt              ;
+    float                   met_phi             ;
+    int                     nTracks             ;
+    float                   alpha_event         ;
+    int                     pdf_id1             ;
+    int                     pdf_id2             ;
+    float                   pdf_x1              ;
+    float                   pdf_x2              ;
+    float                   pdf_pdf1            ;
+    float                   pdf_pdf2            ;
+    float                   pdf_scalePDF        ;
+    bool                    HLT_PFHT400         ;
+    bool                    HLT_PFHT475         ;
+    bool                    HLT_PFHT600         ;
+    bool                    HLT_PFHT800         ;
+    bool                    HLT_PFHT900         ;
+    bool                    HLT_HT250           ;
+    bool                    HLT_HT350           ;
+    bool                    HLT_HT400           ;
+    bool                    HLT_HT500           ;
+    int                     HLT_bits            ;
+    int                     budgetFlags         ;
+    vector<int>*            jet_index               ;
+    vector<int>*            jet_source              ;
+    vector<float>*          jet_ptRaw               ;
+    vector<float>*          jet_eta                 ;
+    vector<float>*          jet_phi                 ;
+    vector<float>*          jet_pt                  ;
+    vector<float>*          jet_ptUp                ;
+    vector<float>*          jet_ptDown              ;
+    vector<float>*          jet_csv                 ;
+    vector<float>*          jet_cef                 ;
+    vector<float>*          jet_nef                 ;
+    vector<float>*          jet_chf                 ;
+    vector<float>*          jet_nhf                 ;
+    vector<float>*          jet_pef                 ;
+    vector<float>*          jet_mef                 ;
+    vector<int>*            jet_missHits            ;
+    vector<int>*            jet_muonHits            ;
+    vector<float>*          jet_alpha               ;
+    vector<float>*          jet_alpha2              ;
+    vector<float>*          jet_alphaMax            ;
+    vector<float>*          jet_alphaMax2           ;
+    vector<float>*          jet_alpha_gen           ;
+    vector<float>*          jet_alphaMax_dz100nm    ;
+    vector<float>*          jet_alphaMax_dz200nm    ;
+    vector<float>*          jet_alphaMax_dz500nm    ;
+    vector<float>*          jet_alphaMax_dz1um      ;
+    vector<float>*          jet_alphaMax_dz2um      ;
+    vector<float>*          jet_alphaMax_dz5um      ;
+    vector<float>*          jet_alphaMax_dz10um     ;
+    vector<float>*          jet_alphaMax_dz20um     ;
+    vector<float>*          jet_alphaMax_dz50um     ;
+    vector<float>*          jet_alphaMax_dz100um    ;
+    vector<float>*          jet_alphaMax_dz200um    ;
+    vector<float>*          jet_alphaMax_dz500um    ;
+    vector<float>*          jet_alphaMax_dz1mm      ;
+    vector<float>*          jet_alphaMax_dz2mm      ;
+    vector<float>*          jet_alphaMax_dz5mm      ;
+    vector<float>*          jet_alphaMax_dz1cm      ;
+    vector<float>*          jet_alphaMax_dz2cm      ;
+    vector<float>*          jet_alphaMax_dz5cm      ;
+    vector<float>*          jet_alphaMax_dz10cm     ;
+    vector<float>*          jet_alphaMax_dz20cm     ;
+    vector<float>*          jet_alphaMax_dz50cm     ;
+    vector<float>*          jet_alphaMax2_dz100nm   ;
+    vector<float>*          jet_alphaMax2_dz200nm   ;
+    vector<float>*          jet_alphaMax2_dz500nm   ;
+    vector<float>*          jet_alphaMax2_dz1um     ;
+    vector<float>*          jet_alphaMax2_dz2um     ;
+    vector<float>*          jet_alphaMax2_dz5um     ;
+    vector<float>*          jet_alphaMax2_dz10um    ;
+    vector<float>*          jet_alphaMax2_dz20um    ;
+    vector<float>*          jet_alphaMax2_dz50um    ;
+    vector<float>*          jet_alphaMax2_dz100um   ;
+    vector<float>*          jet_alphaMax2_dz200um   ;
+    vector<float>*          jet_alphaMax2_dz500um   ;
+    vector<float>*          jet_alphaMax2_dz1mm     ;
+    vector<float>*          jet_alphaMax2_dz2mm     ;
+    vector<float>*          jet_alphaMax2_dz5mm     ;
+    vector<float>*          jet_alphaMax2_dz1cm     ;
+    vector<float>*          jet_alphaMax2_dz2cm     ;
+    vector<float>*          jet_alphaMax2_dz5cm     ;
+    vector<float>*          jet_alphaMax2_dz10cm    ;
+    vector<float>*          jet_alphaMax2_dz20cm    ;
+    vector<float>*          jet_alphaMax2_dz50cm    ;
+    vector<int>*            jet_nDarkPions          ;
+    vector<int>*            jet_nDarkGluons         ;
+    vector<float>*          jet_minDRDarkPion       ;
+    vector<float>*          jet_theta2D             ;
+    vector<vector<int> >*   track_index               ;
+    vector<vector<int> >*   track_source              ;
+    vector<vector<int> >*   track_jet_index           ;
+    vector<vector<int> >*   track_vertex_index        ;
+    vector<vector<float> >* track_vertex_weight       ;
+    vector<vector<int> >*   track_nHitsInFrontOfVert  ;
+    vector<vector<int> >*   track_missHitsAfterVert   ;
+    vector<vector<float> >* track_pt                  ;
+    vector<vector<float> >* track_eta                 ;
+    vector<vector<float> >* track_phi                 ;
+    vector<vector<float> >* track_ref_x               ;
+    vector<vector<float> >* track_ref_y               ;
+    vector<vector<float> >* track_ref_z               ;
+    vector<vector<float> >* track_d0Error             ;
+    vector<vector<float> >* track_dzError             ;
+    vector<vector<float> >* track_pca_r               ;
+    vector<vector<float> >* track_pca_eta             ;
+    vector<vector<float> >* track_pca_phi             ;
+    vector<vector<float> >* track_innerHit_r          ;
+    vector<vector<float> >* track_innerHit_eta        ;
+    vector<vector<float> >* track_innerHit_phi        ;
+    vector<vector<int> >*   track_quality             ;
+    vector<vector<int> >*   track_algo                ;
+    vector<vector<int> >*   track_originalAlgo        ;
+    vector<vector<int> >*   track_nHits               ;
+    vector<vector<int> >*   track_nMissInnerHits      ;
+    vector<vector<int> >*   track_nTrkLayers          ;
+    vector<vector<int> >*   track_nMissInnerTrkLayers ;
+    vector<vector<int> >*   track_nMissOuterTrkLayers ;
+    vector<vector<int> >*   track_nMissTrkLayers      ;
+    vector<vector<int> >*   track_nPxlLayers          ;
+    vector<vector<int> >*   track_nMissInnerPxlLayers ;
+    vector<vector<int> >*   track_nMissOuterPxlLayers ;
+    vector<vector<int> >*   track_nMissPxlLayers      ;
+    vector<vector<float> >* track_ipXY                ;
+    vector<vector<float> >* track_ipZ                 ;
+    vector<vector<float> >* track_ipXYSig             ;
+    vector<vector<float> >* track_ip3D                ;
+    vector<vector<float> >* track_ip3DSig             ;
+    vector<vector<float> >* track_dRToJetAxis         ;
+    vector<vector<float> >* track_distanceToJet       ;
+    vector<vector<float> >* track_minVertexDz         ;
+    vector<vector<float> >* track_pvWeight            ;
+    vector<vector<float> >* track_minGenDistance      ;
+    vector<vector<int> >*   vertex_index               ;
+    vector<vector<int> >*   vertex_source              ;
+    vector<vector<int> >*   vertex_jet_index           ;
+    vector<vector<float> >* vertex_x                   ;
+    vector<vector<float> >* vertex_y                   ;
+    vector<vector<float> >* vertex_z                   ;
+    vector<vector<float> >* vertex_xError              ;
+    vector<vector<float> >* vertex_yError              ;
+    vector<vector<float> >* vertex_zError              ;
+    vector<vector<float> >* vertex_deltaR              ;
+    vector<vector<float> >* vertex_Lxy                 ;
+    vector<vector<float> >* vertex_mass                ;
+    vector<vector<float> >* vertex_chi2                ;
+    vector<vector<float> >* vertex_ndof                ;
+    vector<vector<float> >* vertex_pt2sum              ;
+    vector<int>*            gp_index               ;
+    vector<int>*            gp_status              ;
+    vector<int>*            gp_pdgId               ;
+    vector<int>*            gp_charge              ;
+    vector<float>*          gp_mass                ;
+    vector<float>*          gp_pt                  ;
+    vector<float>*          gp_eta                 ;
+    vector<float>*          gp_phi                 ;
+    vector<float>*          gp_vx                  ;
+    vector<float>*          gp_vy                  ;
+    vector<float>*          gp_vz                  ;
+    vector<float>*          gp_min2Ddist           ;
+    vector<float>*          gp_min2Dsig            ;
+    vector<float>*          gp_min3Ddist           ;
+    vector<float>*          gp_min3Dsig            ;
+    vector<float>*          gp_minDeltaR           ;
+    vector<float>*          gp_matched2Ddist       ;
+    vector<float>*          gp_matched2Dsig        ;
+    vector<float>*          gp_matched3Ddist       ;
+    vector<float>*          gp_matched3Dsig        ;
+    vector<float>*          gp_matchedDeltaR       ;
+    vector<float>*          gp_Lxy                 ;
+    vector<int>*            gp_isDark              ;
+    vector<int>*            gp_nDaughters          ;
+    vector<int>*            gp_hasSMDaughter       ;
+    vector<int>*            gp_hasDarkMother       ;
+    vector<int>*            gp_hasDarkPionMother   ;
+    vector<int>*            gp_isTrackable         ;
+    vector<int>*            pv_index               ;
+    vector<float>*          pv_x                   ;
+    vector<float>*          pv_y                   ;
+    vector<float>*          pv_z                   ;
+    vector<float>*          pv_xError              ;
+    vector<float>*          pv_yError              ;
+    vector<float>*          pv_zError              ;
+    vector<float>*          pv_chi2                ;
+    vector<float>*          pv_ndof                ;
+    vector<float>*          pv_pt2sum              ;
+    vector<int>*            pv_nTracks             ;
+    //[[[end]]]
+
+  private:
+    ColumnReader(const ColumnReader&) = delete;
+    ColumnReader& operator=(const ColumnReader&) = delete;
+    template <class T> void AttachBranch(TTree* tree, const char* name, T* address);
+
+    std::bitset<col::NCOLUMNS> requested_;
+  };
+}
+
+inline
+emjet::ColumnReader::ColumnReader() {
+  // Generated by cog
+  // Do NOT edit until "end"
+  //[[[cog
+  //import cog
+  //import vars_EmJetAnalyzer as mod; mod.gen_ColumnInit()
+  //]]]
+  run                 = 0;
+  lumi                = 0;
+  event               = 0;
+  bx                  = 0;
+  nVtx                = 0;
+  nGoodVtx            = 0;
+  nTrueInt            = 0;
+  met_pt              = 0;
+  met_phi             = 0;
+  nTracks             = 0;
+  alpha_event         = 0;
+  pdf_id1             = 0;
+  pdf_id2             = 0;
+  pdf_x1              = 0;
+  pdf_x2              = 0;
+  pdf_pdf1            = 0;
+  pdf_pdf2            = 0;
+  pdf_scalePDF        = 0;
+  HLT_PFHT400         = 0;
+  HLT_PFHT475         = 0;
+  HLT_PFHT600         = 0;
+  HLT_PFHT800         = 0;
+  HLT_PFHT900         = 0;
+  HLT_HT250           = 0;
+  HLT_HT350           = 0;
+  HLT_HT400           = 0;
+  HLT_HT500           = 0;
+  HLT_bits            = 0;
+  budgetFlags         = 0;
+  jet_index               = 0;
+  jet_source              = 0;
+  jet_ptRaw               = 0;
+  jet_eta                 = 0;
+  jet_phi                 = 0;
+  jet_pt                  = 0;
+  jet_ptUp                = 0;
+  jet_ptDown              = 0;
+  jet_csv                 = 0;
+  jet_cef                 = 0;
+  jet_nef                 = 0;
+  jet_chf                 = 0;
+  jet_nhf                 = 0;
+  jet_pef                 = 0;
+  jet_mef                 = 0;
+  jet_missHits            = 0;
+  jet_muonHits            = 0;
+  jet_alpha               = 0;
+  jet_alpha2              = 0;
+  jet_alphaMax            = 0;
+  jet_alphaMax2           = 0;
+  jet_alpha_gen           = 0;
+  jet_alphaMax_dz100nm    = 0;
+  jet_alphaMax_dz200nm    = 0;
+  jet_alphaMax_dz500nm    = 0;
+  jet_alphaMax_dz1um      = 0;
+  jet_alphaMax_dz2um      = 0;
+  jet_alphaMax_dz5um      = 0;
+  jet_alphaMax_dz10um     = 0;
+  jet_alphaMax_dz20um     = 0;
+  jet_alphaMax_dz50um     = 0;
+  jet_alphaMax_dz100um    = 0;
+  jet_alphaMax_dz200um    = 0;
+  jet_alphaMax_dz500um    = 0;
+  jet_alphaMax_dz1mm      = 0;
+  jet_alphaMax_dz2mm      = 0;
+  jet_alphaMax_dz5mm      = 0;
+  jet_alphaMax_dz1cm      = 0;
+  jet_alphaMax_dz2cm      = 0;
+  jet_alphaMax_dz5cm      = 0;
+  jet_alphaMax_dz10cm     = 0;
+  jet_alphaMax_dz20cm     = 0;
+  jet_alphaMax_dz50cm     = 0;
+  jet_alphaMax2_dz100nm   = 0;
+  jet_alphaMax2_dz200nm   = 0;
+  jet_alphaMax2_dz500nm   = 0;
+  jet_alphaMax2_dz1um     = 0;
+  jet_alphaMax2_dz2um     = 0;
+  jet_alphaMax2_dz5um     = 0;
+  jet_alphaMax2_dz10um    = 0;
+  jet_alphaMax2_dz20um    = 0;
+  jet_alphaMax2_dz50um    = 0;
+  jet_alphaMax2_dz100um   = 0;
+  jet_alphaMax2_dz200um   = 0;
+  jet_alphaMax2_dz500um   = 0;
+  jet_alphaMax2_dz1mm     = 0;
+  jet_alphaMax2_dz2mm     = 0;
+  jet_alphaMax2_dz5mm     = 0;
+  jet_alphaMax2_dz1cm     = 0;
+  jet_alphaMax2_dz2cm     = 0;
+  jet_alphaMax2_dz5cm     = 0;
+  jet_alphaMax2_dz10cm    = 0;
+  jet_alphaMax2_dz20cm    = 0;
+  jet_alphaMax2_dz50cm    = 0;
+  jet_nDarkPions          = 0;
+  jet_nDarkGluons         = 0;
+  jet_minDRDarkPion       = 0;
+  jet_theta2D             = 0;
+  track_index               = 0;
+  track_source              = 0;
+  track_jet_index           = 0;
+  track_vertex_index        = 0;
+  track_vertex_weight       = 0;
+  track_nHitsInFrontOfVert  = 0;
+  track_missHitsAfterVert   = 0;
+  track_pt                  = 0;
+  track_eta                 = 0;
+  track_phi                 = 0;
+  track_ref_x               = 0;
+  track_ref_y               = 0;
+  track_ref_z               = 0;
+  track_d0Error             = 0;
+  track_dzError             = 0;
+  track_pca_r               = 0;
+  track_pca_eta             = 0;
+  track_pca_phi             = 0;
+  track_innerHit_r          = 0;
+  track_innerHit_eta        = 0;
+  track_innerHit_phi        = 0;
+  track_quality             = 0;
+  track_algo                = 0;
+  track_originalAlgo        = 0;
+  track_nHits               = 0;
+  track_nMissInnerHits      = 0;
+  track_nTrkLayers          = 0;
+  track_nMissInnerTrkLayers = 0;
+  track_nMissOuterTrkLayers = 0;
+  track_nMissTrkLayers      = 0;
+  track_nPxlLayers          = 0;
+  track_nMissInnerPxlLayers = 0;
+  track_nMissOuterPxlLayers = 0;
+  track_nMissPxlLayers      = 0;
+  track_ipXY                = 0;
+  track_ipZ                 = 0;
+  track_ipXYSig             = 0;
+  track_ip3D                = 0;
+  track_ip3DSig             = 0;
+  track_dRToJetAxis         = 0;
+  track_distanceToJet       = 0;
+  track_minVertexDz         = 0;
+  track_pvWeight            = 0;
+  track_minGenDistance      = 0;
+  vertex_index               = 0;
+  vertex_source              = 0;
+  vertex_jet_index           = 0;
+  vertex_x                   = 0;
+  vertex_y                   = 0;
+  vertex_z                   = 0;
+  vertex_xError              = 0;
+  vertex_yError              = 0;
+  vertex_zError              = 0;
+  vertex_deltaR              = 0;
+  vertex_Lxy                 = 0;
+  vertex_mass                = 0;
+  vertex_chi2                = 0;
+  vertex_ndof                = 0;
+  vertex_pt2sum              = 0;
+  gp_index               = 0;
+  gp_status              = 0;
+  gp_pdgId               = 0;
+  gp_charge              = 0;
+  gp_mass                = 0;
+  gp_pt                  = 0;
+  gp_eta                 = 0;
+  gp_phi                 = 0;
+  gp_vx                  = 0;
+  gp_vy                  = 0;
+  gp_vz                  = 0;
+  gp_min2Ddist           = 0;
+  gp_min2Dsig            = 0;
+  gp_min3Ddist           = 0;
+  gp_min3Dsig            = 0;
+  gp_minDeltaR           = 0;
+  gp_matched2Ddist       = 0;
+  gp_matched2Dsig        = 0;
+  gp_matched3Ddist       = 0;
+  gp_matched3Dsig        = 0;
+  gp_matchedDeltaR       = 0;
+  gp_Lxy                 = 0;
+  gp_isDark              = 0;
+  gp_nDaughters          = 0;
+  gp_hasSMDaughter       = 0;
+  gp_hasDarkMother       = 0;
+  gp_hasDarkPionMother   = 0;
+  gp_isTrackable         = 0;
+  pv_index               = 0;
+  pv_x                   = 0;
+  pv_y                   = 0;
+  pv_z                   = 0;
+  pv_xError              = 0;
+  pv_yError              = 0;
+  pv_zError              = 0;
+  pv_chi2                = 0;
+  pv_ndof                = 0;
+  pv_pt2sum              = 0;
+  pv_nTracks             = 0;
+  //[[[end]]]
+}
+
+inline
+emjet::ColumnReader::~ColumnReader() {
+  // Generated by cog
+  // Do NOT edit until "end"
+  //[[[cog
+  //import cog
+  //import vars_EmJetAnalyzer as mod; mod.gen_ColumnDelete()
+  //]]]
+  delete jet_index               ;
+  delete jet_source              ;
+  delete jet_ptRaw               ;
+  delete jet_eta                 ;
+  delete jet_phi                 ;
+  delete jet_pt                  ;
+  delete jet_ptUp                ;
+  delete jet_ptDown              ;
+  delete jet_csv                 ;
+  delete jet_cef                 ;
+  delete jet_nef                 ;
+  delete jet_chf                 ;
+  delete jet_nhf                 ;
+  delete jet_pef                 ;
+  delete jet_mef                 ;
+  delete jet_missHits            ;
+  delete jet_muonHits            ;
+  delete jet_alpha               ;
+  delete jet_alpha2              ;
+  delete jet_alphaMax            ;
+  delete jet_alphaMax2           ;
+  delete jet_alpha_gen           ;
+  delete jet_alphaMax_dz100nm    ;
+  delete jet_alphaMax_dz200nm    ;
+  delete jet_alphaMax_dz500nm    ;
+  delete jet_alphaMax_dz1um      ;
+  delete jet_alphaMax_dz2um      ;
+  delete jet_alphaMax_dz5um      ;
+  delete jet_alphaMax_dz10um     ;
+  delete jet_alphaMax_dz20um     ;
+  delete jet_alphaMax_dz50um     ;
+  delete jet_alphaMax_dz100um    ;
+  delete jet_alphaMax_dz200um    ;
+  delete jet_alphaMax_dz500um    ;
+  delete jet_alphaMax_dz1mm      ;
+  delete jet_alphaMax_dz2mm      ;
+  delete jet_alphaMax_dz5mm      ;
+  delete jet_alphaMax_dz1cm      ;
+  delete jet_alphaMax_dz2cm      ;
+  delete jet_alphaMax_dz5cm      ;
+  delete jet_alphaMax_dz10cm     ;
+  delete jet_alphaMax_dz20cm     ;
+  delete jet_alphaMax_dz50cm     ;
+  delete jet_alphaMax2_dz100nm   ;
+  delete jet_alphaMax2_dz200nm   ;
+  delete jet_alphaMax2_dz500nm   ;
+  delete jet_alphaMax2_dz1um     ;
+  delete jet_alphaMax2_dz2um     ;
+  delete jet_alphaMax2_dz5um     ;
+  delete jet_alphaMax2_dz10um    ;
+  delete jet_alphaMax2_dz20um    ;
+  delete jet_alphaMax2_dz50um    ;
+  delete jet_alphaMax2_dz100um   ;
+  delete jet_alphaMax2_dz200um   ;
+  delete jet_alphaMax2_dz500um   ;
+  delete jet_alphaMax2_dz1mm     ;
+  delete jet_alphaMax2_dz2mm     ;
+  delete jet_alphaMax2_dz5mm     ;
+  delete jet_alphaMax2_dz1cm     ;
+  delete jet_alphaMax2_dz2cm     ;
+  delete jet_alphaMax2_dz5cm     ;
+  delete jet_alphaMax2_dz10cm    ;
+  delete jet_alphaMax2_dz20cm    ;
+  delete jet_alphaMax2_dz50cm    ;
+  delete jet_nDarkPions          ;
+  delete jet_nDarkGluons         ;
+  delete jet_minDRDarkPion       ;
+  delete jet_theta2D             ;
+  delete track_index               ;
+  delete track_source              ;
+  delete track_jet_index           ;
+  delete track_vertex_index        ;
+  delete track_vertex_weight       ;
+  delete track_nHitsInFrontOfVert  ;
+  delete track_missHitsAfterVert   ;
+  delete track_pt                  ;
+  delete track_eta                 ;
+  delete track_phi                 ;
+  delete track_ref_x               ;
+  delete track_ref_y               ;
+  delete track_ref_z               ;
+  delete track_d0Error             ;
+  delete track_dzError             ;
+  delete track_pca_r               ;
+  delete track_pca_eta             ;
+  delete track_pca_phi             ;
+  delete track_innerHit_r          ;
+  delete track_innerHit_eta        ;
+  delete track_innerHit_phi        ;
+  delete track_quality             ;
+  delete track_algo                ;
+  delete track_originalAlgo        ;
+  delete track_nHits               ;
+  delete track_nMissInnerHits      ;
+  delete track_nTrkLayers          ;
+  delete track_nMissInnerTrkLayers ;
+  delete track_nMissOuterTrkLayers ;
+  delete track_nMissTrkLayers      ;
+  delete track_nPxlLayers          ;
+  delete track_nMissInnerPxlLayers ;
+  delete track_nMissOuterPxlLayers ;
+  delete track_nMissPxlLayers      ;
+  delete track_ipXY                ;
+  delete track_ipZ                 ;
+  delete track_ipXYSig             ;
+  delete track_ip3D                ;
+  delete track_ip3DSig             ;
+  delete track_dRToJetAxis         ;
+  delete track_distanceToJet       ;
+  delete track_minVertexDz         ;
+  delete track_pvWeight            ;
+  delete track_minGenDistance      ;
+  delete vertex_index               ;
+  delete vertex_source              ;
+  delete vertex_jet_index           ;
+  delete vertex_x                   ;
+  delete vertex_y                   ;
+  delete vertex_z                   ;
+  delete vertex_xError              ;
+  delete vertex_yError              ;
+  delete vertex_zError              ;
+  delete vertex_deltaR              ;
+  delete vertex_Lxy                 ;
+  delete vertex_mass                ;
+  delete vertex_chi2                ;
+  delete vertex_ndof                ;
+  delete vertex_pt2sum              ;
+  delete gp_index               ;
+  delete gp_status              ;
+  delete gp_pdgId               ;
+  delete gp_charge              ;
+  delete gp_mass                ;
+  delete gp_pt                  ;
+  delete gp_eta                 ;
+  delete gp_phi                 ;
+  delete gp_vx                  ;
+  delete gp_vy                  ;
+  delete gp_vz                  ;
+  delete gp_min2Ddist           ;
+  delete gp_min2Dsig            ;
+  delete gp_min3Ddist           ;
+  delete gp_min3Dsig            ;
+  delete gp_minDeltaR           ;
+  delete gp_matched2Ddist       ;
+  delete gp_matched2Dsig        ;
+  delete gp_matched3Ddist       ;
+  delete gp_matched3Dsig        ;
+  delete gp_matchedDeltaR       ;
+  delete gp_Lxy                 ;
+  delete gp_isDark              ;
+  delete gp_nDaughters          ;
+  delete gp_hasSMDaughter       ;
+  delete gp_hasDarkMother       ;
+  delete gp_hasDarkPionMother   ;
+  delete gp_isTrackable         ;
+  delete pv_index               ;
+  delete pv_x                   ;
+  delete pv_y                   ;
+  delete pv_z                   ;
+  delete pv_xError              ;
+  delete pv_yError              ;
+  delete pv_zError              ;
+  delete pv_chi2                ;
+  delete pv_ndof                ;
+  delete pv_pt2sum              ;
+  delete pv_nTracks             ;
+  //[[[end]]]
+}
+
+inline void
+emjet::ColumnReader::Request(const std::string& name) {
+  bool prefix = !name.empty() && name[name.size()-1] == '*';
+  std::string match = prefix ? name.substr(0, name.size()-1) : name;
+  bool found = false;
+  for (int i = 0; i < col::NCOLUMNS; i++) {
+    std::string column = col::names[i];
+    if ( prefix ? column.compare(0, match.size(), match) == 0 : column == match ) {
+      requested_.set(i);
+      found = true;
+    }
+  }
+  if (!found) throw std::runtime_error("ColumnReader: unknown column " + name);
+}
+
+template <class T>
+inline void
+emjet::ColumnReader::AttachBranch(TTree* tree, const char* name, T* address) {
+  if (!tree->GetBranch(name)) throw std::runtime_error(std::string("ColumnReader: tree has no branch ") + name);
+  tree->SetBranchStatus(name, 1);
+  tree->SetBranchAddress(name, address);
+}
+
+inline void
+emjet::ColumnReader::Attach(TTree* tree) {
+  tree->SetBranchStatus("*", 0);
+#define ATTACH(tree, column) if (requested_.test(col::column)) AttachBranch(tree, #column, &column);
+  // Generated by cog
+  // Do NOT edit until "end"
+  //[[[cog
+  //import cog
+  //import vars_EmJetAnalyzer as mod; mod.gen_ColumnAttach()
+  //]]]
+  ATTACH(tree, run                 );
+  ATTACH(tree, lumi                );
+  ATTACH(tree, event               );
+  ATTACH(tree, bx                  );
+  ATTACH(tree, nVtx                );
+  ATTACH(tree, nGoodVtx            );
+  ATTACH(tree, nTrueInt            );
+  ATTACH(tree, met_pt              );
+  ATTACH(tree, met_phi             );
+  ATTACH(tree, nTracks             );
+  ATTACH(tree, alpha_event         );
+  ATTACH(tree, pdf_id1             );
+  ATTACH(tree, pdf_id2             );
+  ATTACH(tree, pdf_x1              );
+  ATTACH(tree, pdf_x2              );
+  ATTACH(tree, pdf_pdf1            );
+  ATTACH(tree, pdf_pdf2            );
+  ATTACH(tree, pdf_scalePDF        );
+  ATTACH(tree, HLT_PFHT400         );
+  ATTACH(tree, HLT_PFHT475         );
+  ATTACH(tree, HLT_PFHT600         );
+  ATTACH(tree, HLT_PFHT800         );
+  ATTACH(tree, HLT_PFHT900         );
+  ATTACH(tree, HLT_HT250           );
+  ATTACH(tree, HLT_HT350           );
+  ATTACH(tree, HLT_HT400           );
+  ATTACH(tree, HLT_HT500           );
+  ATTACH(tree, HLT_bits            );
+  ATTACH(tree, budgetFlags         );
+  ATTACH(tree, jet_index               );
+  ATTACH(tree, jet_source              );
+  ATTACH(tree, jet_ptRaw               );
+  ATTACH(tree, jet_eta                 );
+  ATTACH(tree, jet_phi                 );
+  ATTACH(tree, jet_pt                  );
+  ATTACH(tree, jet_ptUp                );
+  ATTACH(tree, jet_ptDown              );
+  ATTACH(tree, jet_csv                 );
+  ATTACH(tree, jet_cef                 );
+  ATTACH(tree, jet_nef                 );
+  ATTACH(tree, jet_chf                 );
+  ATTACH(tree, jet_nhf                 );
+  ATTACH(tree, jet_pef                 );
+  ATTACH(tree, jet_mef                 );
+  ATTACH(tree, jet_missHits            );
+  ATTACH(tree, jet_muonHits            );
+  ATTACH(tree, jet_alpha               );
+  ATTACH(tree, jet_alpha2              );
+  ATTACH(tree, jet_alphaMax            );
+  ATTACH(tree, jet_alphaMax2           );
+  ATTACH(tree, jet_alpha_gen           );
+  ATTACH(tree, jet_alphaMax_dz100nm    );
+  ATTACH(tree, jet_alphaMax_dz200nm    );
+  ATTACH(tree, jet_alphaMax_dz500nm    );
+  ATTACH(tree, jet_alphaMax_dz1um      );
+  ATTACH(tree, jet_alphaMax_dz2um      );
+  ATTACH(tree, jet_alphaMax_dz5um      );
+  ATTACH(tree, jet_alphaMax_dz10um     );
+  ATTACH(tree, jet_alphaMax_dz20um     );
+  ATTACH(tree, jet_alphaMax_dz50um     );
+  ATTACH(tree, jet_alphaMax_dz100um    );
+  ATTACH(tree, jet_alphaMax_dz200um    );
+  ATTACH(tree, jet_alphaMax_dz500um    );
+  ATTACH(tree, jet_alphaMax_dz1mm      );
+  ATTACH(tree, jet_alphaMax_dz2mm      );
+  ATTACH(tree, jet_alphaMax_dz5mm      );
+  ATTACH(tree, jet_alphaMax_dz1cm      );
+  ATTACH(tree, jet_alphaMax_dz2cm      );
+  ATTACH(tree, jet_alphaMax_dz5cm      );
+  ATTACH(tree, jet_alphaMax_dz10cm     );
+  ATTACH(tree, jet_alphaMax_dz20cm     );
+  ATTACH(tree, jet_alphaMax_dz50cm     );
+  ATTACH(tree, jet_alphaMax2_dz100nm   );
+  ATTACH(tree, jet_alphaMax2_dz200nm   );
+  ATTACH(tree, jet_alphaMax2_dz500nm   );
+  ATTACH(tree, jet_alphaMax2_dz1um     );
+  ATTACH(tree, jet_alphaMax2_dz2um     );
+  ATTACH(tree, jet_alphaMax2_dz5um     );
+  ATTACH(tree, jet_alphaMax2_dz10um    );
+  ATTACH(tree, jet_alphaMax2_dz20um    );
+  ATTACH(tree, jet_alphaMax2_dz50um    );
+  ATTACH(tree, jet_alphaMax2_dz100um   );
+  ATTACH(tree, jet_alphaMax2_dz200um   );
+  ATTACH(tree, jet_alphaMax2_dz500um   );
+  ATTACH(tree, jet_alphaMax2_dz1mm     );
+  ATTACH(tree, jet_alphaMax2_dz2mm     );
+  ATTACH(tree, jet_alphaMax2_dz5mm     );
+  ATTACH(tree, jet_alphaMax2_dz1cm     );
+  ATTACH(tree, jet_alphaMax2_dz2cm     );
+  ATTACH(tree, jet_alphaMax2_dz5cm     );
+  ATTACH(tree, jet_alphaMax2_dz10cm    );
+  ATTACH(tree, jet_alphaMax2_dz20cm    );
+  ATTACH(tree, jet_alphaMax2_dz50cm    );
+  ATTACH(tree, jet_nDarkPions          );
+  ATTACH(tree, jet_nDarkGluons         );
+  ATTACH(tree, jet_minDRDarkPion       );
+  ATTACH(tree, jet_theta2D             );
+  ATTACH(tree, track_index               );
+  ATTACH(tree, track_source              );
+  ATTACH(tree, track_jet_index           );
+  ATTACH(tree, track_vertex_index        );
+  ATTACH(tree, track_vertex_weight       );
+  ATTACH(tree, track_nHitsInFrontOfVert  );
+  ATTACH(tree, track_missHitsAfterVert   );
+  ATTACH(tree, track_pt                  );
+  ATTACH(tree, track_eta                 );
+  ATTACH(tree, track_phi                 );
+  ATTACH(tree, track_ref_x               );
+  ATTACH(tree, track_ref_y               );
+  ATTACH(tree, track_ref_z               );
+  ATTACH(tree, track_d0Error             );
+  ATTACH(tree, track_dzError             );
+  ATTACH(tree, track_pca_r               );
+  ATTACH(tree, track_pca_eta             );
+  ATTACH(tree, track_pca_phi             );
+  ATTACH(tree, track_innerHit_r          );
+  ATTACH(tree, track_innerHit_eta        );
+  ATTACH(tree, track_innerHit_phi        );
+  ATTACH(tree, track_quality             );
+  ATTACH(tree, track_algo                );
+  ATTACH(tree, track_originalAlgo        );
+  ATTACH(tree, track_nHits               );
+  ATTACH(tree, track_nMissInnerHits      );
+  ATTACH(tree, track_nTrkLayers          );
+  ATTACH(tree, track_nMissInnerTrkLayers );
+  ATTACH(tree, track_nMissOuterTrkLayers );
+  ATTACH(tree, track_nMissTrkLayers      );
+  ATTACH(tree, track_nPxlLayers          );
+  ATTACH(tree, track_nMissInnerPxlLayers );
+  ATTACH(tree, track_nMissOuterPxlLayers );
+  ATTACH(tree, track_nMissPxlLayers      );
+  ATTACH(tree, track_ipXY                );
+  ATTACH(tree, track_ipZ                 );
+  ATTACH(tree, track_ipXYSig             );
+  ATTACH(tree, track_ip3D                );
+  ATTACH(tree, track_ip3DSig             );
+  ATTACH(tree, track_dRToJetAxis         );
+  ATTACH(tree, track_distanceToJet       );
+  ATTACH(tree, track_minVertexDz         );
+  ATTACH(tree, track_pvWeight            );
+  ATTACH(tree, track_minGenDistance      );
+  ATTACH(tree, vertex_index               );
+  ATTACH(tree, vertex_source              );
+  ATTACH(tree, vertex_jet_index           );
+  ATTACH(tree, vertex_x                   );
+  ATTACH(tree, vertex_y                   );
+  ATTACH(tree, vertex_z                   );
+  ATTACH(tree, vertex_xError              );
+  ATTACH(tree, vertex_yError              );
+  ATTACH(tree, vertex_zError              );
+  ATTACH(tree, vertex_deltaR              );
+  ATTACH(tree, vertex_Lxy                 );
+  ATTACH(tree, vertex_mass                );
+  ATTACH(tree, vertex_chi2                );
+  ATTACH(tree, vertex_ndof                );
+  ATTACH(tree, vertex_pt2sum              );
+  ATTACH(tree, gp_index               );
+  ATTACH(tree, gp_status              );
+  ATTACH(tree, gp_pdgId               );
+  ATTACH(tree, gp_charge              );
+  ATTACH(tree, gp_mass                );
+  ATTACH(tree, gp_pt                  );
+  ATTACH(tree, gp_eta                 );
+  ATTACH(tree, gp_phi                 );
+  ATTACH(tree, gp_vx                  );
+  ATTACH(tree, gp_vy                  );
+  ATTACH(tree, gp_vz                  );
+  ATTACH(tree, gp_min2Ddist           );
+  ATTACH(tree, gp_min2Dsig            );
+  ATTACH(tree, gp_min3Ddist           );
+  ATTACH(tree, gp_min3Dsig            );
+  ATTACH(tree, gp_minDeltaR           );
+  ATTACH(tree, gp_matched2Ddist       );
+  ATTACH(tree, gp_matched2Dsig        );
+  ATTACH(tree, gp_matched3Ddist       );
+  ATTACH(tree, gp_matched3Dsig        );
+  ATTACH(tree, gp_matchedDeltaR       );
+  ATTACH(tree, gp_Lxy                 );
+  ATTACH(tree, gp_isDark              );
+  ATTACH(tree, gp_nDaughters          );
+  ATTACH(tree, gp_hasSMDaughter       );
+  ATTACH(tree, gp_hasDarkMother       );
+  ATTACH(tree, gp_hasDarkPionMother   );
+  ATTACH(tree, gp_isTrackable         );
+  ATTACH(tree, pv_index               );
+  ATTACH(tree, pv_x                   );
+  ATTACH(tree, pv_y                   );
+  ATTACH(tree, pv_z                   );
+  ATTACH(tree, pv_xError              );
+  ATTACH(tree, pv_yError              );
+  ATTACH(tree, pv_zError              );
+  ATTACH(tree, pv_chi2                );
+  ATTACH(tree, pv_ndof                );
+  ATTACH(tree, pv_pt2sum              );
+  ATTACH(tree, pv_nTracks             );
+  //[[[end]]]
+#undef ATTACH
+}
+
+#endif
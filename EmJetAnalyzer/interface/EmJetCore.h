@@ -0,0 +1,191 @@
+#ifndef EmergingJetAnalysis_EmJetAnalyzer_EmJetCore_h
+#define EmergingJetAnalysis_EmJetAnalyzer_EmJetCore_h
+
+// Framework-independent selection and computation kernels
+// Shared by EmJetAnalyzer (on reco objects) and emjetReplay (on ReplaySnapshot objects), so that both run
+// the same code. Only depends on the standard library and Utils/interface/Kinematics.h.
+// Objects are accessed through template parameters or accessor functors:
+//   pt(track)             : scalar track pt
+//   associated(track)     : true if track is associated to the vertex under consideration
+//   associated(vtx, track): true if track is associated to vtx
+// Column kernels work on one event of an EmJetColumns reader, jet columns indexed by [jet], track columns by
+// [jet][track], and fill one output value per jet.
+
+#include <vector>
+#include <tuple>
+#include <cmath>
+#include <algorithm>
+
+#include "EmergingJetAnalysis/Utils/interface/Kinematics.h"
+
+namespace emjet
+{
+  // Basic track selection
+  inline bool selectTrack(double pt, int qualityMask) {
+    // Skip tracks with pt<1 :CUT:
+    if (pt < 1.) return false;
+    // Skip tracks failing "high purity" selection
+    bool isHighPurity = (qualityMask & 4) > 0;
+    if (!isHighPurity) return false;
+    return true;
+  }
+
+  // Track to jet association by track momentum direction
+  inline bool selectJetTrackDeltaR(double trackEta, double trackPhi, double jetEta, double jetPhi) {
+    // Skip tracks with deltaR > 0.4 w.r.t. current jet :CUT:
+    float dR = kin::deltaR(trackEta, trackPhi, jetEta, jetPhi);
+    if (dR > 0.4) return false;
+    return true;
+  }
+
+  // Fraction of scalar track pt-sum associated to a vertex
+  template <class Tracks, class Pt, class Assoc>
+  double computeAlpha(const Tracks& tracks, Pt pt, Assoc associated)
+  {
+    double jet_pt_sum = 0.;
+    double vertex_pt_sum = 0.; // scalar pt contribution of vertex to jet
+    for (const auto& track : tracks) {
+      jet_pt_sum += pt(track);
+      if ( associated(track) ) vertex_pt_sum += pt(track);
+    }
+    return vertex_pt_sum / jet_pt_sum;
+  }
+
+  // Largest fraction of scalar track pt-sum associated to any one of vertices
+  template <class Tracks, class Vertices, class Pt, class Assoc>
+  double computeAlphaMax(const Tracks& tracks, const Vertices& vertices, Pt pt, Assoc associated)
+  {
+    // Loop over all tracks and calculate scalar pt-sum of all tracks in current jet
+    double jet_pt_sum = 0.;
+    for (const auto& track : tracks) jet_pt_sum += pt(track);
+    // Loop over all PVs and choose the one with highest scalar pt contribution to jet
+    double max_vertex_pt_sum = 0.;
+    for (const auto& vtx : vertices) {
+      double vertex_pt_sum = 0.; // scalar pt contribution of vertex to jet
+      for (const auto& track : tracks) {
+        if ( associated(vtx, track) ) vertex_pt_sum += pt(track);
+      }
+      if (vertex_pt_sum > max_vertex_pt_sum) max_vertex_pt_sum = vertex_pt_sum;
+    }
+    return max_vertex_pt_sum / jet_pt_sum;
+  }
+
+  // Fraction of pt-sum of charged stable gen particles within deltaR < 0.4 of jet that come from a prompt vertex
+  // T must provide status(), charge(), pt(), eta(), phi(), vx(), vy()
+  template <class GenParticles>
+  double computeAlphaGen(const GenParticles& genParticles, double jetEta, double jetPhi)
+  {
+    double prompt_sum = 0.;
+    double total_sum  = 0.;
+    for (const auto& gp : genParticles) {
+      if ( (gp.status()==1) && (gp.charge()!=0) ) {
+        if (kin::deltaR(jetEta, jetPhi, double(gp.eta()), double(gp.phi())) > 0.4) continue;
+        if (gp.pt() < 1.0) continue;
+        total_sum += gp.pt();
+        double vr = std::sqrt( gp.vx()*gp.vx() + gp.vy()*gp.vy() );
+        if (vr > 0.1) continue;
+        prompt_sum += gp.pt();
+      }
+    }
+    return prompt_sum/total_sum;
+  }
+
+  // Median of input, mean of the two central values for even size, -1 if empty
+  // Same definition as EmJetAnalyzer::get_median. Reorders input.
+  template <class T>
+  double median(std::vector<T>& input)
+  {
+    unsigned size = input.size();
+    if (size==0) return -1.;
+    auto middle = input.begin() + size/2;
+    std::nth_element(input.begin(), middle, input.end());
+    if ( size % 2 == 1 ) return *middle;
+    return ( *std::max_element(input.begin(), middle) + *middle ) / 2.;
+  }
+
+  // pass[ijet] &= cut(column[ijet]), pass is resized to the number of jets and initialized to true if empty
+  template <class T, class Cut>
+  void selectJets(const std::vector<T>& column, Cut cut, std::vector<char>& pass)
+  {
+    if (pass.empty()) pass.assign(column.size(), 1);
+    for (unsigned ijet = 0; ijet < column.size(); ijet++) pass[ijet] = pass[ijet] && cut(column[ijet]);
+  }
+
+  // Jets with 0 <= alphaMax < maxAlphaMax, negative alphaMax means no tracks :CUT:
+  inline void selectAlphaMax(const std::vector<float>& alphaMax, double maxAlphaMax, std::vector<char>& pass)
+  {
+    selectJets(alphaMax, [maxAlphaMax](float a) { return a >= 0. && a < maxAlphaMax; }, pass);
+  }
+
+  // Number of tracks of given source per jet passing selectTrack
+  inline void countTracks(const std::vector< std::vector<int> >& source, int selectedSource,
+                          const std::vector< std::vector<float> >& pt, const std::vector< std::vector<int> >& quality,
+                          std::vector<int>& nTracks)
+  {
+    nTracks.assign(source.size(), 0);
+    for (unsigned ijet = 0; ijet < source.size(); ijet++) {
+      for (unsigned itk = 0; itk < source[ijet].size(); itk++) {
+        if ( source[ijet][itk]==selectedSource && selectTrack(pt[ijet][itk], quality[ijet][itk]) ) nTracks[ijet]++;
+      }
+    }
+  }
+
+  // Median of track column over tracks of given source per jet passing selectTrack, -1 for jets without tracks
+  template <class T>
+  void medianTrackColumn(const std::vector< std::vector<T> >& column, const std::vector< std::vector<int> >& source,
+                         int selectedSource, const std::vector< std::vector<float> >& pt,
+                         const std::vector< std::vector<int> >& quality, std::vector<float>& medians)
+  {
+    std::vector<T> values; // Reused for all jets
+    medians.resize(column.size());
+    for (unsigned ijet = 0; ijet < column.size(); ijet++) {
+      values.clear();
+      for (unsigned itk = 0; itk < column[ijet].size(); itk++) {
+        if ( source[ijet][itk]==selectedSource && selectTrack(pt[ijet][itk], quality[ijet][itk]) ) values.push_back(column[ijet][itk]);
+      }
+      medians[ijet] = median(values);
+    }
+  }
+}
+
+// :VERTEXTESTING:
+// Distance from each gen vertex to closest reco vertex, and vice versa
+// G and T must provide position().x()/y()/z()
+template <class G, class T>
+std::tuple< std::vector<double>, std::vector<double>, std::vector<double>, std::vector<double>  >
+computeMinVertexDistance(const std::vector<G>* vertexVector_gen, const std::vector<T>* vertexVector_reco)
+{
+  std::vector<double> GenToReco, GenToReco2D, RecoToGen, RecoToGen2D;
+  for (const auto& vtx_gen: *vertexVector_gen) {
+    double minDistance = 999, minDistance2D = 999;
+    for (const auto& vtx_reco: *vertexVector_reco) {
+      double x = vtx_reco.position().x() - vtx_gen.position().x();
+      double y = vtx_reco.position().y() - vtx_gen.position().y();
+      double z = vtx_reco.position().z() - vtx_gen.position().z();
+      double distance2D = std::sqrt(x*x + y*y);
+      double distance = std::sqrt(x*x + y*y + z*z);
+      if (distance < minDistance) minDistance = distance;
+      if (distance2D < minDistance2D) minDistance2D = distance2D;
+    }
+    GenToReco.push_back(minDistance);
+    GenToReco2D.push_back(minDistance2D);
+  }
+  for (const auto& vtx_reco: *vertexVector_reco) {
+    double minDistance = 999, minDistance2D = 999;
+    for (const auto& vtx_gen: *vertexVector_gen) {
+      double x = vtx_reco.position().x() - vtx_gen.position().x();
+      double y = vtx_reco.position().y() - vtx_gen.position().y();
+      double z = vtx_reco.position().z() - vtx_gen.position().z();
+      double distance2D = std::sqrt(x*x + y*y);
+      double distance = std::sqrt(x*x + y*y + z*z);
+      if (distance < minDistance) minDistance = distance;
+      if (distance2D < minDistance2D) minDistance2D = distance2D;
+    }
+    RecoToGen.push_back(minDistance);
+    RecoToGen2D.push_back(minDistance2D);
+  }
+  // Return std::tuple
+  return std::make_tuple(GenToReco, GenToReco2D, RecoToGen, RecoToGen2D);
+}
+
+#endif
@@ -67,6 +67,8 @@ namespace emjet
       HLT_HT350            = DEFAULTVALUE;
       HLT_HT400            = DEFAULTVALUE;
       HLT_HT500            = DEFAULTVALUE;
+      HLT_bits             = DEFAULTVALUE;
+      budgetFlags          = DEFAULTVALUE;
       //[[[end]]]
 
       jet_vector.clear();
@@ -105,6 +107,8 @@ namespace emjet
     bool   HLT_HT350           ;
     bool   HLT_HT400           ;
     bool   HLT_HT500           ;
+    int    HLT_bits            ;
+    int    budgetFlags         ;
     //[[[end]]]
 
     vector<Jet> jet_vector;
@@ -642,6 +646,8 @@ WriteEventToOutput(const Event& event, emjet::OutputTree* otree)
     otree->HLT_HT350            = event.HLT_HT350           ;
     otree->HLT_HT400            = event.HLT_HT400           ;
     otree->HLT_HT500            = event.HLT_HT500           ;
+    otree->HLT_bits             = event.HLT_bits            ;
+    otree->budgetFlags          = event.budgetFlags         ;
     //[[[end]]]
   }
   // Jet-level variables, e.g. vector<int>, vector<float>, etc.
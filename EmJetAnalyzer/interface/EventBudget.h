@@ -0,0 +1,158 @@
+#ifndef EmergingJetAnalysis_EmJetAnalyzer_EventBudget_h
+#define EmergingJetAnalysis_EmJetAnalyzer_EventBudget_h
+
+// Per-event processing budget for EmJetAnalyzer
+// Guards against pathological events (very high pileup, thousands of tracks) where global AVR and
+// per-jet vertexing take too long. When a cap is hit, the event is processed in degraded mode:
+//   - tracks fed to vertexing are truncated to the highest-pt maxTracks* tracks
+//   - once an event-level cap is hit (global track cap or stage time), per-jet vertexing is only run for the
+//     degradedMaxJets leading jets in pt; the per-jet track cap only truncates the tracks of that jet
+// Stage times are checked after each stage (vertexing calls cannot be interrupted).
+// The flags of each event are stored in Event::budgetFlags, and counted for the job summary.
+// All limits default to 0 (disabled), so an empty (or missing) budget PSet never degrades events.
+//
+// budget PSet (untracked, all optional):
+//   maxTracksGlobalVertexing : uint32, cap on tracks passed to global AVR
+//   maxTracksJetVertexing    : uint32, cap on tracks passed to per-jet vertexing, per jet
+//   maxStageSeconds          : double, real time budget per stage
+//   degradedMaxJets          : int, number of leading jets vertexed in degraded mode (default 2)
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iostream>
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "TrackingTools/TransientTrack/interface/TransientTrack.h"
+#include "TStopwatch.h"
+
+namespace emjet
+{
+  class EventBudget {
+  public:
+    enum Flag {
+      kGlobalTrackCap   = 1<<0, // Tracks for global AVR truncated
+      kJetTrackCap      = 1<<1, // Tracks for per-jet vertexing truncated (any jet)
+      kStageTime        = 1<<2, // A stage exceeded maxStageSeconds
+      kJetVertexingSkip = 1<<3, // Per-jet vertexing skipped for jets beyond degradedMaxJets
+    };
+    static const int NFLAGS = 4;
+    static const int kEventFlags = kGlobalTrackCap | kStageTime; // Flags that limit per-jet vertexing
+
+    explicit EventBudget(const edm::ParameterSet& pset) :
+      maxTracksGlobal_ ( pset.getUntrackedParameter<unsigned> ( "maxTracksGlobalVertexing" , 0  ) ) ,
+      maxTracksJet_    ( pset.getUntrackedParameter<unsigned> ( "maxTracksJetVertexing"    , 0  ) ) ,
+      maxStageSeconds_ ( pset.getUntrackedParameter<double>   ( "maxStageSeconds"          , 0. ) ) ,
+      degradedMaxJets_ ( pset.getUntrackedParameter<int>      ( "degradedMaxJets"          , 2  ) ) ,
+      flags_(0), nEvents_(0), nDegraded_(0), flagCounts_(NFLAGS, 0)
+    {}
+
+    // Call at start of event processing, and after event processing to update counters
+    void startEvent() { flags_ = 0; }
+    void endEvent();
+    // Calls startEvent() on construction and endEvent() on destruction, so that every return path is counted
+    class EventScope {
+    public:
+      explicit EventScope(EventBudget& budget) : budget_(budget) { budget_.startEvent(); }
+      ~EventScope() { budget_.endEvent(); }
+      EventScope(const EventScope&) = delete;
+      EventScope& operator=(const EventScope&) = delete;
+    private:
+      EventBudget& budget_;
+    };
+
+    // Stage timing
+    void startStage() { timer_.Start(true); }
+    // Return true (and flag event) if current stage exceeded time budget
+    bool checkStage();
+
+    // Truncate tracks to highest-pt maxTracks*, and flag event if truncated
+    void capGlobalTracks(std::vector<reco::TransientTrack>& tracks) { capTracks(tracks, maxTracksGlobal_, kGlobalTrackCap); }
+    void capJetTracks(std::vector<reco::TransientTrack>& tracks) { capTracks(tracks, maxTracksJet_, kJetTrackCap); }
+
+    // Rank jets by pt (0 for leading jet), call before vertexJet() for each event
+    // Jets need not be sorted, Jets is a collection of objects with pt()
+    template <class Jets>
+    void rankJets(const Jets& jets);
+    // Return true if per-jet vertexing should be run for the ijet-th jet of rankJets(), flag event otherwise
+    bool vertexJet(int ijet) {
+      if ( !(flags_ & kEventFlags) || jetRank_[ijet] < degradedMaxJets_ ) return true;
+      flags_ |= kJetVertexingSkip;
+      return false;
+    }
+
+    bool degraded() const { return flags_ != 0; }
+    int flags() const { return flags_; }
+
+    void printSummary(std::ostream& os) const;
+
+  private:
+    void capTracks(std::vector<reco::TransientTrack>& tracks, unsigned maxTracks, Flag flag);
+
+    unsigned maxTracksGlobal_;
+    unsigned maxTracksJet_;
+    double maxStageSeconds_;
+    int degradedMaxJets_;
+
+    TStopwatch timer_;
+    int flags_; // Flags of current event
+    std::vector<int> jetRank_; // Pt rank of each jet of current event
+    // Job counters
+    unsigned long nEvents_;
+    unsigned long nDegraded_;
+    std::vector<unsigned long> flagCounts_;
+  };
+}
+
+template <class Jets>
+void
+emjet::EventBudget::rankJets(const Jets& jets)
+{
+  std::vector<int> order(jets.size());
+  for (unsigned i = 0; i < order.size(); i++) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&jets](int i, int j){ return jets[i].pt() > jets[j].pt(); });
+  jetRank_.resize(order.size());
+  for (unsigned rank = 0; rank < order.size(); rank++) jetRank_[order[rank]] = rank;
+}
+
+inline void
+emjet::EventBudget::endEvent()
+{
+  nEvents_++;
+  if ( degraded() ) nDegraded_++;
+  for (int i = 0; i < NFLAGS; i++) {
+    if ( (flags_ >> i) & 1 ) flagCounts_[i]++;
+  }
+}
+
+inline bool
+emjet::EventBudget::checkStage()
+{
+  if ( maxStageSeconds_ <= 0. ) return false;
+  timer_.Stop();
+  if ( timer_.RealTime() <= maxStageSeconds_ ) { timer_.Continue(); return false; }
+  flags_ |= kStageTime;
+  return true;
+}
+
+inline void
+emjet::EventBudget::capTracks(std::vector<reco::TransientTrack>& tracks, unsigned maxTracks, Flag flag)
+{
+  if ( maxTracks == 0 || tracks.size() <= maxTracks ) return;
+  std::partial_sort(tracks.begin(), tracks.begin()+maxTracks, tracks.end(),
+                    [](const reco::TransientTrack& a, const reco::TransientTrack& b){ return a.track().pt() > b.track().pt(); });
+  tracks.resize(maxTracks);
+  flags_ |= flag;
+}
+
+inline void
+emjet::EventBudget::printSummary(std::ostream& os) const
+{
+  static const char* names[NFLAGS] = {"globalTrackCap", "jetTrackCap", "stageTime", "jetVertexingSkip"};
+  os << "EventBudget summary: " << nDegraded_ << " of " << nEvents_ << " events processed in degraded mode\n";
+  for (int i = 0; i < NFLAGS; i++) {
+    os << "  " << names[i] << ": " << flagCounts_[i] << "\n";
+  }
+}
+
+#endif
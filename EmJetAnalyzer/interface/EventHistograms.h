@@ -0,0 +1,356 @@
+#ifndef EmergingJetAnalysis_EmJetAnalyzer_EventHistograms_h
+#define EmergingJetAnalysis_EmJetAnalyzer_EventHistograms_h
+
+// Histograms of ntuple variables filled directly from emjet::Event
+// Used by EmJetAnalyzer in histogram mode, where no TTree is written.
+// Variables are referred to by their OutputTree branch name (e.g. "nVtx", "jet_alphaMax", "vertex_Lxy"),
+// and the histogram is filled once per object of that level (event, jet, track, vertex, gen particle, PV).
+// Cuts may use variables of the same level, of the event, or of the parent jet for track/vertex histograms.
+// The accessor table is generated by cog from cogFiles/vars_EmJetAnalyzer.py.
+//
+// histograms VPSet, each entry:
+//   name, var             : string
+//   nbins, low, high      : int32, double, double
+//   cuts (untracked)      : VPSet of (var, min, max), object passes if min <= var < max for all cuts
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/EmJetEvent.h"
+#include "EmergingJetAnalysis/Utils/interface/HistogramRegistry.h"
+
+namespace emjet
+{
+  enum VarLevel { kEventLevel, kJetLevel, kTrackLevel, kVertexLevel, kGenParticleLevel, kPrimaryVertexLevel };
+
+  // Objects a variable is read from, pointers below the level being filled are null
+  struct VarContext {
+    const Event* event;
+    const Jet* jet;
+    const Track* track;
+    const Vertex* vertex;
+    const GenParticle* genparticle;
+    const PrimaryVertex* pv;
+  };
+
+  struct VarAccessor {
+    VarLevel level;
+    double (*get)(const VarContext&);
+  };
+
+  // Accessors for all ntuple variables, by branch name
+  inline const std::map<std::string, VarAccessor>& varAccessorTable() {
+    static const std::map<std::string, VarAccessor> table = {
+      //[[[cog
+      //import vars_EmJetAnalyzer as m
+      //for vardict in m.event_vardicts      : m.replaceSingleLine('{ "$branchname", { kEventLevel        , [](const VarContext& c) -> double { return c.event->$name; } } },', vardict)
+      //for vardict in m.jet_vardicts        : m.replaceSingleLine('{ "$branchname", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->$name; } } },', vardict)
+      //for vardict in m.jet_track_vardicts  : m.replaceSingleLine('{ "$branchname", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->$name; } } },', vardict)
+      //for vardict in m.jet_vertex_vardicts : m.replaceSingleLine('{ "$branchname", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->$name; } } },', vardict)
+      //for vardict in m.genparticle_vardicts: m.replaceSingleLine('{ "$branchname", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->$name; } } },', vardict)
+      //for vardict in m.pv_vardicts         : m.replaceSingleLine('{ "$branchname", { kPrimaryVertexLevel, [](const VarContext& c) -> double { return c.pv->$name; } } },', vardict)
+      //]]]
+      { "run", { kEventLevel        , [](const VarContext& c) -> double { return c.event->run                 ; } } },
+      { "lumi", { kEventLevel        , [](const VarContext& c) -> double { return c.event->lumi                ; } } },
+      { "event", { kEventLevel        , [](const VarContext& c) -> double { return c.event->event               ; } } },
+      { "bx", { kEventLevel        , [](const VarContext& c) -> double { return c.event->bx                  ; } } },
+      { "nVtx", { kEventLevel        , [](const VarContext& c) -> double { return c.event->nVtx                ; } } },
+      { "nGoodVtx", { kEventLevel        , [](const VarContext& c) -> double { return c.event->nGoodVtx            ; } } },
+      { "nTrueInt", { kEventLevel        , [](const VarContext& c) -> double { return c.event->nTrueInt            ; } } },
+      { "met_pt", { kEventLevel        , [](const VarContext& c) -> double { return c.event->met_pt              ; } } },
+      { "met_phi", { kEventLevel        , [](const VarContext& c) -> double { return c.event->met_phi             ; } } },
+      { "nTracks", { kEventLevel        , [](const VarContext& c) -> double { return c.event->nTracks             ; } } },
+      { "alpha_event", { kEventLevel        , [](const VarContext& c) -> double { return c.event->alpha_event         ; } } },
+      { "pdf_id1", { kEventLevel        , [](const VarContext& c) -> double { return c.event->pdf_id1             ; } } },
+      { "pdf_id2", { kEventLevel        , [](const VarContext& c) -> double { return c.event->pdf_id2             ; } } },
+      { "pdf_x1", { kEventLevel        , [](const VarContext& c) -> double { return c.event->pdf_x1              ; } } },
+      { "pdf_x2", { kEventLevel        , [](const VarContext& c) -> double { return c.event->pdf_x2              ; } } },
+      { "pdf_pdf1", { kEventLevel        , [](const VarContext& c) -> double { return c.event->pdf_pdf1            ; } } },
+      { "pdf_pdf2", { kEventLevel        , [](const VarContext& c) -> double { return c.event->pdf_pdf2            ; } } },
+      { "pdf_scalePDF", { kEventLevel        , [](const VarContext& c) -> double { return c.event->pdf_scalePDF        ; } } },
+      { "HLT_PFHT400", { kEventLevel        , [](const VarContext& c) -> double { return c.event->HLT_PFHT400         ; } } },
+      { "HLT_PFHT475", { kEventLevel        , [](const VarContext& c) -> double { return c.event->HLT_PFHT475         ; } } },
+      { "HLT_PFHT600", { kEventLevel        , [](const VarContext& c) -> double { return c.event->HLT_PFHT600         ; } } },
+      { "HLT_PFHT800", { kEventLevel        , [](const VarContext& c) -> double { return c.event->HLT_PFHT800         ; } } },
+      { "HLT_PFHT900", { kEventLevel        , [](const VarContext& c) -> double { return c.event->HLT_PFHT900         ; } } },
+      { "HLT_HT250", { kEventLevel        , [](const VarContext& c) -> double { return c.event->HLT_HT250           ; } } },
+      { "HLT_HT350", { kEventLevel        , [](const VarContext& c) -> double { return c.event->HLT_HT350           ; } } },
+      { "HLT_HT400", { kEventLevel        , [](const VarContext& c) -> double { return c.event->HLT_HT400           ; } } },
+      { "HLT_HT500", { kEventLevel        , [](const VarContext& c) -> double { return c.event->HLT_HT500           ; } } },
+      { "HLT_bits", { kEventLevel        , [](const VarContext& c) -> double { return c.event->HLT_bits            ; } } },
+      { "budgetFlags", { kEventLevel        , [](const VarContext& c) -> double { return c.event->budgetFlags         ; } } },
+      { "jet_index", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->index               ; } } },
+      { "jet_source", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->source              ; } } },
+      { "jet_ptRaw", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->ptRaw               ; } } },
+      { "jet_eta", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->eta                 ; } } },
+      { "jet_phi", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->phi                 ; } } },
+      { "jet_pt", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->pt                  ; } } },
+      { "jet_ptUp", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->ptUp                ; } } },
+      { "jet_ptDown", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->ptDown              ; } } },
+      { "jet_csv", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->csv                 ; } } },
+      { "jet_cef", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->cef                 ; } } },
+      { "jet_nef", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->nef                 ; } } },
+      { "jet_chf", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->chf                 ; } } },
+      { "jet_nhf", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->nhf                 ; } } },
+      { "jet_pef", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->pef                 ; } } },
+      { "jet_mef", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->mef                 ; } } },
+      { "jet_missHits", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->missHits            ; } } },
+      { "jet_muonHits", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->muonHits            ; } } },
+      { "jet_alpha", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alpha               ; } } },
+      { "jet_alpha2", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alpha2              ; } } },
+      { "jet_alphaMax", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax            ; } } },
+      { "jet_alphaMax2", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2           ; } } },
+      { "jet_alpha_gen", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alpha_gen           ; } } },
+      { "jet_alphaMax_dz100nm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz100nm    ; } } },
+      { "jet_alphaMax_dz200nm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz200nm    ; } } },
+      { "jet_alphaMax_dz500nm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz500nm    ; } } },
+      { "jet_alphaMax_dz1um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz1um      ; } } },
+      { "jet_alphaMax_dz2um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz2um      ; } } },
+      { "jet_alphaMax_dz5um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz5um      ; } } },
+      { "jet_alphaMax_dz10um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz10um     ; } } },
+      { "jet_alphaMax_dz20um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz20um     ; } } },
+      { "jet_alphaMax_dz50um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz50um     ; } } },
+      { "jet_alphaMax_dz100um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz100um    ; } } },
+      { "jet_alphaMax_dz200um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz200um    ; } } },
+      { "jet_alphaMax_dz500um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz500um    ; } } },
+      { "jet_alphaMax_dz1mm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz1mm      ; } } },
+      { "jet_alphaMax_dz2mm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz2mm      ; } } },
+      { "jet_alphaMax_dz5mm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz5mm      ; } } },
+      { "jet_alphaMax_dz1cm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz1cm      ; } } },
+      { "jet_alphaMax_dz2cm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz2cm      ; } } },
+      { "jet_alphaMax_dz5cm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz5cm      ; } } },
+      { "jet_alphaMax_dz10cm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz10cm     ; } } },
+      { "jet_alphaMax_dz20cm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz20cm     ; } } },
+      { "jet_alphaMax_dz50cm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax_dz50cm     ; } } },
+      { "jet_alphaMax2_dz100nm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz100nm   ; } } },
+      { "jet_alphaMax2_dz200nm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz200nm   ; } } },
+      { "jet_alphaMax2_dz500nm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz500nm   ; } } },
+      { "jet_alphaMax2_dz1um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz1um     ; } } },
+      { "jet_alphaMax2_dz2um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz2um     ; } } },
+      { "jet_alphaMax2_dz5um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz5um     ; } } },
+      { "jet_alphaMax2_dz10um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz10um    ; } } },
+      { "jet_alphaMax2_dz20um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz20um    ; } } },
+      { "jet_alphaMax2_dz50um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz50um    ; } } },
+      { "jet_alphaMax2_dz100um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz100um   ; } } },
+      { "jet_alphaMax2_dz200um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz200um   ; } } },
+      { "jet_alphaMax2_dz500um", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz500um   ; } } },
+      { "jet_alphaMax2_dz1mm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz1mm     ; } } },
+      { "jet_alphaMax2_dz2mm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz2mm     ; } } },
+      { "jet_alphaMax2_dz5mm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz5mm     ; } } },
+      { "jet_alphaMax2_dz1cm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz1cm     ; } } },
+      { "jet_alphaMax2_dz2cm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz2cm     ; } } },
+      { "jet_alphaMax2_dz5cm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz5cm     ; } } },
+      { "jet_alphaMax2_dz10cm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz10cm    ; } } },
+      { "jet_alphaMax2_dz20cm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz20cm    ; } } },
+      { "jet_alphaMax2_dz50cm", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->alphaMax2_dz50cm    ; } } },
+      { "jet_nDarkPions", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->nDarkPions          ; } } },
+      { "jet_nDarkGluons", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->nDarkGluons         ; } } },
+      { "jet_minDRDarkPion", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->minDRDarkPion       ; } } },
+      { "jet_theta2D", { kJetLevel          , [](const VarContext& c) -> double { return c.jet->theta2D             ; } } },
+      { "track_index", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->index               ; } } },
+      { "track_source", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->source              ; } } },
+      { "track_jet_index", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->jet_index           ; } } },
+      { "track_vertex_index", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->vertex_index        ; } } },
+      { "track_vertex_weight", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->vertex_weight       ; } } },
+      { "track_nHitsInFrontOfVert", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->nHitsInFrontOfVert  ; } } },
+      { "track_missHitsAfterVert", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->missHitsAfterVert   ; } } },
+      { "track_pt", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->pt                  ; } } },
+      { "track_eta", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->eta                 ; } } },
+      { "track_phi", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->phi                 ; } } },
+      { "track_ref_x", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->ref_x               ; } } },
+      { "track_ref_y", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->ref_y               ; } } },
+      { "track_ref_z", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->ref_z               ; } } },
+      { "track_d0Error", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->d0Error             ; } } },
+      { "track_dzError", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->dzError             ; } } },
+      { "track_pca_r", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->pca_r               ; } } },
+      { "track_pca_eta", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->pca_eta             ; } } },
+      { "track_pca_phi", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->pca_phi             ; } } },
+      { "track_innerHit_r", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->innerHit_r          ; } } },
+      { "track_innerHit_eta", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->innerHit_eta        ; } } },
+      { "track_innerHit_phi", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->innerHit_phi        ; } } },
+      { "track_quality", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->quality             ; } } },
+      { "track_algo", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->algo                ; } } },
+      { "track_originalAlgo", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->originalAlgo        ; } } },
+      { "track_nHits", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->nHits               ; } } },
+      { "track_nMissInnerHits", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->nMissInnerHits      ; } } },
+      { "track_nTrkLayers", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->nTrkLayers          ; } } },
+      { "track_nMissInnerTrkLayers", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->nMissInnerTrkLayers ; } } },
+      { "track_nMissOuterTrkLayers", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->nMissOuterTrkLayers ; } } },
+      { "track_nMissTrkLayers", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->nMissTrkLayers      ; } } },
+      { "track_nPxlLayers", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->nPxlLayers          ; } } },
+      { "track_nMissInnerPxlLayers", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->nMissInnerPxlLayers ; } } },
+      { "track_nMissOuterPxlLayers", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->nMissOuterPxlLayers ; } } },
+      { "track_nMissPxlLayers", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->nMissPxlLayers      ; } } },
+      { "track_ipXY", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->ipXY                ; } } },
+      { "track_ipZ", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->ipZ                 ; } } },
+      { "track_ipXYSig", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->ipXYSig             ; } } },
+      { "track_ip3D", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->ip3D                ; } } },
+      { "track_ip3DSig", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->ip3DSig             ; } } },
+      { "track_dRToJetAxis", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->dRToJetAxis         ; } } },
+      { "track_distanceToJet", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->distanceToJet       ; } } },
+      { "track_minVertexDz", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->minVertexDz         ; } } },
+      { "track_pvWeight", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->pvWeight            ; } } },
+      { "track_minGenDistance", { kTrackLevel        , [](const VarContext& c) -> double { return c.track->minGenDistance      ; } } },
+      { "vertex_index", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->index               ; } } },
+      { "vertex_source", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->source              ; } } },
+      { "vertex_jet_index", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->jet_index           ; } } },
+      { "vertex_x", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->x                   ; } } },
+      { "vertex_y", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->y                   ; } } },
+      { "vertex_z", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->z                   ; } } },
+      { "vertex_xError", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->xError              ; } } },
+      { "vertex_yError", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->yError              ; } } },
+      { "vertex_zError", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->zError              ; } } },
+      { "vertex_deltaR", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->deltaR              ; } } },
+      { "vertex_Lxy", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->Lxy                 ; } } },
+      { "vertex_mass", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->mass                ; } } },
+      { "vertex_chi2", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->chi2                ; } } },
+      { "vertex_ndof", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->ndof                ; } } },
+      { "vertex_pt2sum", { kVertexLevel       , [](const VarContext& c) -> double { return c.vertex->pt2sum              ; } } },
+      { "gp_index", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->index               ; } } },
+      { "gp_status", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->status              ; } } },
+      { "gp_pdgId", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->pdgId               ; } } },
+      { "gp_charge", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->charge              ; } } },
+      { "gp_mass", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->mass                ; } } },
+      { "gp_pt", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->pt                  ; } } },
+      { "gp_eta", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->eta                 ; } } },
+      { "gp_phi", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->phi                 ; } } },
+      { "gp_vx", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->vx                  ; } } },
+      { "gp_vy", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->vy                  ; } } },
+      { "gp_vz", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->vz                  ; } } },
+      { "gp_min2Ddist", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->min2Ddist           ; } } },
+      { "gp_min2Dsig", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->min2Dsig            ; } } },
+      { "gp_min3Ddist", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->min3Ddist           ; } } },
+      { "gp_min3Dsig", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->min3Dsig            ; } } },
+      { "gp_minDeltaR", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->minDeltaR           ; } } },
+      { "gp_matched2Ddist", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->matched2Ddist       ; } } },
+      { "gp_matched2Dsig", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->matched2Dsig        ; } } },
+      { "gp_matched3Ddist", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->matched3Ddist       ; } } },
+      { "gp_matched3Dsig", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->matched3Dsig        ; } } },
+      { "gp_matchedDeltaR", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->matchedDeltaR       ; } } },
+      { "gp_Lxy", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->Lxy                 ; } } },
+      { "gp_isDark", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->isDark              ; } } },
+      { "gp_nDaughters", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->nDaughters          ; } } },
+      { "gp_hasSMDaughter", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->hasSMDaughter       ; } } },
+      { "gp_hasDarkMother", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->hasDarkMother       ; } } },
+      { "gp_hasDarkPionMother", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->hasDarkPionMother   ; } } },
+      { "gp_isTrackable", { kGenParticleLevel  , [](const VarContext& c) -> double { return c.genparticle->isTrackable         ; } } },
+      { "pv_index", { kPrimaryVertexLevel, [](const VarContext& c) -> double { return c.pv->index               ; } } },
+      { "pv_x", { kPrimaryVertexLevel, [](const VarContext& c) -> double { return c.pv->x                   ; } } },
+      { "pv_y", { kPrimaryVertexLevel, [](const VarContext& c) -> double { return c.pv->y                   ; } } },
+      { "pv_z", { kPrimaryVertexLevel, [](const VarContext& c) -> double { return c.pv->z                   ; } } },
+      { "pv_xError", { kPrimaryVertexLevel, [](const VarContext& c) -> double { return c.pv->xError              ; } } },
+      { "pv_yError", { kPrimaryVertexLevel, [](const VarContext& c) -> double { return c.pv->yError              ; } } },
+      { "pv_zError", { kPrimaryVertexLevel, [](const VarContext& c) -> double { return c.pv->zError              ; } } },
+      { "pv_chi2", { kPrimaryVertexLevel, [](const VarContext& c) -> double { return c.pv->chi2                ; } } },
+      { "pv_ndof", { kPrimaryVertexLevel, [](const VarContext& c) -> double { return c.pv->ndof                ; } } },
+      { "pv_pt2sum", { kPrimaryVertexLevel, [](const VarContext& c) -> double { return c.pv->pt2sum              ; } } },
+      { "pv_nTracks", { kPrimaryVertexLevel, [](const VarContext& c) -> double { return c.pv->nTracks             ; } } },
+      //[[[end]]]
+    };
+    return table;
+  }
+
+  class EventHistograms {
+  public:
+    EventHistograms() : histos_(nullptr) {}
+
+    // Book all histograms in histos
+    void book(const std::vector<edm::ParameterSet>& psets, HistogramRegistry& histos);
+    void fill(const Event& event) const;
+    bool empty() const { return specs_.empty(); }
+    // Return true if any histogram or cut uses variables of given level
+    bool usesLevel(VarLevel level) const {
+      for (const auto& spec : specs_) {
+        if (spec.var.level == level) return true;
+        for (const auto& cut : spec.cuts) if (cut.var.level == level) return true;
+      }
+      return false;
+    }
+
+  private:
+    struct Cut {
+      VarAccessor var;
+      double min, max;
+    };
+    struct Spec {
+      HistogramRegistry::H1 hist;
+      VarAccessor var;
+      std::vector<Cut> cuts;
+    };
+    static VarAccessor findVar(const std::string& name) {
+      auto it = varAccessorTable().find(name);
+      if (it == varAccessorTable().end()) throw cms::Exception("Configuration") << "EventHistograms: unknown variable " << name;
+      return it->second;
+    }
+    void fillObject(const Spec& spec, const VarContext& c) const {
+      for (const auto& cut : spec.cuts) {
+        double value = cut.var.get(c);
+        if ( !(value >= cut.min && value < cut.max) ) return;
+      }
+      histos_->fill(spec.hist, spec.var.get(c));
+    }
+
+    HistogramRegistry* histos_;
+    std::vector<Spec> specs_;
+  };
+}
+
+inline void
+emjet::EventHistograms::book(const std::vector<edm::ParameterSet>& psets, HistogramRegistry& histos)
+{
+  histos_ = &histos;
+  for (const auto& pset : psets) {
+    Spec spec;
+    std::string name = pset.getParameter<std::string>("name");
+    spec.var = findVar(pset.getParameter<std::string>("var"));
+    for (const auto& cutPSet : pset.getUntrackedParameter< std::vector<edm::ParameterSet> >("cuts", std::vector<edm::ParameterSet>())) {
+      Cut cut = { findVar(cutPSet.getParameter<std::string>("var")), cutPSet.getParameter<double>("min"), cutPSet.getParameter<double>("max") };
+      bool parentJet = cut.var.level == kJetLevel && (spec.var.level == kTrackLevel || spec.var.level == kVertexLevel);
+      if ( cut.var.level != kEventLevel && cut.var.level != spec.var.level && !parentJet ) {
+        throw cms::Exception("Configuration") << "EventHistograms: cut on " << cutPSet.getParameter<std::string>("var") << " can not be applied to histogram " << name;
+      }
+      spec.cuts.push_back(cut);
+    }
+    spec.hist = histos.book1D<TH1F>(name, name, pset.getParameter<int>("nbins"), pset.getParameter<double>("low"), pset.getParameter<double>("high"));
+    specs_.push_back(spec);
+  }
+}
+
+inline void
+emjet::EventHistograms::fill(const Event& event) const
+{
+  for (const auto& spec : specs_) {
+    VarContext c = { &event, nullptr, nullptr, nullptr, nullptr, nullptr };
+    switch (spec.var.level) {
+    case kEventLevel:
+      fillObject(spec, c);
+      break;
+    case kJetLevel:
+      for (const auto& jet : event.jet_vector) { c.jet = &jet; fillObject(spec, c); }
+      break;
+    case kTrackLevel:
+      for (const auto& jet : event.jet_vector) {
+        c.jet = &jet;
+        for (const auto& track : jet.track_vector) { c.track = &track; fillObject(spec, c); }
+      }
+      break;
+    case kVertexLevel:
+      for (const auto& jet : event.jet_vector) {
+        c.jet = &jet;
+        for (const auto& vertex : jet.vertex_vector) { c.vertex = &vertex; fillObject(spec, c); }
+      }
+      break;
+    case kGenParticleLevel:
+      for (const auto& gp : event.genparticle_vector) { c.genparticle = &gp; fillObject(spec, c); }
+      break;
+    case kPrimaryVertexLevel:
+      for (const auto& pv : event.pv_vector) { c.pv = &pv; fillObject(spec, c); }
+      break;
+    }
+  }
+}
+
+#endif
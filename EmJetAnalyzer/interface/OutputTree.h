@@ -49,6 +49,8 @@ namespace emjet
     bool                    HLT_HT350           ;
     bool                    HLT_HT400           ;
     bool                    HLT_HT500           ;
+    int                     HLT_bits            ;
+    int                     budgetFlags         ;
     vector<int>             jet_index               ;
     vector<int>             jet_source              ;
     vector<float>           jet_ptRaw               ;
@@ -254,6 +256,8 @@ emjet::OutputTree::Init() {
   HLT_HT350           = -1;
   HLT_HT400           = -1;
   HLT_HT500           = -1;
+  HLT_bits            = -1;
+  budgetFlags         = -1;
   jet_index               .clear();
   jet_source              .clear();
   jet_ptRaw               .clear();
@@ -459,6 +463,8 @@ emjet::OutputTree::Branch(TTree* tree) {
   BRANCH(tree, HLT_HT350           );
   BRANCH(tree, HLT_HT400           );
   BRANCH(tree, HLT_HT500           );
+  BRANCH(tree, HLT_bits            );
+  BRANCH(tree, budgetFlags         );
   BRANCH(tree, jet_index               );
   BRANCH(tree, jet_source              );
   BRANCH(tree, jet_ptRaw               );
@@ -0,0 +1,248 @@
+#ifndef EmergingJetAnalysis_EmJetAnalyzer_ReplaySnapshot_h
+#define EmergingJetAnalysis_EmJetAnalyzer_ReplaySnapshot_h
+
+// Compact binary snapshot of the EmJetAnalyzer inputs, for replay without CMSSW
+// Written by EmJetReplayExporter, read by emjetReplay. Only depends on the standard library.
+// Objects mirror the accessors of the reco classes used by EmJetCore.h (pt(), eta(), dxy(), position().x(), ...).
+//
+// File layout (native byte order, written and read on the same architecture):
+//   header : char[4] "EJRS", uint32 VERSION
+//   events : repeated Event records, see ReplayWriter::write
+//
+// Track references (jet tracks, vertex tracks) are stored as indices into Event::tracks (generalTracks keys).
+// References to other collections are dropped by the exporter.
+//
+// Usage:
+//   ReplayWriter writer(filename);           ReplayReader reader(filename);
+//   writer.write(event);                     while (reader.read(event)) { ... }
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace emjet
+{
+  namespace replay
+  {
+    static const uint32_t VERSION = 1;
+
+    struct Point {
+      float x_, y_, z_;
+      float x() const { return x_; }
+      float y() const { return y_; }
+      float z() const { return z_; }
+    };
+
+    // Symmetric 3x3 position error
+    struct PointError {
+      float cov_[6]; // xx, xy, xz, yy, yz, zz
+      float cxx() const { return cov_[0]; }
+      float cyy() const { return cov_[3]; }
+      float czz() const { return cov_[5]; }
+    };
+
+    struct BeamSpot {
+      float x0, y0, z0;
+      float dxdz, dydz;
+      float sigmaZ, beamWidthX, beamWidthY;
+      // Beam line position at z
+      Point position(double z) const { Point p = { float(x0 + (z - z0)*dxdz), float(y0 + (z - z0)*dydz), float(z) }; return p; }
+    };
+
+    // Track helix parameters at reference point, as in reco::TrackBase
+    struct Track {
+      enum { i_qoverp = 0, i_lambda, i_phi, i_dxy, i_dsz };
+      float parameters[5];
+      float covariance[15]; // Lower triangle of 5x5 covariance
+      Point referencePoint;
+      int qualityMask;
+      int charge_;
+      int nValidHits;
+
+      double p()   const { return std::fabs(1. / parameters[i_qoverp]); }
+      double pt()  const { return p() * std::cos(parameters[i_lambda]); }
+      double px()  const { return pt() * std::cos(parameters[i_phi]); }
+      double py()  const { return pt() * std::sin(parameters[i_phi]); }
+      double pz()  const { return p() * std::sin(parameters[i_lambda]); }
+      double phi() const { return parameters[i_phi]; }
+      double eta() const { double theta = M_PI/2 - parameters[i_lambda]; return -std::log(std::tan(theta/2)); }
+      int charge() const { return charge_; }
+      double vx() const { return referencePoint.x(); }
+      double vy() const { return referencePoint.y(); }
+      double vz() const { return referencePoint.z(); }
+      // Impact parameters w.r.t. point, as in reco::TrackBase
+      double dxy(const Point& p) const { return ( -(vx()-p.x())*py() + (vy()-p.y())*px() ) / pt(); }
+      double dxy(const BeamSpot& bs) const { return dxy(bs.position(vz())); }
+      double dz(const Point& p) const { return (vz()-p.z()) - ( (vx()-p.x())*px() + (vy()-p.y())*py() ) / pt() * (pz()/pt()); }
+    };
+
+    struct Vertex {
+      Point position_;
+      PointError error_;
+      float chi2, ndof;
+      bool isFake;
+      std::vector<uint32_t> trackIndex;
+      std::vector<float> trackWeights;
+
+      const Point& position() const { return position_; }
+      const PointError& positionError() const { return error_; }
+      // Weight of i-th track of event in vertex fit, 0 if not used
+      float trackWeight(uint32_t itrack) const {
+        for (unsigned i = 0; i < trackIndex.size(); i++) if (trackIndex[i] == itrack) return trackWeights[i];
+        return 0;
+      }
+    };
+
+    struct Jet {
+      float pt, eta, phi, mass;
+      float cef, nef, chf, nhf, pef, mef; // Energy fractions, as in EmJetAnalyzer::prepareJet
+      float csv;                          // -999 if no matching b-tag
+      std::vector<uint32_t> trackIndex;   // Jet constituent tracks (PFJet::getTrackRefs)
+    };
+
+    struct GenParticle {
+      int pdgId_, status_, charge_;
+      float pt_, eta_, phi_, mass_;
+      float vx_, vy_, vz_;    // Production vertex
+      int firstDaughter;      // Index into Event::genParticles, -1 if none
+      int pdgId() const { return pdgId_; }
+      int status() const { return status_; }
+      int charge() const { return charge_; }
+      float pt() const { return pt_; }
+      float eta() const { return eta_; }
+      float phi() const { return phi_; }
+      float mass() const { return mass_; }
+      float vx() const { return vx_; }
+      float vy() const { return vy_; }
+      float vz() const { return vz_; }
+      Point position() const { Point p = { vx_, vy_, vz_ }; return p; }
+    };
+
+    struct Event {
+      uint32_t run, lumi;
+      uint64_t event;
+      BeamSpot beamSpot;
+      std::vector<Track> tracks;                // generalTracks
+      std::vector<Vertex> primaryVertices;      // offlinePrimaryVertices
+      int primaryVertexIndex;                   // Leading primary vertex (highest pt2 sum), -1 if none
+      std::vector<Vertex> secondaryVertices;    // Reco vertices for vertex distance studies
+      std::vector<Jet> jets;                    // selectedJets
+      std::vector<GenParticle> genParticles;    // Empty for data
+    };
+
+    class ReplayWriter {
+    public:
+      explicit ReplayWriter(const std::string& filename) : os_(filename.c_str(), std::ios::binary) {
+        if (!os_) throw std::runtime_error("ReplayWriter: can not open " + filename);
+        os_.write("EJRS", 4);
+        writePOD(VERSION);
+      }
+      void write(const Event& event);
+
+    private:
+      template <class T> void writePOD(const T& t) { os_.write(reinterpret_cast<const char*>(&t), sizeof(T)); }
+      template <class T> void writeVector(const std::vector<T>& v) {
+        writePOD(uint32_t(v.size()));
+        if (!v.empty()) os_.write(reinterpret_cast<const char*>(&v[0]), v.size()*sizeof(T));
+      }
+      void writeVertex(const Vertex& vtx);
+      std::ofstream os_;
+    };
+
+    class ReplayReader {
+    public:
+      explicit ReplayReader(const std::string& filename) : is_(filename.c_str(), std::ios::binary) {
+        char magic[4];
+        uint32_t version = 0;
+        if (!is_ || !is_.read(magic, 4) || std::strncmp(magic, "EJRS", 4) != 0)
+          throw std::runtime_error("ReplayReader: " + filename + " is not a replay snapshot");
+        readPOD(version);
+        if (version != VERSION)
+          throw std::runtime_error("ReplayReader: " + filename + " has unsupported version " + std::to_string(version));
+      }
+      // Return false at end of file
+      bool read(Event& event);
+
+    private:
+      template <class T> void readPOD(T& t) { is_.read(reinterpret_cast<char*>(&t), sizeof(T)); }
+      template <class T> void readVector(std::vector<T>& v) {
+        uint32_t n = 0;
+        readPOD(n);
+        v.resize(n);
+        if (n) is_.read(reinterpret_cast<char*>(&v[0]), n*sizeof(T));
+      }
+      void readVertex(Vertex& vtx);
+      std::ifstream is_;
+    };
+  }
+}
+
+inline void
+emjet::replay::ReplayWriter::writeVertex(const Vertex& vtx)
+{
+  writePOD(vtx.position_); writePOD(vtx.error_);
+  writePOD(vtx.chi2); writePOD(vtx.ndof); writePOD(vtx.isFake);
+  writeVector(vtx.trackIndex); writeVector(vtx.trackWeights);
+}
+
+inline void
+emjet::replay::ReplayWriter::write(const Event& event)
+{
+  writePOD(event.run); writePOD(event.lumi); writePOD(event.event);
+  writePOD(event.beamSpot);
+  writeVector(event.tracks);
+  writePOD(uint32_t(event.primaryVertices.size()));
+  for (const auto& vtx : event.primaryVertices) writeVertex(vtx);
+  writePOD(event.primaryVertexIndex);
+  writePOD(uint32_t(event.secondaryVertices.size()));
+  for (const auto& vtx : event.secondaryVertices) writeVertex(vtx);
+  writePOD(uint32_t(event.jets.size()));
+  for (const auto& jet : event.jets) {
+    writePOD(jet.pt); writePOD(jet.eta); writePOD(jet.phi); writePOD(jet.mass);
+    writePOD(jet.cef); writePOD(jet.nef); writePOD(jet.chf); writePOD(jet.nhf); writePOD(jet.pef); writePOD(jet.mef);
+    writePOD(jet.csv);
+    writeVector(jet.trackIndex);
+  }
+  writeVector(event.genParticles);
+  if (!os_) throw std::runtime_error("ReplayWriter: write failed");
+}
+
+inline void
+emjet::replay::ReplayReader::readVertex(Vertex& vtx)
+{
+  readPOD(vtx.position_); readPOD(vtx.error_);
+  readPOD(vtx.chi2); readPOD(vtx.ndof); readPOD(vtx.isFake);
+  readVector(vtx.trackIndex); readVector(vtx.trackWeights);
+}
+
+inline bool
+emjet::replay::ReplayReader::read(Event& event)
+{
+  readPOD(event.run);
+  if (is_.eof()) return false;
+  readPOD(event.lumi); readPOD(event.event);
+  readPOD(event.beamSpot);
+  readVector(event.tracks);
+  uint32_t n = 0;
+  readPOD(n); event.primaryVertices.resize(n);
+  for (auto& vtx : event.primaryVertices) readVertex(vtx);
+  readPOD(event.primaryVertexIndex);
+  readPOD(n); event.secondaryVertices.resize(n);
+  for (auto& vtx : event.secondaryVertices) readVertex(vtx);
+  readPOD(n); event.jets.resize(n);
+  for (auto& jet : event.jets) {
+    readPOD(jet.pt); readPOD(jet.eta); readPOD(jet.phi); readPOD(jet.mass);
+    readPOD(jet.cef); readPOD(jet.nef); readPOD(jet.chf); readPOD(jet.nhf); readPOD(jet.pef); readPOD(jet.mef);
+    readPOD(jet.csv);
+    readVector(jet.trackIndex);
+  }
+  readVector(event.genParticles);
+  if (!is_) throw std::runtime_error("ReplayReader: truncated event record");
+  return true;
+}
+
+#endif
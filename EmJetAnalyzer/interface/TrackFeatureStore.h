@@ -0,0 +1,172 @@
+#ifndef EmergingJetAnalysis_EmJetAnalyzer_TrackFeatureStore_h
+#define EmergingJetAnalysis_EmJetAnalyzer_TrackFeatureStore_h
+
+// Sidecar store of jet-independent track features
+// Features that only depend on the track and the event (trajectory inner hit, hit pattern, PV quantities, gen matching)
+// are computed once per track and event, even without any file, and can be written to a ROOT file keyed by
+// (run, lumi, event, track key).
+// A later job reading the same events can load them from that file instead of recomputing them.
+// The file stores the configHash it was written with, and is ignored if the hash differs from the current one.
+// Jet-dependent quantities (PCA, signed impact parameters) are never stored.
+//
+// Usage:
+//   beginJob: store_.open(inputFile, outputFile, configHash);   // only needed for file I/O
+//   filter:   store_.beginEvent(run, lumi, event);
+//             const TrackFeatures* f = store_.find(key); if (!f) { compute; store_.record(key, features); }
+//             store_.endEvent();
+//   endJob:   store_.close();
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <iostream>
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TNamed.h"
+
+namespace emjet
+{
+  struct TrackFeatures {
+    // Increase when the content or definition of any feature changes
+    static const int VERSION = 1;
+    enum {
+      kInnerHit_r, kInnerHit_eta, kInnerHit_phi,
+      kNHits, kNMissInnerHits, kNTrkLayers, kNMissInnerTrkLayers, kNMissOuterTrkLayers, kNMissTrkLayers,
+      kNPxlLayers, kNMissInnerPxlLayers, kNMissOuterPxlLayers, kNMissPxlLayers,
+      kMinVertexDz, kPvWeight, kMinGenDistance,
+      NFEATURES
+    };
+    float values[NFEATURES];
+  };
+
+  class TrackFeatureStore {
+  public:
+    TrackFeatureStore() : inFile_(0), inTree_(0), outFile_(0), outTree_(0),
+                          run_(0), lumi_(0), event_(0), inKeys_(0), inValues_(0), nLoaded_(0), nComputed_(0) {}
+    ~TrackFeatureStore() { close(); }
+
+    // Either file name may be empty. The per-event cache does not depend on open().
+    void open(const std::string& input, const std::string& output, const std::string& configHash);
+    void close();
+
+    void beginEvent(int run, int lumi, int event);
+    // Cached features of track, null if not loaded or recorded yet in current event
+    const TrackFeatures* find(unsigned key) const {
+      auto it = current_.find(key);
+      return it == current_.end() ? 0 : &it->second;
+    }
+    void record(unsigned key, const TrackFeatures& features) {
+      current_[key] = features;
+      nComputed_++;
+    }
+    void endEvent();
+
+    void printSummary(std::ostream& os) const {
+      if (!inFile_ && !outFile_) return;
+      os << "TrackFeatureStore summary: " << nLoaded_ << " track features loaded, " << nComputed_ << " computed\n";
+    }
+
+  private:
+    TFile* inFile_;
+    TTree* inTree_;
+    TFile* outFile_;
+    TTree* outTree_;
+    // Branch buffers
+    int run_, lumi_, event_;
+    std::vector<unsigned>* inKeys_;
+    std::vector<float>* inValues_;
+    std::vector<unsigned> outKeys_;
+    std::vector<float> outValues_; // NFEATURES per track, in order of outKeys_
+    // Features of current event, by track key
+    std::unordered_map<unsigned, TrackFeatures> current_;
+    unsigned long nLoaded_;
+    unsigned long nComputed_;
+  };
+}
+
+inline void
+emjet::TrackFeatureStore::open(const std::string& input, const std::string& output, const std::string& configHash)
+{
+  if (!input.empty()) {
+    inFile_ = TFile::Open(input.c_str());
+    TNamed* hash = inFile_ ? dynamic_cast<TNamed*>(inFile_->Get("configHash")) : 0;
+    if ( !hash || configHash != hash->GetTitle() ) {
+      edm::LogWarning("TrackFeatureStore") << "Ignoring track feature store " << input << " (missing or written with different configuration)";
+      if (inFile_) inFile_->Close();
+      delete inFile_; inFile_ = 0;
+    }
+    else {
+      inTree_ = dynamic_cast<TTree*>(inFile_->Get("trackFeatures"));
+      if (!inTree_) throw cms::Exception("TrackFeatureStore") << "No trackFeatures tree in " << input;
+      inTree_->SetBranchAddress("run"   , &run_     );
+      inTree_->SetBranchAddress("lumi"  , &lumi_    );
+      inTree_->SetBranchAddress("event" , &event_   );
+      inTree_->SetBranchAddress("keys"  , &inKeys_  );
+      inTree_->SetBranchAddress("values", &inValues_);
+      inTree_->BuildIndex("run", "event");
+    }
+  }
+  if (!output.empty()) {
+    outFile_ = TFile::Open(output.c_str(), "RECREATE");
+    if (!outFile_ || outFile_->IsZombie()) throw cms::Exception("TrackFeatureStore") << "Can not create " << output;
+    TNamed("configHash", configHash.c_str()).Write();
+    outTree_ = new TTree("trackFeatures", "trackFeatures");
+    outTree_->Branch("run"   , &run_     );
+    outTree_->Branch("lumi"  , &lumi_    );
+    outTree_->Branch("event" , &event_   );
+    outTree_->Branch("keys"  , &outKeys_  );
+    outTree_->Branch("values", &outValues_);
+  }
+}
+
+inline void
+emjet::TrackFeatureStore::close()
+{
+  if (outFile_) {
+    outFile_->cd();
+    outTree_->Write();
+    outFile_->Close();
+    delete outFile_; outFile_ = 0; outTree_ = 0;
+  }
+  if (inFile_) {
+    inFile_->Close();
+    delete inFile_; inFile_ = 0; inTree_ = 0;
+  }
+}
+
+inline void
+emjet::TrackFeatureStore::beginEvent(int run, int lumi, int event)
+{
+  current_.clear();
+  run_ = run; lumi_ = lumi; event_ = event;
+  if (!inTree_) return;
+  Long64_t entry = inTree_->GetEntryNumberWithIndex(run, event);
+  if (entry < 0) return;
+  inTree_->GetEntry(entry);
+  // Restore current event number, in case index matched a different lumi
+  if (lumi_ != lumi) { run_ = run; lumi_ = lumi; event_ = event; return; }
+  for (unsigned i = 0; i < inKeys_->size(); i++) {
+    TrackFeatures& f = current_[(*inKeys_)[i]];
+    std::copy(inValues_->begin() + i*TrackFeatures::NFEATURES, inValues_->begin() + (i+1)*TrackFeatures::NFEATURES, f.values);
+  }
+  nLoaded_ += inKeys_->size();
+}
+
+inline void
+emjet::TrackFeatureStore::endEvent()
+{
+  if (!outTree_) return;
+  outKeys_.clear();
+  outValues_.clear();
+  for (const auto& entry : current_) {
+    outKeys_.push_back(entry.first);
+    outValues_.insert(outValues_.end(), entry.second.values, entry.second.values + TrackFeatures::NFEATURES);
+  }
+  outTree_->Fill();
+}
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef EmergingJetAnalysis_EmJetAnalyzer_VertexIndex_h
+#define EmergingJetAnalysis_EmJetAnalyzer_VertexIndex_h
+
+// Per-event index over reconstructed vertices
+// Positions, error terms and position eta/phi are cached in flat arrays once per event, so that matching does not
+// touch the vertex objects and does no conversions per pair.
+// Queries are flat scans over the cached arrays: with the tens of vertices per event of AVR, a scan is faster than
+// any spatial binning (a uniform grid only started to pay off at about a thousand vertices per event).
+// Supports nearest-vertex queries in 2D and 3D, and minimum significance queries.
+// Either built directly from a vertex collection, or filled vertex by vertex with Add() by code that already computed
+// the positions (VertexViews).
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#include "EmergingJetAnalysis/Utils/interface/Kinematics.h"
+
+using std::vector;
+
+namespace emjet
+{
+  class VertexIndex {
+  public:
+    // Rebuild index from vertex collection (e.g. vector<TransientVertex>)
+    // T must provide position() and positionError()
+    template <class T>
+    void Build(const vector<T>& vertices);
+    // Empty index, then add vertices one by one: position, diagonal of position covariance, eta/phi of position
+    void Clear();
+    void Add(float x, float y, float z, float cxx, float cyy, float czz, float eta, float phi);
+
+    int size() const { return x_.size(); }
+
+    // Return index of vertex closest to (x, y, z), or -1 if index is empty
+    int Nearest2D(float x, float y) const;
+    int Nearest3D(float x, float y, float z) const;
+    // Return index of vertex with smallest distance significance w.r.t. (x, y, z), or -1 if index is empty
+    int MinSig2D(float x, float y) const;
+    int MinSig3D(float x, float y, float z) const;
+    // Return smallest deltaR between position vector (x, y, z) and any vertex position vector
+    float MinDeltaR(float x, float y, float z) const;
+
+    // Pair quantities between point (x, y, z) and i-th vertex
+    float Dist2D (int i, float x, float y) const { float dx = x-x_[i], dy = y-y_[i]; return std::sqrt(dx*dx + dy*dy); }
+    float Dist3D (int i, float x, float y, float z) const { float dz = z-z_[i]; float d2 = Dist2D(i, x, y); return std::sqrt(d2*d2 + dz*dz); }
+    float Sig2D  (int i, float x, float y) const { return Dist2D(i, x, y) / error2D_[i]; }
+    float Sig3D  (int i, float x, float y, float z) const { return Dist3D(i, x, y, z) / error3D_[i]; }
+    float DeltaR (int i, float x, float y, float z) const { return kin::deltaR(kin::eta(x, y, z), kin::phi(x, y), eta_[i], phi_[i]); }
+
+  private:
+    // Index of vertex with smallest score(i), lowest index on ties
+    template <class Score>
+    int Search(Score score) const;
+
+    // Cached per-vertex quantities
+    vector<float> x_, y_, z_;
+    vector<float> error2D_, error3D_;
+    vector<float> eta_, phi_;
+  };
+}
+
+template <class T>
+void
+emjet::VertexIndex::Build(const vector<T>& vertices)
+{
+  Clear();
+  for (const auto& vtx : vertices) {
+    float x = vtx.position().x();
+    float y = vtx.position().y();
+    float z = vtx.position().z();
+    Add(x, y, z, vtx.positionError().cxx(), vtx.positionError().cyy(), vtx.positionError().czz(), kin::eta(x, y, z), kin::phi(x, y));
+  }
+}
+
+inline void
+emjet::VertexIndex::Clear()
+{
+  x_.clear(); y_.clear(); z_.clear();
+  error2D_.clear(); error3D_.clear();
+  eta_.clear(); phi_.clear();
+}
+
+inline void
+emjet::VertexIndex::Add(float x, float y, float z, float cxx, float cyy, float czz, float eta, float phi)
+{
+  x_.push_back(x);
+  y_.push_back(y);
+  z_.push_back(z);
+  error2D_.push_back( std::sqrt( cxx + cyy ) );
+  error3D_.push_back( std::sqrt( cxx + cyy + czz ) );
+  eta_.push_back(eta);
+  phi_.push_back(phi);
+}
+
+template <class Score>
+int
+emjet::VertexIndex::Search(Score score) const
+{
+  int best = -1;
+  float bestScore = std::numeric_limits<float>::max();
+  for (int i = 0; i < size(); i++) {
+    float s = score(i);
+    if (best == -1 || s < bestScore) { bestScore = s; best = i; }
+  }
+  return best;
+}
+
+inline int
+emjet::VertexIndex::Nearest2D(float x, float y) const
+{
+  // Squared distance gives the same order without a sqrt per vertex
+  return Search([&](int i){ float dx = x-x_[i], dy = y-y_[i]; return dx*dx + dy*dy; });
+}
+
+inline int
+emjet::VertexIndex::Nearest3D(float x, float y, float z) const
+{
+  return Search([&](int i){ float dx = x-x_[i], dy = y-y_[i], dz = z-z_[i]; return dx*dx + dy*dy + dz*dz; });
+}
+
+inline int
+emjet::VertexIndex::MinSig2D(float x, float y) const
+{
+  return Search([&](int i){ return Sig2D(i, x, y); });
+}
+
+inline int
+emjet::VertexIndex::MinSig3D(float x, float y, float z) const
+{
+  return Search([&](int i){ return Sig3D(i, x, y, z); });
+}
+
+inline float
+emjet::VertexIndex::MinDeltaR(float x, float y, float z) const
+{
+  float eta = kin::eta(x, y, z);
+  float phi = kin::phi(x, y);
+  float minDeltaR = std::numeric_limits<float>::max();
+  for (unsigned i = 0; i < eta_.size(); i++) {
+    float dr2 = kin::deltaR2(eta, phi, eta_[i], phi_[i]);
+    if (dr2 < minDeltaR) minDeltaR = dr2;
+  }
+  return eta_.empty() ? minDeltaR : std::sqrt(minDeltaR);
+}
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef EmergingJetAnalysis_EmJetAnalyzer_VertexView_h
+#define EmergingJetAnalysis_EmJetAnalyzer_VertexView_h
+
+// Per-event views of the globally reconstructed AVR vertices, and their association to jets
+// Every jet-independent vertex quantity written to the ntuple is computed once per event instead of once per
+// (jet, vertex) pair: position and errors, Lxy w.r.t. the primary vertex, mass, chi2, pt2sum and the direction of
+// the position vector. Refitted tracks of all vertices are listed in one flat array, each view holds the range of
+// its own tracks, so that per (vertex, track) results can be stored in a parallel array.
+// The same pass fills a VertexIndex (index()) from the view positions, for matching of gen vertices.
+// Jets are associated to vertices through the vertex directions sorted by eta: only vertices within maxDeltaR in eta
+// of a jet are compared in deltaR. Associated vertices are listed in vertex order, so that the per-jet loop visits
+// exactly the vertices that pass the jet cone cut, in the same order as a loop over all vertices would.
+//
+// Usage:
+//   views_.Build(avrVertices_, *primary_vertex_);             // once per event, avrVertices_ must stay unchanged
+//   views_.Associate(jetDirections, 0.4);                     // once per event
+//   for (int i : views_.JetVertices(ijet)) { const VertexView& view = views_[i]; const TransientVertex& tv = views_.vertex(i); }
+//   int i = views_.index().Nearest2D(x, y);
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "RecoVertex/VertexPrimitives/interface/TransientVertex.h"
+#include "EmergingJetAnalysis/Utils/interface/Kinematics.h"
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/VertexIndex.h"
+
+namespace emjet
+{
+  struct VertexView {
+    float x, y, z;
+    float xError, yError, zError;
+    float Lxy;                  // Transverse distance to primary vertex
+    float mass;
+    float chi2, ndof;
+    float pt2sum;               // Sum of squared pt of refitted tracks, or of original tracks if not refitted
+    kin::EtaPhi direction;      // Direction of position vector
+    int firstTrack, nTracks;    // Refitted tracks, indices into VertexViews::track()
+
+    // Jet-independent quantities of a single vertex, without track indices (e.g. for per-jet vertices)
+    static VertexView Make(const TransientVertex& ivertex, const reco::Vertex& primaryVertex);
+    static double Pt2Sum(const reco::Vertex& vtx);
+  };
+
+  class VertexViews {
+  public:
+    VertexViews() : vertices_(0) {}
+
+    // Rebuild views from vertices, which must outlive this event's use of the views
+    void Build(const std::vector<TransientVertex>& vertices, const reco::Vertex& primaryVertex);
+    // Associate each jet direction to all vertices within deltaR <= maxDeltaR
+    void Associate(const std::vector<kin::EtaPhi>& jets, double maxDeltaR);
+
+    int size() const { return views_.size(); }
+    const VertexView& operator[](int i) const { return views_[i]; }
+    const TransientVertex& vertex(int i) const { return (*vertices_)[i]; }
+    // Positions and errors of the same vertices, with the same indices
+    const VertexIndex& index() const { return index_; }
+    // Flat list of refitted tracks of all vertices
+    int nTracks() const { return tracks_.size(); }
+    const reco::TransientTrack& track(int k) const { return *tracks_[k]; }
+    // Indices of vertices associated to i-th jet, empty if out of range
+    const std::vector<int>& JetVertices(unsigned ijet) const { return ijet < jetVertices_.size() ? jetVertices_[ijet] : noVertices_; }
+
+  private:
+    const std::vector<TransientVertex>* vertices_;
+    std::vector<VertexView> views_;
+    VertexIndex index_;
+    std::vector<int> etaOrder_;      // Vertex indices sorted by direction.eta
+    std::vector<double> sortedEta_;  // direction.eta in etaOrder_
+    std::vector<const reco::TransientTrack*> tracks_;
+    std::vector< std::vector<int> > jetVertices_;
+    std::vector<int> noVertices_;
+  };
+}
+
+inline double
+emjet::VertexView::Pt2Sum(const reco::Vertex& vtx)
+{
+  // Modified from reco::Vertex::p4()
+  double sum = 0.;
+  if (vtx.hasRefittedTracks()) {
+    for (const auto& trk : vtx.refittedTracks()) sum += trk.pt()*trk.pt();
+  }
+  else {
+    for (auto iter = vtx.tracks_begin(); iter != vtx.tracks_end(); iter++) sum += (*iter)->pt()*(*iter)->pt();
+  }
+  return sum;
+}
+
+inline emjet::VertexView
+emjet::VertexView::Make(const TransientVertex& ivertex, const reco::Vertex& primaryVertex)
+{
+  auto vtx = reco::Vertex(ivertex);
+  VertexView view;
+  view.x = vtx.x();
+  view.y = vtx.y();
+  view.z = vtx.z();
+  view.xError = vtx.xError();
+  view.yError = vtx.yError();
+  view.zError = vtx.zError();
+  float dx = primaryVertex.position().x() - vtx.position().x();
+  float dy = primaryVertex.position().y() - vtx.position().y();
+  view.Lxy = std::sqrt( dx*dx + dy*dy );
+  view.mass = vtx.p4().mass();
+  view.chi2 = vtx.chi2();
+  view.ndof = vtx.ndof();
+  view.pt2sum = Pt2Sum(vtx);
+  view.direction = kin::EtaPhi::fromPosition(vtx);
+  view.firstTrack = 0;
+  view.nTracks = 0;
+  return view;
+}
+
+inline void
+emjet::VertexViews::Build(const std::vector<TransientVertex>& vertices, const reco::Vertex& primaryVertex)
+{
+  vertices_ = &vertices;
+  views_.clear();
+  index_.Clear();
+  tracks_.clear();
+  jetVertices_.clear();
+  views_.reserve(vertices.size());
+  for (const auto& tv : vertices) {
+    views_.push_back(VertexView::Make(tv, primaryVertex));
+    VertexView& view = views_.back();
+    view.firstTrack = tracks_.size();
+    if (tv.hasRefittedTracks()) {
+      for (const auto& trk : tv.refittedTracks()) tracks_.push_back(&trk);
+    }
+    view.nTracks = tracks_.size() - view.firstTrack;
+    const auto& error = tv.positionError();
+    index_.Add(view.x, view.y, view.z, error.cxx(), error.cyy(), error.czz(), view.direction.eta, view.direction.phi);
+  }
+  etaOrder_.resize(views_.size());
+  for (int i = 0; i < size(); i++) etaOrder_[i] = i;
+  std::sort(etaOrder_.begin(), etaOrder_.end(), [this](int i, int j){ return views_[i].direction.eta < views_[j].direction.eta; });
+  sortedEta_.resize(views_.size());
+  for (int i = 0; i < size(); i++) sortedEta_[i] = views_[etaOrder_[i]].direction.eta;
+}
+
+inline void
+emjet::VertexViews::Associate(const std::vector<kin::EtaPhi>& jets, double maxDeltaR)
+{
+  jetVertices_.assign(jets.size(), std::vector<int>());
+  // Eta window slightly wider than maxDeltaR, so that rounding can not drop a vertex passing the deltaR cut
+  double window = maxDeltaR * (1. + 1e-6);
+  for (unsigned ijet = 0; ijet < jets.size(); ijet++) {
+    std::vector<int>& selected = jetVertices_[ijet];
+    auto first = std::lower_bound(sortedEta_.begin(), sortedEta_.end(), jets[ijet].eta - window);
+    for (auto it = first; it != sortedEta_.end() && *it <= jets[ijet].eta + window; ++it) {
+      int i = etaOrder_[it - sortedEta_.begin()];
+      // Same comparison as EmJetAnalyzer::selectJetVertex
+      if ( kin::deltaR(views_[i].direction, jets[ijet]) > maxDeltaR ) continue;
+      selected.push_back(i);
+    }
+    std::sort(selected.begin(), selected.end());
+  }
+}
+
+#endif
@@ -37,6 +37,7 @@
 #include <math.h> // For asin()
 #include <tuple>
 #include <iomanip> // std::setprecision
+#include <sstream>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
@@ -48,6 +49,9 @@
 #include "FWCore/Framework/interface/MakerMacros.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Version/interface/GetReleaseVersion.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/Digest.h"
 
 #include "SimDataFormats/PileupSummaryInfo/interface/PileupSummaryInfo.h"
 #include "SimDataFormats/GeneratorProducts/interface/GenEventInfoProduct.h"
@@ -106,6 +110,8 @@
 // HLT
 #include "DataFormats/Common/interface/TriggerResults.h"
 #include "FWCore/Common/interface/TriggerNames.h"
+#include "FWCore/Utilities/interface/RegexMatch.h"
+#include "DataFormats/Provenance/interface/ParameterSetID.h"
 
 #include "TTree.h"
 #include "TH2F.h"
@@ -119,6 +125,15 @@
 #include "EmergingJetAnalysis/EmJetAnalyzer/interface/OutputTree.h"
 #include "EmergingJetAnalysis/EmJetAnalyzer/interface/EmJetEvent.h"
 #include "EmergingJetAnalysis/EmJetAnalyzer/interface/EmJetAlgos.h"
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/EmJetCore.h"
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/EarlyExit.h"
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/EventBudget.h"
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/EventHistograms.h"
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/TrackFeatureStore.h"
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/VertexView.h"
+#include "EmergingJetAnalysis/Utils/interface/HistogramRegistry.h"
+#include "EmergingJetAnalysis/Utils/interface/EventIndex.h"
+#include "EmergingJetAnalysis/Utils/interface/Kinematics.h"
 #include "EmergingJetAnalysis/GenParticleAnalyzer/plugins/GenParticleAnalyzer.cc"
 
 // JEC corrections
@@ -176,8 +191,14 @@ class EmJetAnalyzer : public edm::EDFilter {
     // n-tuple filling
     void prepareJet(const reco::PFJet& ijet, Jet& ojet, int source, const edm::EventSetup& iSetup);
     void prepareJetTrack(const reco::TransientTrack& itrack, const Jet& ojet, Track& otrack, int source);
+    void prepareTrack(const reco::TransientTrack& itrack, Track& otrack);
+    void prepareJetTrackGeometry(const reco::TransientTrack& itrack, const Jet& ojet, Track& otrack);
+    void prepareTrackFeatures(const reco::TransientTrack& itrack, Track& otrack);
     void prepareJetVertex(const TransientVertex& ivertex, const Jet& ojet, Vertex& overtex, int source);
+    void prepareJetVertex(const emjet::VertexView& view, const Jet& ojet, Vertex& overtex, int source);
     void prepareJetVertexTrack(const reco::TransientTrack& itrack, const Jet& ojet, Track& otrack, const TransientVertex& ivertex, int source, const edm::EventSetup& iSetup);
+    void prepareJetVertexTrack(int ivtx, int k, const Jet& ojet, Track& otrack, int source, const edm::EventSetup& iSetup);
+    void prepareVertexTrack(const reco::TransientTrack& itrack, Track& otrack, const TransientVertex& ivertex, const edm::EventSetup& iSetup);
     void fillJet(const reco::PFJet& ijet, Jet& ojet);
     void fillJetTrack(const reco::TransientTrack& itrack, const Jet& ojet, Track& otrack);
     void fillJetVertex(const TransientVertex& ivertex, const Jet& ojet, Vertex& overtex);
@@ -188,6 +209,7 @@ class EmJetAnalyzer : public edm::EDFilter {
     bool selectJetTrackForVertexing(const reco::TransientTrack& itrack, const Jet& ojet, const Track& otrack) const;
     bool selectJetVertex(const TransientVertex& ivertex, const Jet& ojet, const Vertex& overtex) const;
     void fillGenParticles () ;
+    void resolveJetConditions (const JetCorrectorParameters& jecUncParameters) ;
     void fillPrimaryVertices () ;
     vector<reco::TransientTrack> getJetTrackVectorDeltaR() const;
 
@@ -207,10 +229,8 @@ class EmJetAnalyzer : public edm::EDFilter {
     double compute_theta2D(const edm::EventSetup& iSetup) const;
     int    compute_nDarkPions(const reco::PFJet& ijet) const;
     int    compute_nDarkGluons(const reco::PFJet& ijet) const;
-    double compute_pt2Sum (const TransientVertex& ivertex) const;
     double compute_alpha_global () const;
     double compute_track_minVertexDz (const reco::TransientTrack& itrack) const;
-    double compute_btag(const reco::PFJet& ijet) const;
 
     // Utility functions
     reco::TrackRefVector MergeTracks(reco::TrackRefVector trks1,  reco::TrackRefVector trks2);
@@ -224,7 +244,20 @@ class EmJetAnalyzer : public edm::EDFilter {
     void jetdump(reco::TrackRefVector& trackRefs) const;
     void jetscan(const reco::PFJet& ijet);
 
-    bool triggerfired(const edm::Event& ev, edm::Handle<edm::TriggerResults> triggerResultsHandle_, TString trigname);
+    void putEdmOutput(edm::Event& iEvent);
+    // EDM side products, selected by sideProducts parameter
+    enum SideProduct { kScanJet, kScanJetTracks, kScanJetSelectedTracks, kAvrVerticesGlobalOutput, kAvrVerticesLocalOutput,
+                       kAvrVerticesRFTracksGlobalOutput, kAvrVerticesRFTracksLocalOutput, kDarkPionVertices, kTkvfGlobalOutput, NSIDEPRODUCTS };
+    static const char* sideProductName(SideProduct p);
+    bool sideProduct(SideProduct p) const { return (sideProducts_ >> p) & 1; }
+    // Allocate product if requested, otherwise leave null
+    template <class T>
+    void resetSideProduct(std::auto_ptr<T>& product, SideProduct p) { product.reset( sideProduct(p) ? new T() : 0 ); }
+    template <class T>
+    void putSideProduct(edm::Event& iEvent, std::auto_ptr<T>& product, SideProduct p) { if (product.get()) iEvent.put(product, sideProductName(p)); }
+
+    void resolveTriggerPaths(const edm::TriggerNames& trigNames);
+    int  triggerBits(const edm::TriggerResults& trigResults) const;
 
     // ----------member data ---------------------------
     bool isData_;
@@ -232,17 +265,27 @@ class EmJetAnalyzer : public edm::EDFilter {
     bool scanRandomJet_;
     bool debug_;
     bool saveTracks_;
+    bool genVertexMatchTrackableOnly_;
 
     const edm::EventSetup* eventSetup_; // Pointer to current EventSetup object
 
     edm::Service<TFileService> fs;
-    edm::EDGetTokenT< reco::PFJetCollection > jetCollectionToken_;
+    edm::EDGetTokenT< edm::View<reco::PFJet> > jetCollectionToken_; // Accepts PFJetCollection or PFJetRefVector
     edm::EDGetTokenT<reco::JetCorrector> jetCorrectorToken_;
     edm::EDGetTokenT<edm::View<reco::CaloJet> > jet_collT_;
     edm::EDGetTokenT<reco::JetTracksAssociationCollection> assocVTXToken_;
     edm::EDGetTokenT<reco::JetTracksAssociationCollection> assocCALOToken_;
     edm::EDGetTokenT<edm::TriggerResults> hlTriggerResultsToken_;
+    // HLT path patterns from config, and their resolved path indices
+    // Indices are cached until the TriggerNames ParameterSetID changes (typically once per run)
+    std::vector<std::string> hltPaths_;
+    std::vector< std::vector<unsigned> > hltPathIndices_;
+    edm::ParameterSetID hltTriggerNamesID_;
+    // Legacy per-path flags in Event, filled from HLT_bits
+    std::vector< std::pair<int, bool emjet::Event::*> > hltLegacyFlags_;
     edm::EDGetTokenT<LHERunInfoProduct> lheRunToken_;
+    emjet::EarlyExit earlyExit_; // Rejects events before heavy products are retrieved
+    unsigned sideProducts_; // Bit i set if i-th SideProduct is produced
 
 
     edm::ParameterSet         m_trackParameterSet;
@@ -251,21 +294,33 @@ class EmJetAnalyzer : public edm::EDFilter {
 
     edm::ParameterSet         vtxconfig_;
     ConfigurableVertexReconstructor vtxmaker_;
+    emjet::EventBudget budget_; // Caps on vertexing inputs and stage times
 
     emjet::OutputTree otree_ ; // OutputTree object
-    TTree* tree_;
+    TTree* tree_; // Null in histogram mode
+    bool histogramMode_; // If true, only fill eventHistos_ and do not write tree_
+    emjet::EventHistograms eventHistos_; // Histograms of ntuple variables, from histograms parameter
+    emjet::TrackFeatureStore trackFeatureStore_; // Jet-independent track features, loaded from/saved to sidecar files
+    std::string trackFeatureStoreInput_;
+    std::string trackFeatureStoreOutput_;
+    edm::ProductID generalTracksId_; // Only generalTracks are cached in trackFeatureStore_
+    emjet::EventIndex eventIndex_; // (run, lumi, event) -> tree_ entry, written next to the ntuple
+    bool writeEventIndex_;
     // Histogram objects
+    mutable emjet::HistogramRegistry histos_; // Filled from const methods
     // :GENTRACKMATCHTESTING:
-    TH1F* hist_minDistance_RecoToGen_;
-    TH1F* hist_minDistance_GenToReco_;
+    emjet::HistogramRegistry::H1 hist_minDistance_RecoToGen_;
+    emjet::HistogramRegistry::H1 hist_minDistance_GenToReco_;
     // :VERTEXTESTING:
-    TH1F* hist_LogVertexDistance_GenToReco_;
-    TH1F* hist_LogVertexDistance_RecoToGen_;
-    TH1F* hist_LogVertexDistance2D_GenToReco_;
-    TH1F* hist_LogVertexDistance2D_RecoToGen_;
+    emjet::HistogramRegistry::H1 hist_LogVertexDistance_GenToReco_;
+    emjet::HistogramRegistry::H1 hist_LogVertexDistance_RecoToGen_;
+    emjet::HistogramRegistry::H1 hist_LogVertexDistance2D_GenToReco_;
+    emjet::HistogramRegistry::H1 hist_LogVertexDistance2D_RecoToGen_;
+    emjet::HistogramRegistry::H1 hist_budgetFlags_; // Bin 0: all events, bin i+1: events with EventBudget flag i
     // TH1F* hist_VertexEfficiency_;
     // TH1F* hist_VertexPurity_;
 
+    // Null if not requested in sideProducts
     std::auto_ptr< reco::PFJetCollection > scanJet_;
     std::auto_ptr< reco::TrackCollection > scanJetTracks_;
     std::auto_ptr< reco::TrackCollection > scanJetSelectedTracks_;
@@ -275,7 +330,6 @@ class EmJetAnalyzer : public edm::EDFilter {
     std::auto_ptr< reco::TrackCollection > avrVerticesRFTracksLocalOutput_;
     std::auto_ptr< reco::VertexCollection > darkPionVertices_;
     std::auto_ptr< reco::VertexCollection > tkvfGlobalOutput_;
-    std::auto_ptr< reco::VertexCollection > tkvfLocalOutput_;
 
     emjet:: Event  event_            ; // Current event
     emjet:: Jet    jet_              ; // Current jet
@@ -293,20 +347,29 @@ class EmJetAnalyzer : public edm::EDFilter {
     edm::Handle<reco::VertexCollection> primary_verticesH_;
     edm::Handle<reco::VertexCollection> primary_vertices_withBS_;
     const reco::Vertex* primary_vertex_;
-    edm::Handle<reco::PFJetCollection> selectedJets_;
+    edm::Handle< edm::View<reco::PFJet> > selectedJets_;
     edm::Handle<reco::JetCorrector> jetCorrector_;
     edm::ESHandle<JetCorrectorParametersCollection> JetCorParColl_;
-    JetCorrectionUncertainty *jecUnc_;
     edm::ESHandle<TransientTrackBuilder> transienttrackbuilderH_;
     std::vector<reco::TransientTrack> generalTracks_;
     edm::Handle<reco::GenParticleCollection> genParticlesH_;
     const reco::BeamSpot* theBeamSpot_;
     reco::VertexCollection selectedSecondaryVertices_;
     std::vector<TransientVertex> avrVertices_;
+    emjet::VertexViews avrVertexViews_; // Per-event quantities of avrVertices_, their association to selectedJets_, and their index for gen vertex matching
+    std::vector<Track> avrVertexTracks_; // Jet-independent quantities of avrVertexViews_.track(k), filled on first use
+    std::vector<char> avrVertexTracksDone_; // Non-zero if avrVertexTracks_[k] is filled
     edm::Handle<reco::GenJetCollection> genJets_;
     std::vector<GlobalPoint> dt_points_;
     std::vector<GlobalPoint> csc_points_;
     edm::Handle<reco::JetTagCollection> bTagH_;
+    // Per-jet conditional quantities, index-aligned with selectedJets_
+    struct JetConditions {
+      double jec; // Jet energy correction factor
+      double unc; // JEC uncertainty at corrected pt
+      double csv; // b-tag discriminator, -999 if no unique match
+    };
+    std::vector<JetConditions> jetConditions_;
 
 
     // Testing counters
@@ -354,6 +417,7 @@ EmJetAnalyzer::EmJetAnalyzer(const edm::ParameterSet& iConfig):
   assocCALOToken_ (consumes<reco::JetTracksAssociationCollection>(iConfig.getUntrackedParameter<edm::InputTag>("associatorCALO"))),
   vtxconfig_(iConfig.getParameter<edm::ParameterSet>("vertexreco")),
   vtxmaker_(vtxconfig_),
+  budget_(iConfig.getUntrackedParameter<edm::ParameterSet>("budget", edm::ParameterSet())),
   event_       (),
   jet_         (),
   track_       (),
@@ -365,24 +429,35 @@ EmJetAnalyzer::EmJetAnalyzer(const edm::ParameterSet& iConfig):
   {
     // Initialize tree
     std::string modulename = iConfig.getParameter<std::string>("@module_label");
-    tree_           = fs->make<TTree>("emJetTree","emJetTree");
-    otree_.Branch(tree_);
+    histogramMode_ = iConfig.getUntrackedParameter<bool>("histogramMode", false);
+    tree_ = 0;
+    if (!histogramMode_) {
+      tree_           = fs->make<TTree>("emJetTree","emJetTree");
+      otree_.Branch(tree_);
+    }
+    writeEventIndex_ = tree_ && iConfig.getUntrackedParameter<bool>("eventIndex", false);
 
     // :GENTRACKMATCHTESTING:
     {
-      hist_minDistance_RecoToGen_ = fs->make<TH1F> ("RecoToGenTrackDistance", "RecoToGenTrackDistance", 100, -2., 3.);
-      hist_minDistance_GenToReco_ = fs->make<TH1F> ("GenToRecoTrackDistance", "GenToRecoTrackDistance", 100, -2., 3.);
+      hist_minDistance_RecoToGen_ = histos_.book1D<TH1F>("RecoToGenTrackDistance", "RecoToGenTrackDistance", 100, -2., 3.);
+      hist_minDistance_GenToReco_ = histos_.book1D<TH1F>("GenToRecoTrackDistance", "GenToRecoTrackDistance", 100, -2., 3.);
     }
 
     // Secondary vertex reco performance testing :VERTEXTESTING:
     {
-      hist_LogVertexDistance_GenToReco_ = fs->make<TH1F>("GenToRecoVertexDistance", "GenToRecoVertexDistance", 100, -4., 4.);
-      hist_LogVertexDistance_RecoToGen_ = fs->make<TH1F>("RecoToGenVertexDistance", "RecoToGenVertexDistance", 100, -4., 4.);
-      hist_LogVertexDistance2D_GenToReco_ = fs->make<TH1F>("GenToRecoVertexDistance2D", "GenToRecoVertexDistance2D", 100, -4., 4.);
-      hist_LogVertexDistance2D_RecoToGen_ = fs->make<TH1F>("RecoToGenVertexDistance2D", "RecoToGenVertexDistance2D", 100, -4., 4.);
+      hist_LogVertexDistance_GenToReco_ = histos_.book1D<TH1F>("GenToRecoVertexDistance", "GenToRecoVertexDistance", 100, -4., 4.);
+      hist_LogVertexDistance_RecoToGen_ = histos_.book1D<TH1F>("RecoToGenVertexDistance", "RecoToGenVertexDistance", 100, -4., 4.);
+      hist_LogVertexDistance2D_GenToReco_ = histos_.book1D<TH1F>("GenToRecoVertexDistance2D", "GenToRecoVertexDistance2D", 100, -4., 4.);
+      hist_LogVertexDistance2D_RecoToGen_ = histos_.book1D<TH1F>("RecoToGenVertexDistance2D", "RecoToGenVertexDistance2D", 100, -4., 4.);
       // hist_VertexEfficiency_            = fs->make<TH1F>("VertexEfficiency", "VertexEfficiency", 100, 0., 1.);
       // hist_VertexPurity_                = fs->make<TH1F>("VertexPurity", "VertexPurity", 100, -3., 2.);
     }
+
+    // Histograms of ntuple variables, filled from event_
+    eventHistos_.book(iConfig.getUntrackedParameter< std::vector<edm::ParameterSet> >("histograms", std::vector<edm::ParameterSet>()), histos_);
+
+    // Events processed in degraded mode
+    hist_budgetFlags_ = histos_.book1D<TH1F>("BudgetFlags", "BudgetFlags", emjet::EventBudget::NFLAGS+1, 0., emjet::EventBudget::NFLAGS+1);
   }
 
   // Config-dependent initialization
@@ -393,9 +468,48 @@ EmJetAnalyzer::EmJetAnalyzer(const edm::ParameterSet& iConfig):
     scanRandomJet_ = iConfig.getParameter<bool>("scanRandomJet");
     debug_ = iConfig.getUntrackedParameter<bool>("debug",false);
     saveTracks_ = iConfig.getParameter<bool>("saveTracks"); // Flag to enable saving of track info in ntuple
+    if (histogramMode_ && !eventHistos_.usesLevel(emjet::kTrackLevel)) saveTracks_ = false; // Nothing reads jet tracks
+    genVertexMatchTrackableOnly_ = iConfig.getUntrackedParameter<bool>("genVertexMatchTrackableOnly",true); // Only match gen decay vertices with reconstructable (trackable) decays
+    earlyExit_ = emjet::EarlyExit( iConfig.getUntrackedParameter<edm::ParameterSet>("earlyExit", edm::ParameterSet()) );
+    {
+      edm::ParameterSet pset = iConfig.getUntrackedParameter<edm::ParameterSet>("trackFeatureStore", edm::ParameterSet());
+      trackFeatureStoreInput_  = pset.getUntrackedParameter<std::string>("input" , "");
+      trackFeatureStoreOutput_ = pset.getUntrackedParameter<std::string>("output", "");
+    }
 
-    // Save Adaptive Vertex Reco config parameters to tree_->GetUserInfo()
+    // HLT paths to be stored in HLT_bits, bit i corresponds to i-th entry
+    hltPaths_ = iConfig.getParameter< std::vector<std::string> >("hltPaths");
+    if ( hltPaths_.size() > 31 ) // HLT_bits is stored as int
+      throw cms::Exception("Configuration") << "EmJetAnalyzer: at most 31 hltPaths can be stored in HLT_bits, got " << hltPaths_.size();
     {
+      // Legacy flags are filled if the corresponding path is listed in hltPaths
+      std::vector< std::pair<std::string, bool emjet::Event::*> > legacyFlags = {
+        // EXO-16-003 Triggers
+        {"HLT_HT250_DisplacedDijet40_DisplacedTrack" , &emjet::Event::HLT_HT250   },
+        {"HLT_HT350_DisplacedDijet40_DisplacedTrack" , &emjet::Event::HLT_HT350   },
+        {"HLT_HT400_DisplacedDijet40_Inclusive"      , &emjet::Event::HLT_HT400   },
+        {"HLT_HT500_DisplacedDijet40_Inclusive"      , &emjet::Event::HLT_HT500   },
+        // Emerging Jets Analysis Triggers
+        {"HLT_PFHT400"                               , &emjet::Event::HLT_PFHT400 },
+        {"HLT_PFHT475"                               , &emjet::Event::HLT_PFHT475 },
+        {"HLT_PFHT600"                               , &emjet::Event::HLT_PFHT600 },
+        {"HLT_PFHT800"                               , &emjet::Event::HLT_PFHT800 },
+        {"HLT_PFHT900"                               , &emjet::Event::HLT_PFHT900 },
+      };
+      for (unsigned ipath = 0; ipath < hltPaths_.size(); ipath++) {
+        // Strip version suffix, e.g. "HLT_PFHT400_v*" -> "HLT_PFHT400"
+        std::string name = hltPaths_[ipath];
+        size_t version = name.rfind("_v");
+        if (version != std::string::npos && name.find_first_not_of("0123456789*", version+2) == std::string::npos) name = name.substr(0, version);
+        for (auto flag : legacyFlags) {
+          if (flag.first == name) hltLegacyFlags_.push_back( std::make_pair(ipath, flag.second) );
+        }
+        if (tree_) tree_->GetUserInfo()->AddLast( new TParameter<int> (hltPaths_[ipath].c_str(), ipath) );
+      }
+    }
+
+    // Save Adaptive Vertex Reco config parameters to tree_->GetUserInfo()
+    if (tree_) {
       double primcut = vtxconfig_.getParameter<double>("primcut");
       tree_->GetUserInfo()->AddLast( new TParameter<double> ("primcut", primcut) );
       double seccut = vtxconfig_.getParameter<double>("seccut");
@@ -417,7 +531,7 @@ EmJetAnalyzer::EmJetAnalyzer(const edm::ParameterSet& iConfig):
     m_trackParameters.loadParameters( m_trackParameterSet, iC );
     m_trackAssociator.useDefaultPropagator();
 
-    jetCollectionToken_ = consumes< reco::PFJetCollection > (iConfig.getParameter<edm::InputTag>("srcJets"));
+    jetCollectionToken_ = consumes< edm::View<reco::PFJet> > (iConfig.getParameter<edm::InputTag>("srcJets"));
     if (isData_) {
       jetCorrectorToken_  = consumes<reco::JetCorrector>(edm::InputTag("ak4PFCHSL1FastL2L3ResidualCorrector"));
     }
@@ -462,18 +576,29 @@ EmJetAnalyzer::EmJetAnalyzer(const edm::ParameterSet& iConfig):
 
     }
 
-    // For scanning jets with alphaMax==0
+    // EDM side products (jets/tracks for scanning jets with alphaMax==0, vertices for event displays)
+    // All are produced unless sideProducts is given, unrequested products are neither filled nor allocated
     {
-      produces< reco::PFJetCollection > ("scanJet"). setBranchAlias( "scanJet" ); // scanJet_
-      produces< reco::TrackCollection > ("scanJetTracks"). setBranchAlias( "scanJetTracks" ); // scanJetTracks_
-      produces< reco::TrackCollection > ("scanJetSelectedTracks"). setBranchAlias( "scanJetSelectedTracks" ); // scanJetSelectedTracks_
+      sideProducts_ = (1u << NSIDEPRODUCTS) - 1;
+      if (iConfig.existsAs< std::vector<std::string> >("sideProducts", false)) {
+        sideProducts_ = 0;
+        for (const auto& name : iConfig.getUntrackedParameter< std::vector<std::string> >("sideProducts")) {
+          int p = 0;
+          while ( p < NSIDEPRODUCTS && name != sideProductName(SideProduct(p)) ) p++;
+          if ( p == NSIDEPRODUCTS ) throw cms::Exception("Configuration") << "EmJetAnalyzer: unknown sideProducts entry " << name;
+          sideProducts_ |= (1u << p);
+        }
+      }
+      if (sideProduct(kScanJet)) produces< reco::PFJetCollection > ("scanJet"). setBranchAlias( "scanJet" ); // scanJet_
+      if (sideProduct(kScanJetTracks)) produces< reco::TrackCollection > ("scanJetTracks"). setBranchAlias( "scanJetTracks" ); // scanJetTracks_
+      if (sideProduct(kScanJetSelectedTracks)) produces< reco::TrackCollection > ("scanJetSelectedTracks"). setBranchAlias( "scanJetSelectedTracks" ); // scanJetSelectedTracks_
       // produces< TransientVertexCollection > ("avrVerticesGlobalOutput"). setBranchAlias( "avrVerticesGlobalOutput" ); // avrVerticesGlobalOutput_
-      produces< reco::VertexCollection > ("avrVerticesGlobalOutput"). setBranchAlias( "avrVerticesGlobalOutput" ); // avrVerticesGlobalOutput_
-      produces< reco::VertexCollection > ("avrVerticesLocalOutput"). setBranchAlias( "avrVerticesLocalOutput" ); // avrVerticesLocalOutput_
-      produces< reco::TrackCollection > ("avrVerticesRFTracksGlobalOutput"). setBranchAlias( "avrVerticesRFTracksGlobalOutput" ); // avrVerticesRFTracksGlobalOutput_
-      produces< reco::TrackCollection > ("avrVerticesRFTracksLocalOutput"). setBranchAlias( "avrVerticesRFTracksLocalOutput" ); // avrVerticesRFTracksLocalOutput_
-      produces< reco::VertexCollection > ("darkPionVertices"). setBranchAlias( "darkPionVertices" ); // darkPionVertices_
-      produces< reco::VertexCollection > ("tkvfGlobalOutput"). setBranchAlias( "tkvfGlobalOutput" ); // tkvfGlobalOutput_
+      if (sideProduct(kAvrVerticesGlobalOutput)) produces< reco::VertexCollection > ("avrVerticesGlobalOutput"). setBranchAlias( "avrVerticesGlobalOutput" ); // avrVerticesGlobalOutput_
+      if (sideProduct(kAvrVerticesLocalOutput)) produces< reco::VertexCollection > ("avrVerticesLocalOutput"). setBranchAlias( "avrVerticesLocalOutput" ); // avrVerticesLocalOutput_
+      if (sideProduct(kAvrVerticesRFTracksGlobalOutput)) produces< reco::TrackCollection > ("avrVerticesRFTracksGlobalOutput"). setBranchAlias( "avrVerticesRFTracksGlobalOutput" ); // avrVerticesRFTracksGlobalOutput_
+      if (sideProduct(kAvrVerticesRFTracksLocalOutput)) produces< reco::TrackCollection > ("avrVerticesRFTracksLocalOutput"). setBranchAlias( "avrVerticesRFTracksLocalOutput" ); // avrVerticesRFTracksLocalOutput_
+      if (sideProduct(kDarkPionVertices)) produces< reco::VertexCollection > ("darkPionVertices"). setBranchAlias( "darkPionVertices" ); // darkPionVertices_
+      if (sideProduct(kTkvfGlobalOutput)) produces< reco::VertexCollection > ("tkvfGlobalOutput"). setBranchAlias( "tkvfGlobalOutput" ); // tkvfGlobalOutput_
     }
 
   }
@@ -488,17 +613,37 @@ EmJetAnalyzer::~EmJetAnalyzer()
 
 }
 
-// HLT trig path acceptance function to protect from out of range issue if trigger name is not found in TriggerResults
-// Taken from https://twiki.cern.ch/twiki/pub/CMS/SWGuideCMSDataAnalysisSchool2015HLTExerciseFNAL/TriggerMuMuAnalysis.cc
-bool EmJetAnalyzer::triggerfired(const edm::Event& ev, edm::Handle<edm::TriggerResults> TRHandle_, TString trigname){
-  const edm::TriggerNames TrigNames_ = ev.triggerNames(*TRHandle_);
-  const unsigned int ntrigs = TRHandle_->size();
-  for (unsigned int itr=0; itr<ntrigs; itr++){
-    TString trigName=TrigNames_.triggerName(itr);
-    if (!TRHandle_->accept(itr)) continue;
-    if(trigName.Contains(trigname))      return true;
+// Resolve hltPaths_ patterns to path indices in TriggerResults
+// Patterns containing wildcards (e.g. "HLT_PFHT400_v*") are glob-matched, other patterns match any path containing them
+void EmJetAnalyzer::resolveTriggerPaths(const edm::TriggerNames& trigNames){
+  const std::vector<std::string>& names = trigNames.triggerNames();
+  hltPathIndices_.assign(hltPaths_.size(), std::vector<unsigned>());
+  for (unsigned ipattern = 0; ipattern < hltPaths_.size(); ipattern++) {
+    const std::string& pattern = hltPaths_[ipattern];
+    if ( edm::is_glob(pattern) ) {
+      for (auto match : edm::regexMatch(names, pattern)) hltPathIndices_[ipattern].push_back(match - names.begin());
+    }
+    else {
+      for (unsigned itr = 0; itr < names.size(); itr++) {
+        if ( names[itr].find(pattern) != std::string::npos ) hltPathIndices_[ipattern].push_back(itr);
+      }
+    }
   }
-  return false;
+  hltTriggerNamesID_ = trigNames.parameterSetID();
+}
+
+// Bit i is set if any path matching the i-th entry of hltPaths_ accepted the event
+int EmJetAnalyzer::triggerBits(const edm::TriggerResults& trigResults) const{
+  int bits = 0;
+  for (unsigned ipattern = 0; ipattern < hltPathIndices_.size(); ipattern++) {
+    for (unsigned itr : hltPathIndices_[ipattern]) {
+      if ( trigResults.accept(itr) ) {
+        bits |= (1 << ipattern);
+        break;
+      }
+    }
+  }
+  return bits;
 }
 
 //
@@ -515,23 +660,24 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
   // Reset output tree to default values
   otree_.Init();
   // Reset output collections
-  // Initialize output collections
-  scanJet_ = std::auto_ptr< reco::PFJetCollection > ( new reco::PFJetCollection() );
-  scanJetTracks_ = std::auto_ptr< reco::TrackCollection > ( new reco::TrackCollection() );
-  scanJetSelectedTracks_ = std::auto_ptr< reco::TrackCollection > ( new reco::TrackCollection() );
-  avrVerticesGlobalOutput_ = std::auto_ptr< reco::VertexCollection > ( new reco::VertexCollection() );
-  avrVerticesLocalOutput_ = std::auto_ptr< reco::VertexCollection > ( new reco::VertexCollection() );
-  avrVerticesRFTracksGlobalOutput_ = std::auto_ptr< reco::TrackCollection > ( new reco::TrackCollection() );
-  avrVerticesRFTracksLocalOutput_ = std::auto_ptr< reco::TrackCollection > ( new reco::TrackCollection() );
-  darkPionVertices_ = std::auto_ptr< reco::VertexCollection > ( new reco::VertexCollection() );
-  tkvfGlobalOutput_ = std::auto_ptr< reco::VertexCollection > ( new reco::VertexCollection() );
-  tkvfLocalOutput_ = std::auto_ptr< reco::VertexCollection > ( new reco::VertexCollection() );
+  // Initialize requested output collections
+  resetSideProduct(scanJet_, kScanJet);
+  resetSideProduct(scanJetTracks_, kScanJetTracks);
+  resetSideProduct(scanJetSelectedTracks_, kScanJetSelectedTracks);
+  resetSideProduct(avrVerticesGlobalOutput_, kAvrVerticesGlobalOutput);
+  resetSideProduct(avrVerticesLocalOutput_, kAvrVerticesLocalOutput);
+  resetSideProduct(avrVerticesRFTracksGlobalOutput_, kAvrVerticesRFTracksGlobalOutput);
+  resetSideProduct(avrVerticesRFTracksLocalOutput_, kAvrVerticesRFTracksLocalOutput);
+  // Dark pion vertices are also used for vertex reco testing, which only runs for tkvfGlobalOutput
+  darkPionVertices_.reset( sideProduct(kDarkPionVertices) || sideProduct(kTkvfGlobalOutput) ? new reco::VertexCollection() : 0 );
+  resetSideProduct(tkvfGlobalOutput_, kTkvfGlobalOutput);
   // Reset Event variables
   vertex_.Init();
   jet_.Init();
   event_.Init();
   genparticle_.Init();
   pv_.Init();
+  emjet::EventBudget::EventScope budgetEvent(budget_); // Counted in budget_ on every return path, including early exits
   // Reset object counters
   jet_index_=0;
   track_index_=0;
@@ -564,19 +710,12 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
     }
 
     const edm::TriggerNames& trigNames = iEvent.triggerNames(*trigResults);
+    if (trigNames.parameterSetID() != hltTriggerNamesID_) resolveTriggerPaths(trigNames);
 
-    // EXO-16-003 Triggers
-    event_.HLT_HT250 = triggerfired(iEvent,trigResults,"HLT_HT250_DisplacedDijet40_DisplacedTrack");
-    event_.HLT_HT350 = triggerfired(iEvent,trigResults,"HLT_HT350_DisplacedDijet40_DisplacedTrack");
-    event_.HLT_HT400 = triggerfired(iEvent,trigResults,"HLT_HT400_DisplacedDijet40_Inclusive");
-    event_.HLT_HT500 = triggerfired(iEvent,trigResults,"HLT_HT500_DisplacedDijet40_Inclusive");
-
-    // Emerging Jets Analysis Triggers
-    event_.HLT_PFHT400 = triggerfired(iEvent,trigResults,"HLT_PFHT400_v");
-    event_.HLT_PFHT475 = triggerfired(iEvent,trigResults,"HLT_PFHT475_v");
-    event_.HLT_PFHT600 = triggerfired(iEvent,trigResults,"HLT_PFHT600_v");
-    event_.HLT_PFHT800 = triggerfired(iEvent,trigResults,"HLT_PFHT800_v");
-    event_.HLT_PFHT900 = triggerfired(iEvent,trigResults,"HLT_PFHT900_v");
+    event_.HLT_bits = triggerBits(*trigResults);
+    for (auto flag : hltLegacyFlags_) {
+      event_.*(flag.second) = (event_.HLT_bits >> flag.first) & 1;
+    }
     // if ( event_.HLT_HT250 || event_.HLT_HT350 || event_.HLT_HT400 || event_.HLT_HT500 || event_.HLT_PFHT400 || event_.HLT_PFHT475 || event_.HLT_PFHT600 || event_.HLT_PFHT800 || event_.HLT_PFHT900 ) {
     //   std::cout << "111111111111111\n";
     //   OUTPUT(event_.HLT_PFHT400);
@@ -660,6 +799,16 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
     }
   }
 
+  // Retrieve selectedJets
+  iEvent.getByToken(jetCollectionToken_, selectedJets_);
+
+  // Only cheap products have been read up to here
+  // Reject event before retrieving tracks, PF candidates, MET, b-tags and gen particles
+  if ( !earlyExit_.accept(event_.HLT_bits, event_.nGoodVtx, *selectedJets_) ) {
+    putEdmOutput(iEvent);
+    return false;
+  }
+
   // Fill PDF information :EVENTLEVEL:
   if (!isData_) { // :MCONLY:
     edm::Handle<GenEventInfoProduct> generatorH_;
@@ -743,7 +892,7 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
     // iEvent.getByLabel("genMetTrue", genMetH);
     iEvent.getByLabel("genParticles", genParticlesH_);
     // iEvent.getByLabel("ak4GenJets",   genJets_);
-    findDarkPionVertices();
+    if (darkPionVertices_.get()) findDarkPionVertices();
   }
 
   // Calculate MET :EVENTLEVEL:
@@ -754,18 +903,15 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
     event_.met_phi = pfmet->begin()->phi();
   }
 
-  // Retrieve selectedJets
-  edm::Handle<reco::PFJetCollection> pfjetH;
-  iEvent.getByToken(jetCollectionToken_, pfjetH);
-  selectedJets_ = pfjetH;
   // Retrieve jet correctors
   iEvent.getByToken(jetCorrectorToken_, jetCorrector_);
   // Retrieve JEC uncertainty
   iSetup.get<JetCorrectionsRecord>().get("AK4PFchs",JetCorParColl_);
   JetCorrectorParameters const & JetCorPar = (*JetCorParColl_)["Uncertainty"];
-  jecUnc_ = new JetCorrectionUncertainty(JetCorPar);
   // Retrieve b-tag associations
   iEvent.getByLabel("pfCombinedInclusiveSecondaryVertexV2BJetTags", bTagH_);
+  // Resolve JEC, JEC uncertainty and b-tag for all selected jets
+  resolveJetConditions(JetCorPar);
 
   // Retrieve TransientTrackBuilder
   iSetup.get<TransientTrackRecord>().get("TransientTrackBuilder",transienttrackbuilderH_);
@@ -804,6 +950,8 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
     }
   }
   generalTracks_ = transienttrackbuilderH_->build(genTrackH);
+  generalTracksId_ = genTrackH.id();
+  trackFeatureStore_.beginEvent(event_.run, event_.lumi, event_.event);
 
   // :GENTRACKMATCHTESTING:
   if (!isData_) //:MCONLY:
@@ -813,7 +961,7 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
       const reco::GenParticle* gp = findMinDistanceGenParticle(genParticlesH_.product(), &itrack);
       if (gp != NULL) {
         double distance = computeGenTrackDistance(gp, &itrack);
-        hist_minDistance_RecoToGen_->Fill(TMath::Log10(distance));
+        histos_.fill(hist_minDistance_RecoToGen_, TMath::Log10(distance));
       }
       // OUTPUT(distance);
     }
@@ -821,7 +969,7 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
       const reco::TransientTrack* tk = findMinDistanceTransientTrack(&gp, &generalTracks_);
       if (tk != NULL) {
         double distance = computeGenTrackDistance(&gp, &tk->track());
-        hist_minDistance_GenToReco_->Fill(TMath::Log10(distance));
+        histos_.fill(hist_minDistance_GenToReco_, TMath::Log10(distance));
       }
       // OUTPUT(distance);
     }
@@ -896,14 +1044,12 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
     const reco::JetTagCollection & bTags = *(bTagHandle.product());
     for (unsigned i = 0; i != bTags.size(); ++i) {
       edm::RefToBase<reco::Jet> obj1 = bTags[i].first;
-      TLorentzVector vector1; vector1.SetPxPyPzE(obj1->px(), obj1->py(), obj1->pz(), obj1->energy());
       // cout<<" Jet "<< i
       //     <<" has b tag discriminator = "<<bTags[i].second
       //     << " and obj2 Pt = "<<bTags[i].first->pt()<<endl;
       int nMatched = 0;
       for ( reco::PFJetCollection::const_iterator obj2 = jetH->begin(); obj2 != jetH->end(); obj2++ ) {
-        TLorentzVector vector2; vector2.SetPxPyPzE(obj2->px(), obj2->py(), obj2->pz(), obj2->energy());
-        double dr = vector1.DeltaR(vector2);
+        double dr = emjet::kin::deltaR(obj1->eta(), obj1->phi(), obj2->eta(), obj2->phi());
         if (dr < 0.01) {
           nMatched++;
         }
@@ -934,20 +1080,39 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
         tracks_for_vertexing.push_back(*itk);
     }
   }
+  budget_.capGlobalTracks(tracks_for_vertexing);
+  budget_.startStage();
   avrVertices_ = avr.vertices(tracks_for_vertexing);
-  for (auto tv : avrVertices_) {
-    avrVerticesGlobalOutput_->push_back(reco::Vertex(tv));
-    if (tv.hasRefittedTracks()) {
-      for (auto rftrk : tv.refittedTracks()) {
+  budget_.checkStage();
+  {
+    // Jet-independent vertex quantities, and vertices within the jet cone of each jet :CUT:
+    avrVertexViews_.Build(avrVertices_, *primary_vertex_);
+    std::vector<emjet::kin::EtaPhi> jetDirections;
+    for (const auto& jet : *selectedJets_) {
+      // Rounded to float like jet_.eta/phi, as used by selectJetVertex
+      jetDirections.push_back(emjet::kin::EtaPhi::fromPtEtaPhi(jet.pt(), float(jet.eta()), float(jet.phi())));
+    }
+    avrVertexViews_.Associate(jetDirections, 0.4);
+    avrVertexTracks_.resize(avrVertexViews_.nTracks());
+    avrVertexTracksDone_.assign(avrVertexViews_.nTracks(), 0);
+  }
+  for (const auto& tv : avrVertices_) {
+    if (avrVerticesGlobalOutput_.get()) avrVerticesGlobalOutput_->push_back(reco::Vertex(tv));
+    if (avrVerticesRFTracksGlobalOutput_.get() && tv.hasRefittedTracks()) {
+      for (const auto& rftrk : tv.refittedTracks()) {
         avrVerticesRFTracksGlobalOutput_->push_back(rftrk.track());
       }
     }
   }
-  auto result = computeMinVertexDistance(&(*darkPionVertices_), &avrVertices_);
-  // vertexdump(result);
+  if (darkPionVertices_.get()) {
+    auto result = computeMinVertexDistance(&(*darkPionVertices_), &avrVertices_);
+    // vertexdump(result);
+  }
 
   // Calculate Jet-level quantities and fill into jet_ :JETLEVEL:
-  for ( reco::PFJetCollection::const_iterator jet = selectedJets_->begin(); jet != selectedJets_->end(); jet++ ) {
+  budget_.rankJets(*selectedJets_);
+  budget_.startStage();
+  for ( edm::View<reco::PFJet>::const_iterator jet = selectedJets_->begin(); jet != selectedJets_->end(); jet++ ) {
     // Fill Jet-level quantities
     prepareJet(*jet, jet_, 1, iSetup); // source = 1 for PF jets :JETSOURCE:
 
@@ -972,7 +1137,8 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
     }
 
     // Per-jet vertex reconstruction
-    {
+    // In degraded mode, only for leading jets
+    if ( budget_.vertexJet(jet - selectedJets_->begin()) ) {
       // Add tracks to be used for vertexing
       std::vector<reco::TransientTrack> tracks_for_vertexing;
       std::vector<reco::TransientTrack> primary_tracks;
@@ -988,28 +1154,27 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
         if ( selectJetTrackForVertexing(*itk, jet_, track_) ) // :CUT: Apply Track selection for vertexing
           tracks_for_vertexing.push_back(*itk);
       }
+      budget_.capJetTracks(tracks_for_vertexing);
 
       // Reconstruct vertex from tracks associated with current jet
       std::vector<TransientVertex> vertices_for_current_jet;
       {
         vertices_for_current_jet = vtxmaker_.vertices(primary_tracks, tracks_for_vertexing, *theBeamSpot_);
-        // :VERTEXTESTING:
+      }
+      // :VERTEXTESTING:
+      if (darkPionVertices_.get()) {
         vector<TransientVertex> vertices_disp;
         for (auto vtx: vertices_for_current_jet) {
           double x = vtx.position().x() - primary_vertex_->position().x();
           double y = vtx.position().y() - primary_vertex_->position().y();
-          double z = vtx.position().z() - primary_vertex_->position().z();
-          TVector3 vector_to_pv(x, y, z);
-          double distance2D_to_pv = vector_to_pv.Perp();
+          double distance2D_to_pv = emjet::kin::perp(x, y);
           if (distance2D_to_pv > 1.0) vertices_disp.push_back(vtx);
         }
         reco::VertexCollection darkPionVertices_disp;
         for (auto vtx: *darkPionVertices_) {
           double x = vtx.position().x() - primary_vertex_->position().x();
           double y = vtx.position().y() - primary_vertex_->position().y();
-          double z = vtx.position().z() - primary_vertex_->position().z();
-          TVector3 vector_to_pv(x, y, z);
-          double distance2D_to_pv = vector_to_pv.Perp();
+          double distance2D_to_pv = emjet::kin::perp(x, y);
           if (distance2D_to_pv > 1.0) darkPionVertices_disp.push_back(vtx);
         }
         // auto result = computeMinVertexDistance(&(*darkPionVertices_), &vertices);
@@ -1017,21 +1182,21 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
         // vertexdump(result);
       }
       for (auto tv : vertices_for_current_jet) {
-        avrVerticesLocalOutput_->push_back(reco::Vertex(tv));
-        if (tv.hasRefittedTracks()) {
+        if (avrVerticesLocalOutput_.get()) avrVerticesLocalOutput_->push_back(reco::Vertex(tv));
+        if (avrVerticesRFTracksLocalOutput_.get() && tv.hasRefittedTracks()) {
           for (auto rftrk : tv.refittedTracks()) {
             avrVerticesRFTracksLocalOutput_->push_back(rftrk.track());
           }
         }
       }
       // Fill Jet-Vertex level quantities for per-jet vertices
-      for (auto vtx : vertices_for_current_jet) {
+      for (const auto& vtx : vertices_for_current_jet) {
         if ( !selectJetVertex(vtx, jet_, vertex_) ) continue; // :CUT: Apply Vertex selection
         // Fill Jet-Vertex level quantities
         prepareJetVertex(vtx, jet_, vertex_, 1); // source = 1 for per-jet AVR vertices :VERTEXSOURCE:
         {
           // Fill original tracks from current vertex
-          for (auto trk : vtx.originalTracks()) {
+          for (const auto& trk : vtx.originalTracks()) {
             // Fill Jet-Track level quantities (for Tracks from Vertices)
             prepareJetVertexTrack(trk, jet_, track_, vtx, 2, iSetup);
             track_.source = 2; // source = 2 for original tracks from per-jet AVR vertices :TRACKSOURCE:
@@ -1041,7 +1206,7 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
         }
         if (vtx.hasRefittedTracks()) {
           // Fill refitted tracks from current vertex
-          for (auto trk : vtx.refittedTracks()) {
+          for (const auto& trk : vtx.refittedTracks()) {
             // Fill Jet-Track level quantities (for Tracks from Vertices)
             prepareJetVertexTrack(trk, jet_, track_, vtx, 3, iSetup);
             // source = 3 for refitted tracks from per-jet AVR vertices :TRACKSOURCE:
@@ -1054,20 +1219,23 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
         }
         fillJetVertex(vtx, jet_, vertex_);
       }
+      budget_.checkStage();
     }
 
     // Fill Jet-Vertex level quantities for globally reconstructed AVR vertices
-    for (auto vtx : avrVertices_) {
-      if ( !selectJetVertex(vtx, jet_, vertex_) ) continue; // :CUT: Apply Vertex selection
+    // Only vertices associated to current jet, i.e. passing the selectJetVertex cut
+    for (int ivtx : avrVertexViews_.JetVertices(jet - selectedJets_->begin())) {
+      const emjet::VertexView& view = avrVertexViews_[ivtx];
+      const TransientVertex& vtx = avrVertexViews_.vertex(ivtx);
       // Fill Jet-Vertex level quantities
-      prepareJetVertex(vtx, jet_, vertex_, 2); // source = 2 for global AVR vertices :VERTEXSOURCE:
+      prepareJetVertex(view, jet_, vertex_, 2); // source = 2 for global AVR vertices :VERTEXSOURCE:
       // Write current Vertex to Jet
       jet_.vertex_vector.push_back(vertex_);
       if (vtx.hasRefittedTracks()) {
         // Fill refitted tracks from current vertex
-        for (auto trk : vtx.refittedTracks()) {
+        for (int k = view.firstTrack; k < view.firstTrack + view.nTracks; k++) {
           // Fill Jet-Track level quantities
-          prepareJetVertexTrack(trk, jet_, track_, vtx, 4, iSetup);
+          prepareJetVertexTrack(ivtx, k, jet_, track_, 4, iSetup);
           // source = 4 for refitted tracks from global AVR vertices :TRACKSOURCE:
           // Write current Track to Jet
           jet_.track_vector.push_back(track_);
@@ -1141,25 +1309,22 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
   }
 
   // Vertex reconstruction testing :VERTEXTESTING:
-  {
+  // Uses all generalTracks, only run if tkvfGlobalOutput is requested, and skip in degraded mode
+  if (sideProduct(kTkvfGlobalOutput) && !budget_.degraded()) {
     KalmanTrimmedVertexFinder finder;
     vector<TransientVertex> vertices = finder.vertices (generalTracks_);
     vector<TransientVertex> vertices_disp;
     for (auto vtx: vertices) {
       double x = vtx.position().x() - primary_vertex_->position().x();
       double y = vtx.position().y() - primary_vertex_->position().y();
-      double z = vtx.position().z() - primary_vertex_->position().z();
-      TVector3 vector_to_pv(x, y, z);
-      double distance2D_to_pv = vector_to_pv.Perp();
+      double distance2D_to_pv = emjet::kin::perp(x, y);
       if (distance2D_to_pv > 1.0) vertices_disp.push_back(vtx);
     }
     reco::VertexCollection darkPionVertices_disp;
     for (auto vtx: *darkPionVertices_) {
       double x = vtx.position().x() - primary_vertex_->position().x();
       double y = vtx.position().y() - primary_vertex_->position().y();
-      double z = vtx.position().z() - primary_vertex_->position().z();
-      TVector3 vector_to_pv(x, y, z);
-      double distance2D_to_pv = vector_to_pv.Perp();
+      double distance2D_to_pv = emjet::kin::perp(x, y);
       if (distance2D_to_pv > 1.0) darkPionVertices_disp.push_back(vtx);
     }
     // auto result = computeMinVertexDistance(&(*darkPionVertices_), &vertices);
@@ -1186,10 +1351,29 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
     }
   }
 
+  // Record and count degraded processing
+  event_.budgetFlags = budget_.flags();
+  trackFeatureStore_.endEvent();
+  histos_.fill(hist_budgetFlags_, 0.);
+  for (int i = 0; i < emjet::EventBudget::NFLAGS; i++) {
+    if ( (budget_.flags() >> i) & 1 ) histos_.fill(hist_budgetFlags_, i+1);
+  }
+
+  // Fill histograms directly from current Event
+  eventHistos_.fill(event_);
+
   // Write current Event to OutputTree
-  WriteEventToOutput(event_, &otree_);
-  // Write OutputTree to TTree
-  tree_->Fill();
+  if (tree_) {
+    WriteEventToOutput(event_, &otree_);
+    // Write OutputTree to TTree
+    tree_->Fill();
+    if (writeEventIndex_) {
+      // Ntuple name without directory, the index is written next to it
+      std::string ntupleName = fs->file().GetName();
+      eventIndex_.Add(iEvent.id().run(), iEvent.id().luminosityBlock(), iEvent.id().event(),
+                      ntupleName.substr(ntupleName.rfind('/') + 1), tree_->GetEntries() - 1);
+    }
+  }
 
 #ifdef THIS_IS_AN_EVENT_EXAMPLE
   Handle<ExampleData> pIn;
@@ -1201,34 +1385,69 @@ EmJetAnalyzer::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
   iSetup.get<SetupRecord>().get(pSetup);
 #endif
 
-  iEvent.put(scanJet_, "scanJet"); // scanJet_
-  iEvent.put(scanJetTracks_, "scanJetTracks"); // scanJetTracks_
-  iEvent.put(scanJetSelectedTracks_, "scanJetSelectedTracks"); // scanJetSelectedTracks_
-  iEvent.put(avrVerticesGlobalOutput_, "avrVerticesGlobalOutput"); // avrVerticesGlobalOutput_
-  iEvent.put(avrVerticesLocalOutput_, "avrVerticesLocalOutput"); // avrVerticesLocalOutput_
-  iEvent.put(avrVerticesRFTracksGlobalOutput_, "avrVerticesRFTracksGlobalOutput"); // avrVerticesRFTracksGlobalOutput_
-  iEvent.put(avrVerticesRFTracksLocalOutput_, "avrVerticesRFTracksLocalOutput"); // avrVerticesRFTracksLocalOutput_
-  iEvent.put(darkPionVertices_, "darkPionVertices"); // darkPionVertices_
-  iEvent.put(tkvfGlobalOutput_, "tkvfGlobalOutput"); // tkvfGlobalOutput_
+  putEdmOutput(iEvent);
 
   if (scanRandomJet_) return true;
   if (scanMode_) return (pfjet_alphazero>0);
   return true;
 }
 
+// Put EDM output collections into Event
+void
+EmJetAnalyzer::putEdmOutput(edm::Event& iEvent)
+{
+  putSideProduct(iEvent, scanJet_, kScanJet);
+  putSideProduct(iEvent, scanJetTracks_, kScanJetTracks);
+  putSideProduct(iEvent, scanJetSelectedTracks_, kScanJetSelectedTracks);
+  putSideProduct(iEvent, avrVerticesGlobalOutput_, kAvrVerticesGlobalOutput);
+  putSideProduct(iEvent, avrVerticesLocalOutput_, kAvrVerticesLocalOutput);
+  putSideProduct(iEvent, avrVerticesRFTracksGlobalOutput_, kAvrVerticesRFTracksGlobalOutput);
+  putSideProduct(iEvent, avrVerticesRFTracksLocalOutput_, kAvrVerticesRFTracksLocalOutput);
+  if (sideProduct(kDarkPionVertices)) iEvent.put(darkPionVertices_, "darkPionVertices"); // darkPionVertices_
+  putSideProduct(iEvent, tkvfGlobalOutput_, kTkvfGlobalOutput);
+}
+
+const char*
+EmJetAnalyzer::sideProductName(SideProduct p)
+{
+  static const char* names[NSIDEPRODUCTS] = {
+    "scanJet", "scanJetTracks", "scanJetSelectedTracks", "avrVerticesGlobalOutput", "avrVerticesLocalOutput",
+    "avrVerticesRFTracksGlobalOutput", "avrVerticesRFTracksLocalOutput", "darkPionVertices", "tkvfGlobalOutput",
+  };
+  return names[p];
+}
+
 // ------------ method called once each job just before starting event loop  ------------
 void
 EmJetAnalyzer::beginJob()
 {
   pfjet_alphazero_total = 0;
   calojet_alphazero_total = 0;
+  if ( !trackFeatureStoreInput_.empty() || !trackFeatureStoreOutput_.empty() ) {
+    // Stored features are invalid if their definition, the input type, the release, or the vertex reconstruction
+    // and track association parameters changed
+    std::ostringstream configHash;
+    configHash << "v" << emjet::TrackFeatures::VERSION << "_isData" << isData_ << "_" << edm::getReleaseVersion()
+               << "_" << cms::Digest(vtxconfig_.toString()).digest().toString()
+               << "_" << cms::Digest(m_trackParameterSet.toString()).digest().toString();
+    trackFeatureStore_.open(trackFeatureStoreInput_, trackFeatureStoreOutput_, configHash.str());
+  }
 }
 
 // ------------ method called once each job just after ending the event loop  ------------
 void
 EmJetAnalyzer::endJob() {
+  histos_.merge();
   OUTPUT(pfjet_alphazero_total);
   OUTPUT(calojet_alphazero_total);
+  budget_.printSummary(std::cout);
+  trackFeatureStore_.printSummary(std::cout);
+  trackFeatureStore_.close();
+  if (writeEventIndex_) {
+    std::string indexName = emjet::EventIndex::sidecarName(fs->file().GetName());
+    eventIndex_.Write(indexName);
+    std::cout << "EmJetAnalyzer: wrote " << eventIndex_.size() << " events to " << indexName << std::endl;
+  }
 }
 
 // ------------ method called when starting to processes a run  ------------
@@ -1291,8 +1510,8 @@ EmJetAnalyzer::prepareJet(const reco::PFJet& ijet, Jet& ojet, int source, const
   ojet.Init();
   ojet.index = jet_index_;
   ojet.source = source;
-  // Scan one jet at random
-  if (scanRandomJet_ && scanJet_->size()==0) {
+  // Scan one jet at random, requires scanJet side product
+  if (scanRandomJet_ && scanJet_.get() && scanJet_->size()==0) {
     if (rand() % 2 == 0) jetscan(ijet);
   }
 
@@ -1301,14 +1520,13 @@ EmJetAnalyzer::prepareJet(const reco::PFJet& ijet, Jet& ojet, int source, const
     ojet.ptRaw  = ijet.pt();
     ojet.eta = ijet.eta() ;
     ojet.phi = ijet.phi() ;
-    double jec = jetCorrector_->correction(ijet);
+    const JetConditions& conditions = jetConditions_[jet_index_];
+    double jec = conditions.jec;
     ojet.pt  = ijet.pt() * jec;
     ojet.p4.SetPtEtaPhiM(ojet.pt, ojet.eta, ojet.phi, 0.);
     // Calculate uncertainty
     double ptCor = ojet.pt;
-    jecUnc_->setJetEta(ojet.eta);
-    jecUnc_->setJetPt(ojet.pt); // here you must use the CORRECTED jet pt
-    double unc = jecUnc_->getUncertainty(true);
+    double unc = conditions.unc;
     // double ptCor_shifted = ptCor(1+shift*unc) ; // shift = +1(up), or -1(down)
     ojet.ptUp = ptCor*(1+unc);
     ojet.ptDown = ptCor*(1-unc);
@@ -1319,7 +1537,7 @@ EmJetAnalyzer::prepareJet(const reco::PFJet& ijet, Jet& ojet, int source, const
   }
   // Fill b-tag information
   {
-    ojet.csv = compute_btag(ijet);
+    ojet.csv = jetConditions_[jet_index_].csv;
   }
 
   // Fill PF Jet specific variables
@@ -1441,6 +1659,14 @@ EmJetAnalyzer::prepareJetTrack(const reco::TransientTrack& itrack, const Jet& oj
   otrack.index = track_index_;
   otrack.source = source;
   otrack.jet_index = jet_index_;
+  prepareTrack(itrack, otrack);
+  prepareJetTrackGeometry(itrack, ojet, otrack);
+}
+
+// Fill variables of otrack that do not depend on the jet or a vertex
+void
+EmJetAnalyzer::prepareTrack(const reco::TransientTrack& itrack, Track& otrack)
+{
   auto itk = &itrack;
   // Fill basic kinematic variables
   {
@@ -1455,6 +1681,65 @@ EmJetAnalyzer::prepareJetTrack(const reco::TransientTrack& itrack, const Jet& oj
     otrack.p4.SetPtEtaPhiM(otrack.pt, otrack.eta, otrack.phi, 0.);
   }
 
+  otrack.quality             = itk->track().qualityMask();
+  otrack.algo                = itk->track().algo();
+  otrack.originalAlgo        = itk->track().originalAlgo();
+
+  // Fill jet-independent variables, from trackFeatureStore_ if already computed for this track
+  const reco::TrackBaseRef& ref = itk->trackBaseRef();
+  bool cacheable = !ref.isNull() && ref.id() == generalTracksId_;
+  const emjet::TrackFeatures* features = cacheable ? trackFeatureStore_.find(ref.key()) : 0;
+  if (features) {
+    const float* f = features->values;
+    otrack.innerHit_r          = f[emjet::TrackFeatures::kInnerHit_r          ];
+    otrack.innerHit_eta        = f[emjet::TrackFeatures::kInnerHit_eta        ];
+    otrack.innerHit_phi        = f[emjet::TrackFeatures::kInnerHit_phi        ];
+    otrack.nHits               = f[emjet::TrackFeatures::kNHits               ];
+    otrack.nMissInnerHits      = f[emjet::TrackFeatures::kNMissInnerHits      ];
+    otrack.nTrkLayers          = f[emjet::TrackFeatures::kNTrkLayers          ];
+    otrack.nMissTrkLayers      = f[emjet::TrackFeatures::kNMissTrkLayers      ];
+    otrack.nMissInnerTrkLayers = f[emjet::TrackFeatures::kNMissInnerTrkLayers ];
+    otrack.nMissOuterTrkLayers = f[emjet::TrackFeatures::kNMissOuterTrkLayers ];
+    otrack.nPxlLayers          = f[emjet::TrackFeatures::kNPxlLayers          ];
+    otrack.nMissPxlLayers      = f[emjet::TrackFeatures::kNMissPxlLayers      ];
+    otrack.nMissInnerPxlLayers = f[emjet::TrackFeatures::kNMissInnerPxlLayers ];
+    otrack.nMissOuterPxlLayers = f[emjet::TrackFeatures::kNMissOuterPxlLayers ];
+    otrack.minVertexDz         = f[emjet::TrackFeatures::kMinVertexDz         ];
+    otrack.pvWeight            = f[emjet::TrackFeatures::kPvWeight            ];
+    otrack.minGenDistance      = f[emjet::TrackFeatures::kMinGenDistance      ];
+  }
+  else {
+    prepareTrackFeatures(itrack, otrack);
+    if (cacheable) {
+      emjet::TrackFeatures computed;
+      float* f = computed.values;
+      f[emjet::TrackFeatures::kInnerHit_r          ] = otrack.innerHit_r          ;
+      f[emjet::TrackFeatures::kInnerHit_eta        ] = otrack.innerHit_eta        ;
+      f[emjet::TrackFeatures::kInnerHit_phi        ] = otrack.innerHit_phi        ;
+      f[emjet::TrackFeatures::kNHits               ] = otrack.nHits               ;
+      f[emjet::TrackFeatures::kNMissInnerHits      ] = otrack.nMissInnerHits      ;
+      f[emjet::TrackFeatures::kNTrkLayers          ] = otrack.nTrkLayers          ;
+      f[emjet::TrackFeatures::kNMissTrkLayers      ] = otrack.nMissTrkLayers      ;
+      f[emjet::TrackFeatures::kNMissInnerTrkLayers ] = otrack.nMissInnerTrkLayers ;
+      f[emjet::TrackFeatures::kNMissOuterTrkLayers ] = otrack.nMissOuterTrkLayers ;
+      f[emjet::TrackFeatures::kNPxlLayers          ] = otrack.nPxlLayers          ;
+      f[emjet::TrackFeatures::kNMissPxlLayers      ] = otrack.nMissPxlLayers      ;
+      f[emjet::TrackFeatures::kNMissInnerPxlLayers ] = otrack.nMissInnerPxlLayers ;
+      f[emjet::TrackFeatures::kNMissOuterPxlLayers ] = otrack.nMissOuterPxlLayers ;
+      f[emjet::TrackFeatures::kMinVertexDz         ] = otrack.minVertexDz         ;
+      f[emjet::TrackFeatures::kPvWeight            ] = otrack.pvWeight            ;
+      f[emjet::TrackFeatures::kMinGenDistance      ] = otrack.minGenDistance      ;
+      trackFeatureStore_.record(ref.key(), computed);
+    }
+  }
+
+}
+
+// Fill variables of otrack relative to the jet axis
+void
+EmJetAnalyzer::prepareJetTrackGeometry(const reco::TransientTrack& itrack, const Jet& ojet, Track& otrack)
+{
+  auto itk = &itrack;
   // Fill geometric variables
   {
     const reco::Vertex& primary_vertex = *primary_vertex_;
@@ -1469,13 +1754,10 @@ EmJetAnalyzer::prepareJetTrack(const reco::TransientTrack& itrack, const Jet& oj
     Line::DirectionType dirJet(jetVector);
     Line jetLine(posJet, dirJet);
     GlobalVector pcaToJet = jetLine.distance(closestPoint);
-    TLorentzVector& trackVector = otrack.p4;
-    trackVector.SetPxPyPzE(
-                           closestPoint.x() - primary_vertex.position().x(),
-                           closestPoint.y() - primary_vertex.position().y(),
-                           closestPoint.z() - primary_vertex.position().z(),
-                           itk->track().p());
-    otrack.dRToJetAxis = trackVector.DeltaR(ojet.p4);
+    auto pcaDirection = emjet::kin::EtaPhi::fromXYZ(closestPoint.x() - primary_vertex.position().x(),
+                                                    closestPoint.y() - primary_vertex.position().y(),
+                                                    closestPoint.z() - primary_vertex.position().z());
+    otrack.dRToJetAxis = emjet::kin::deltaR(pcaDirection, emjet::kin::EtaPhi::fromPtEtaPhi(ojet.pt, ojet.eta, ojet.phi));
     // Calculate PCA coordinates
     otrack.pca_r   = closestPoint.perp();
     otrack.pca_eta = closestPoint.eta();
@@ -1489,13 +1771,20 @@ EmJetAnalyzer::prepareJetTrack(const reco::TransientTrack& itrack, const Jet& oj
     otrack.ipXYSig = (dxy_ipv.second.significance());
     otrack.ip3D    = (dxyz_ipv.second.value());
     otrack.ip3DSig = (dxyz_ipv.second.significance());
+  }
+}
 
-    // Calculate hit positions
+// Fill variables of otrack that do not depend on the jet
+void
+EmJetAnalyzer::prepareTrackFeatures(const reco::TransientTrack& itrack, Track& otrack)
+{
+  auto itk = &itrack;
+  // Calculate hit positions
+  {
     TrajectoryStateOnSurface innermost_state;
     {
       const edm::EventSetup& iSetup = *eventSetup_;
       // OUTPUT(eventSetup_);
-      // OUTPUT(source);
       // trajectory information for acessing hits
       static GetTrackTrajInfo getTrackTrajInfo;
       std::vector<GetTrackTrajInfo::Result> trajInfo = getTrackTrajInfo.analyze(iSetup, itrack.track());
@@ -1513,9 +1802,6 @@ EmJetAnalyzer::prepareJetTrack(const reco::TransientTrack& itrack, const Jet& oj
     }
   }
 
-  otrack.quality             = itk->track().qualityMask();
-  otrack.algo                = itk->track().algo();
-  otrack.originalAlgo        = itk->track().originalAlgo();
   otrack.nHits               = itk->numberOfValidHits();
   otrack.nMissInnerHits      = itk->hitPattern().numberOfLostTrackerHits(reco::HitPattern::MISSING_INNER_HITS);
   otrack.nTrkLayers          = itk->hitPattern().trackerLayersWithMeasurement();
@@ -1579,10 +1865,38 @@ EmJetAnalyzer::fillJetTrack(const reco::TransientTrack& itrack, const Jet& ojet,
 void
 EmJetAnalyzer::prepareJetVertexTrack(const reco::TransientTrack& itrack, const Jet& ojet, Track& otrack, const TransientVertex& ivertex, int source, const edm::EventSetup& iSetup)
 {
-  static CheckHitPattern checkHitPattern;
-
   prepareJetTrack(itrack, ojet, otrack, source);
   otrack.vertex_index = vertex_index_;
+  prepareVertexTrack(itrack, otrack, ivertex, iSetup);
+}
+
+// k-th track of avrVertexViews_, belonging to ivtx-th global AVR vertex
+// Jet-independent quantities are computed for the first jet that uses the track, and copied for the other jets
+void
+EmJetAnalyzer::prepareJetVertexTrack(int ivtx, int k, const Jet& ojet, Track& otrack, int source, const edm::EventSetup& iSetup)
+{
+  const reco::TransientTrack& itrack = avrVertexViews_.track(k);
+  if (!avrVertexTracksDone_[k]) {
+    Track& cached = avrVertexTracks_[k];
+    cached.Init();
+    prepareTrack(itrack, cached);
+    prepareVertexTrack(itrack, cached, avrVertexViews_.vertex(ivtx), iSetup);
+    avrVertexTracksDone_[k] = 1;
+  }
+  otrack = avrVertexTracks_[k];
+  otrack.index = track_index_;
+  otrack.source = source;
+  otrack.jet_index = jet_index_;
+  otrack.vertex_index = vertex_index_;
+  prepareJetTrackGeometry(itrack, ojet, otrack);
+}
+
+// Fill variables of otrack that depend on the vertex, but not on the jet
+void
+EmJetAnalyzer::prepareVertexTrack(const reco::TransientTrack& itrack, Track& otrack, const TransientVertex& ivertex, const edm::EventSetup& iSetup)
+{
+  static CheckHitPattern checkHitPattern;
+
   otrack.vertex_weight = ivertex.trackWeight(itrack);
   bool fixHitPattern = true;
   CheckHitPattern::Result hitInfo = checkHitPattern.analyze(iSetup, itrack.track(), ivertex.vertexState(), fixHitPattern);
@@ -1592,35 +1906,31 @@ EmJetAnalyzer::prepareJetVertexTrack(const reco::TransientTrack& itrack, const J
 
 void
 EmJetAnalyzer::prepareJetVertex(const TransientVertex& ivertex, const Jet& ojet, Vertex& overtex, int source)
+{
+  prepareJetVertex(emjet::VertexView::Make(ivertex, *primary_vertex_), ojet, overtex, source);
+}
+
+void
+EmJetAnalyzer::prepareJetVertex(const emjet::VertexView& view, const Jet& ojet, Vertex& overtex, int source)
 {
   overtex.Init();
   overtex.index = vertex_index_;
   overtex.source = source;
   overtex.jet_index = jet_index_;
 
-  auto vtx = reco::Vertex(ivertex);
-  const reco::Vertex& primary_vertex = *primary_vertex_;
-  TLorentzVector vertexVector;
-  vertexVector.SetXYZT(vtx.x(), vtx.y(), vtx.z(), 0.0);
-  double deltaR = vertexVector.DeltaR(ojet.p4);
-  double Lxy = 0;
-  float dx = primary_vertex.position().x() - vtx.position().x();
-  float dy = primary_vertex.position().y() - vtx.position().y();
-  Lxy = TMath::Sqrt( dx*dx + dy*dy );
-  float mass = vtx.p4().mass();
-  float pt2sum = compute_pt2Sum(ivertex);
-  overtex.x      = ( vtx.x()      );
-  overtex.y      = ( vtx.y()      );
-  overtex.z      = ( vtx.z()      );
-  overtex.xError = ( vtx.xError() );
-  overtex.yError = ( vtx.yError() );
-  overtex.zError = ( vtx.zError() );
-  overtex.deltaR = ( deltaR       );
-  overtex.Lxy    = ( Lxy          );
-  overtex.mass   = ( mass         );
-  overtex.chi2   = ( vtx.chi2()   );
-  overtex.ndof   = ( vtx.ndof()   );
-  overtex.pt2sum = ( pt2sum       );
+  double deltaR = emjet::kin::deltaR(view.direction, emjet::kin::EtaPhi::fromPtEtaPhi(ojet.pt, ojet.eta, ojet.phi));
+  overtex.x      = ( view.x      );
+  overtex.y      = ( view.y      );
+  overtex.z      = ( view.z      );
+  overtex.xError = ( view.xError );
+  overtex.yError = ( view.yError );
+  overtex.zError = ( view.zError );
+  overtex.deltaR = ( deltaR      );
+  overtex.Lxy    = ( view.Lxy    );
+  overtex.mass   = ( view.mass   );
+  overtex.chi2   = ( view.chi2   );
+  overtex.ndof   = ( view.ndof   );
+  overtex.pt2sum = ( view.pt2sum );
 }
 
 void
@@ -1635,14 +1945,7 @@ EmJetAnalyzer::fillJetVertex(const TransientVertex& ivertex, const Jet& ojet, Ve
 bool
 EmJetAnalyzer::selectTrack(const reco::TransientTrack& itrack) const
 {
-  auto itk = &itrack;
-  // Skip tracks with pt<1 :CUT:
-  if (itk->track().pt() < 1.) return false;
-  // Skip tracks failing "high purity" selection
-  int quality = itrack.track().qualityMask();
-  bool isHighPurity = (quality & 4) > 0;
-  if (!isHighPurity) return false;
-  return true;
+  return emjet::selectTrack(itrack.track().pt(), itrack.track().qualityMask());
 }
 
 bool
@@ -1662,13 +1965,10 @@ EmJetAnalyzer::selectJetTrack(const reco::TransientTrack& itrack, const Jet& oje
   if ( !( std::isfinite(closestPoint.x()) && std::isfinite(closestPoint.y()) && std::isfinite(closestPoint.z()) ) ) return false;
 
   // Skip tracks with deltaR > 0.4 w.r.t. current jet :CUT:
-  TLorentzVector trackVector;
-  trackVector.SetPxPyPzE(
-                         closestPoint.x() - primary_vertex.position().x(),
-                         closestPoint.y() - primary_vertex.position().y(),
-                         closestPoint.z() - primary_vertex.position().z(),
-                         itk->track().p());
-  float deltaR = trackVector.DeltaR(ojet.p4);
+  auto pcaDirection = emjet::kin::EtaPhi::fromXYZ(closestPoint.x() - primary_vertex.position().x(),
+                                                  closestPoint.y() - primary_vertex.position().y(),
+                                                  closestPoint.z() - primary_vertex.position().z());
+  float deltaR = emjet::kin::deltaR(pcaDirection, emjet::kin::EtaPhi::fromPtEtaPhi(ojet.pt, ojet.eta, ojet.phi));
   // if (itrack==1) std::cout << "deltaR: " << deltaR << std::endl;
   if (deltaR > 0.4) return false;
   return true;
@@ -1677,22 +1977,8 @@ EmJetAnalyzer::selectJetTrack(const reco::TransientTrack& itrack, const Jet& oje
 bool
 EmJetAnalyzer::selectJetTrackDeltaR(const reco::TransientTrack& itrack, const Jet& ojet) const
 {
-  // Gets jet 4 vector from ojet.p4
-  auto itk = &itrack;
   if (!selectTrack(itrack)) return false; // :CUT: Require track to pass basic selection
-
-  // Skip tracks with deltaR > 0.4 w.r.t. current jet :CUT:
-  TLorentzVector trackVector;
-  trackVector.SetPxPyPzE(
-                         itk->track().px(),
-                         itk->track().py(),
-                         itk->track().pz(),
-                         itk->track().p());
-  float deltaR = trackVector.DeltaR(ojet.p4);
-  // if (itrack==1) std::cout << "deltaR: " << deltaR << std::endl;
-  if (deltaR > 0.4) return false;
-
-  return true;
+  return emjet::selectJetTrackDeltaR(itrack.track().eta(), itrack.track().phi(), ojet.eta, ojet.phi);
 }
 
 bool
@@ -1718,13 +2004,13 @@ EmJetAnalyzer::selectJetTrackInnerHit(const reco::TransientTrack& itrack, const
   // std::cout << "Sucessfully got inner most trajectory state\n";
   GlobalPoint innerPosGP = innermost_state.globalPosition();
   GlobalVector innerPosMomGV = innermost_state.globalMomentum();
-  TLorentzVector innerPos(innerPosGP.x(), innerPosGP.y(), innerPosGP.z(), 0);
   // Retrieve primary vertex position
   const reco::Vertex& primary_vertex = *primary_vertex_;
-  TLorentzVector pvVector(primary_vertex.x(), primary_vertex.y(), primary_vertex.z(), 0);
-  TLorentzVector trackVector = (pvVector - innerPos);
+  auto trackDirection = emjet::kin::EtaPhi::fromXYZ(primary_vertex.x() - innerPosGP.x(),
+                                                    primary_vertex.y() - innerPosGP.y(),
+                                                    primary_vertex.z() - innerPosGP.z());
   // Skip tracks with deltaR > 0.4 w.r.t. current jet :CUT:
-  float deltaR = trackVector.DeltaR(ojet.p4);
+  float deltaR = emjet::kin::deltaR(trackDirection, emjet::kin::EtaPhi::fromPtEtaPhi(ojet.pt, ojet.eta, ojet.phi));
   // if (itrack==1) std::cout << "deltaR: " << deltaR << std::endl;
   if (deltaR > 0.4) return false;
   return true;
@@ -1744,11 +2030,8 @@ EmJetAnalyzer::selectJetTrackForVertexing(const reco::TransientTrack& itrack, co
 bool
 EmJetAnalyzer::selectJetVertex(const TransientVertex& ivertex, const Jet& ojet, const Vertex& overtex) const
 {
-  auto vtx = reco::Vertex(ivertex);
-
-  TLorentzVector vertexVector;
-  vertexVector.SetXYZT(vtx.x(), vtx.y(), vtx.z(), 0.0);
-  double deltaR = vertexVector.DeltaR(ojet.p4);
+  // Only the position is needed, no conversion to reco::Vertex
+  double deltaR = emjet::kin::deltaR(emjet::kin::EtaPhi::fromPosition(ivertex.position()), emjet::kin::EtaPhi::fromPtEtaPhi(ojet.pt, ojet.eta, ojet.phi));
   if (deltaR > 0.4) return false; // Ignore vertices outside jet cone :CUT:
   return true;
 }
@@ -1771,7 +2054,7 @@ EmJetAnalyzer::fillGenParticles () {
     if ( cand->numberOfDaughters()>0 ) {
       const reco::Candidate* dau = cand->daughter(0);
       if (dau) {
-        Lxy = TMath::Sqrt( dau->vx()*dau->vx() + dau->vy()*dau->vy() );
+        Lxy = emjet::kin::perp(dau->vx(), dau->vy());
       }
     }
     genparticle_.Lxy = Lxy;
@@ -1811,37 +2094,23 @@ EmJetAnalyzer::fillGenParticles () {
     float matched3Dsig  = 999999.;
     float matchedDeltaR = 999999.;
     // GenParticle vx/vy/vz returns production vertex position, so use first daughter to find decay vertex if it exists
-    if (cand->numberOfDaughters()>0) {
+    // Only decays with at least two reconstructable daughters can produce a reco vertex :CUT:
+    const emjet::VertexIndex& avrVertexIndex = avrVertexViews_.index();
+    if ( cand->numberOfDaughters()>0 && avrVertexIndex.size()>0 && (isTrackable || !genVertexMatchTrackableOnly_) ) {
       auto decay = cand->daughter(0);
-      for (auto vtx: avrVertices_) {
-        float dx = decay->vx() - vtx.position().x();
-        float dy = decay->vy() - vtx.position().y();
-        float dz = decay->vz() - vtx.position().z();
-        float exx = vtx.positionError().cxx();
-        float eyy = vtx.positionError().cyy();
-        float ezz = vtx.positionError().czz();
-        float dist2D = TMath::Sqrt( dx*dx + dy*dy );
-        float dist3D = TMath::Sqrt( dx*dx + dy*dy + dz*dz );
-        float error2D = TMath::Sqrt( exx + eyy );
-        float error3D = TMath::Sqrt( exx + eyy + ezz );
-        float sig2D = dist2D/error2D;
-        float sig3D = dist3D/error3D;
-        TLorentzVector decayVector (decay->vx(), decay->vy(), decay->vz(), 0.);
-        TLorentzVector vtxVector (vtx.position().x(), vtx.position().y(), vtx.position().z(), 0.);
-        float deltaR = decayVector.DeltaR(vtxVector);
-        if (dist2D<min2Ddist) {
-          min2Ddist = dist2D;
-          matched2Ddist = dist2D;
-          matched2Dsig = sig2D;
-          matched3Ddist = dist3D;
-          matched3Dsig = sig3D;
-          matchedDeltaR = deltaR;
-        }
-        if (dist3D<min3Ddist) min3Ddist = dist3D;
-        if (sig2D<min2Dsig) min2Dsig = sig2D;
-        if (sig3D<min3Dsig) min3Dsig = sig3D;
-        if (deltaR<minDeltaR) minDeltaR = deltaR;
-      }
+      float x = decay->vx(), y = decay->vy(), z = decay->vz();
+      int i2Ddist = avrVertexIndex.Nearest2D(x, y);
+      min2Ddist = avrVertexIndex.Dist2D(i2Ddist, x, y);
+      min3Ddist = avrVertexIndex.Dist3D(avrVertexIndex.Nearest3D(x, y, z), x, y, z);
+      min2Dsig  = avrVertexIndex.Sig2D (avrVertexIndex.MinSig2D(x, y), x, y);
+      min3Dsig  = avrVertexIndex.Sig3D (avrVertexIndex.MinSig3D(x, y, z), x, y, z);
+      minDeltaR = avrVertexIndex.MinDeltaR(x, y, z);
+      // Quantities for vertex closest in 2D
+      matched2Ddist = min2Ddist;
+      matched2Dsig  = avrVertexIndex.Sig2D (i2Ddist, x, y);
+      matched3Ddist = avrVertexIndex.Dist3D(i2Ddist, x, y, z);
+      matched3Dsig  = avrVertexIndex.Sig3D (i2Ddist, x, y, z);
+      matchedDeltaR = avrVertexIndex.DeltaR(i2Ddist, x, y, z);
     }
     genparticle_.min2Ddist = min2Ddist;
     genparticle_.min2Dsig  = min2Dsig;
@@ -1937,210 +2206,85 @@ EmJetAnalyzer::compute_alphaMax(const reco::PFJet& ijet, reco::TrackRefVector& t
 double
 EmJetAnalyzer::compute_alphaMax(reco::TrackRefVector& trackRefs) const
 {
-  double alphaMax = -1.;
-  // Loop over all tracks and calculate scalar pt-sum of all tracks in current jet
-  double jet_pt_sum = 0.;
-  for (reco::TrackRefVector::iterator ijt = trackRefs.begin(); ijt != trackRefs.end(); ++ijt) {
-    jet_pt_sum += (*ijt)->pt();
-  } // End of track loop
-
-  auto ipv_chosen = primary_verticesH_->end(); // iterator to chosen primary vertex
-  double max_vertex_pt_sum = 0.; // scalar pt contribution of vertex to jet
-  // Loop over all PVs and choose the one with highest scalar pt contribution to jet
-  for (auto ipv = primary_verticesH_->begin(); ipv != primary_verticesH_->end(); ++ipv) {
-    double vertex_pt_sum = 0.; // scalar pt contribution of vertex to jet
-    for (reco::TrackRefVector::iterator ijt = trackRefs.begin(); ijt != trackRefs.end(); ++ijt) {
-      double trackWeight = ipv->trackWeight(*ijt);
-      if (trackWeight > 0) vertex_pt_sum += (*ijt)->pt();
-    } // End of track loop
-    if (vertex_pt_sum > max_vertex_pt_sum) {
-      max_vertex_pt_sum = vertex_pt_sum;
-      ipv_chosen = ipv;
-    }
-  } // End of vertex loop
-  // Calculate alpha
-  alphaMax = max_vertex_pt_sum / jet_pt_sum;
-  return alphaMax;
+  return emjet::computeAlphaMax(trackRefs, *primary_verticesH_,
+                                [](const reco::TrackRef& trk) { return trk->pt(); },
+                                [](const reco::Vertex& vtx, const reco::TrackRef& trk) { return vtx.trackWeight(trk) > 0; });
 }
 
 // Calculate jet alphaMax
 double
 EmJetAnalyzer::compute_alphaMax(vector<reco::TransientTrack> tracks) const
 {
-  double alphaMax = -1.;
-  // Loop over all tracks and calculate scalar pt-sum of all tracks in current jet
-  double jet_pt_sum = 0.;
-  for (auto ijt = tracks.begin(); ijt != tracks.end(); ++ijt) {
-    jet_pt_sum += (ijt)->track().pt();
-  } // End of track loop
-
-  auto ipv_chosen = primary_verticesH_->end(); // iterator to chosen primary vertex
-  double max_vertex_pt_sum = 0.; // scalar pt contribution of vertex to jet
-  // Loop over all PVs and choose the one with highest scalar pt contribution to jet
-  for (auto ipv = primary_verticesH_->begin(); ipv != primary_verticesH_->end(); ++ipv) {
-    double vertex_pt_sum = 0.; // scalar pt contribution of vertex to jet
-    for (auto ijt = tracks.begin(); ijt != tracks.end(); ++ijt) {
-      if ((ijt)->trackBaseRef().isNull()) {
-        // trackBaseRef is null
-        STDOUT("compute_alpha: trackBaseRef is null");
-        continue;
-      }
-      double trackWeight = ipv->trackWeight((ijt)->trackBaseRef());
-      if (trackWeight > 0) vertex_pt_sum += (ijt)->track().pt();
-    } // End of track loop
-    if (vertex_pt_sum > max_vertex_pt_sum) {
-      max_vertex_pt_sum = vertex_pt_sum;
-      ipv_chosen = ipv;
-    }
-  } // End of vertex loop
-  // Calculate alpha
-  alphaMax = max_vertex_pt_sum / jet_pt_sum;
-  return alphaMax;
+  return emjet::computeAlphaMax(tracks, *primary_verticesH_,
+                                [](const reco::TransientTrack& trk) { return trk.track().pt(); },
+                                [](const reco::Vertex& vtx, const reco::TransientTrack& trk) {
+                                  if (trk.trackBaseRef().isNull()) {
+                                    // trackBaseRef is null
+                                    STDOUT("compute_alpha: trackBaseRef is null");
+                                    return false;
+                                  }
+                                  return vtx.trackWeight(trk.trackBaseRef()) > 0;
+                                });
 }
 
 // Calculate jet alpha
 double
 EmJetAnalyzer::compute_alpha(reco::TrackRefVector& trackRefs) const
 {
-  double alpha = -1.;
-  // Loop over all tracks and calculate scalar pt-sum of all tracks in current jet
-  double jet_pt_sum = 0.;
-  for (reco::TrackRefVector::iterator ijt = trackRefs.begin(); ijt != trackRefs.end(); ++ijt) {
-    jet_pt_sum += (*ijt)->pt();
-  } // End of track loop
-
   const reco::Vertex& primary_vertex = *primary_vertex_;
-  double vertex_pt_sum = 0.; // scalar pt contribution of vertex to jet
-  for (reco::TrackRefVector::iterator ijt = trackRefs.begin(); ijt != trackRefs.end(); ++ijt) {
-    double trackWeight = primary_vertex.trackWeight(*ijt);
-    if (trackWeight > 0) vertex_pt_sum += (*ijt)->pt();
-  } // End of track loop
-  // Calculate alpha
-  alpha = vertex_pt_sum / jet_pt_sum;
-  return alpha;
+  return emjet::computeAlpha(trackRefs,
+                             [](const reco::TrackRef& trk) { return trk->pt(); },
+                             [&](const reco::TrackRef& trk) { return primary_vertex.trackWeight(trk) > 0; });
 }
 
 // Calculate jet alpha
 double
 EmJetAnalyzer::compute_alpha(vector<reco::TransientTrack> tracks) const
 {
-  double alpha = -1.;
-  // Loop over all tracks and calculate scalar pt-sum of all tracks in current jet
-  double jet_pt_sum = 0.;
-  for (auto ijt = tracks.begin(); ijt != tracks.end(); ++ijt) {
-    jet_pt_sum += (ijt)->track().pt();
-  } // End of track loop
-
   const reco::Vertex& primary_vertex = *primary_vertex_;
-  double vertex_pt_sum = 0.; // scalar pt contribution of vertex to jet
-  for (auto ijt = tracks.begin(); ijt != tracks.end(); ++ijt) {
-    if ((ijt)->trackBaseRef().isNull()) {
-      // trackBaseRef is null
-      STDOUT("compute_alpha: trackBaseRef is null");
-      continue;
-    }
-    double trackWeight = primary_vertex.trackWeight((ijt)->trackBaseRef());
-    if (trackWeight > 0) vertex_pt_sum += (ijt)->track().pt();
-  } // End of track loop
-  // Calculate alpha
-  alpha = vertex_pt_sum / jet_pt_sum;
-  return alpha;
+  return emjet::computeAlpha(tracks,
+                             [](const reco::TransientTrack& trk) { return trk.track().pt(); },
+                             [&](const reco::TransientTrack& trk) {
+                               if (trk.trackBaseRef().isNull()) {
+                                 // trackBaseRef is null
+                                 STDOUT("compute_alpha: trackBaseRef is null");
+                                 return false;
+                               }
+                               return primary_vertex.trackWeight(trk.trackBaseRef()) > 0;
+                             });
 }
 
 double
 EmJetAnalyzer::compute_alpha_gen(const reco::PFJet& ijet) const
 {
-  TLorentzVector jetVector;
-  jetVector.SetPtEtaPhiM(ijet.pt(),ijet.eta(),ijet.phi(),0.);
   // Calculate pt-sum of charged SM particles coming from prompt vertex vs any vertex
-  double prompt_sum = 0.;
-  double total_sum  = 0.;
-  {
-    if (!isData_) {
-      for (auto gp = genParticlesH_->begin(); gp != genParticlesH_->end(); ++gp) {
-        if ( (gp->status()==1) && (gp->charge()!=0) ) {
-          TLorentzVector gpVector;
-          gpVector.SetPtEtaPhiM(gp->pt(),gp->eta(),gp->phi(),gp->mass());
-          double dist = jetVector.DeltaR(gpVector);
-          if (dist > 0.4) continue;
-          if (gp->pt() < 1.0) continue;
-          total_sum += gp->pt();
-          double vr = TMath::Sqrt( gp->vx()*gp->vx() + gp->vy()*gp->vy() );
-          if (vr > 0.1) continue;
-          prompt_sum += gp->pt();
-        }
-      }
-    }
-  }
-  return prompt_sum/total_sum;
+  // Returns nan for data
+  if (isData_) return emjet::computeAlphaGen(reco::GenParticleCollection(), ijet.eta(), ijet.phi());
+  return emjet::computeAlphaGen(*genParticlesH_, ijet.eta(), ijet.phi());
 }
 
 // Calculate jet alphaMax based on dz matching between track and vertex
 double
 EmJetAnalyzer::compute_alphaMax_dz(reco::TrackRefVector& trackRefs, double max_dz, double max_dxy) const
 {
-  double alphaMax = -1.;
-  // Loop over all tracks and calculate scalar pt-sum of all tracks in current jet
-  double jet_pt_sum = 0.;
-  for (reco::TrackRefVector::iterator ijt = trackRefs.begin(); ijt != trackRefs.end(); ++ijt) {
-    jet_pt_sum += (*ijt)->pt();
-  } // End of track loop
-
-  auto ipv_chosen = primary_verticesH_->end(); // iterator to chosen primary vertex
-  double max_vertex_pt_sum = 0.; // scalar pt contribution of vertex to jet
-  // Loop over all PVs and choose the one with highest scalar pt contribution to jet
-  for (auto ipv = primary_verticesH_->begin(); ipv != primary_verticesH_->end(); ++ipv) {
-    double vertex_pt_sum = 0.; // scalar pt contribution of vertex to jet
-    for (reco::TrackRefVector::iterator ijt = trackRefs.begin(); ijt != trackRefs.end(); ++ijt) {
-      double dxy = (*ijt)->dxy(*theBeamSpot_);
-      double dz = (*ijt)->dz(ipv->position());
-      // OUTPUT(dz);
-      if ( fabs(dxy) < max_dxy && fabs(dz) < max_dz ) vertex_pt_sum += (*ijt)->pt();
-      // double trackWeight = ipv->trackWeight(*ijt);
-      // if (trackWeight > 0) vertex_pt_sum += (*ijt)->pt();
-    } // End of track loop
-    if (vertex_pt_sum > max_vertex_pt_sum) {
-      max_vertex_pt_sum = vertex_pt_sum;
-      ipv_chosen = ipv;
-    }
-  } // End of vertex loop
-  // Calculate alpha
-  alphaMax = max_vertex_pt_sum / jet_pt_sum;
-  return alphaMax;
+  const reco::BeamSpot& beamSpot = *theBeamSpot_;
+  return emjet::computeAlphaMax(trackRefs, *primary_verticesH_,
+                                [](const reco::TrackRef& trk) { return trk->pt(); },
+                                [&](const reco::Vertex& vtx, const reco::TrackRef& trk) {
+                                  return fabs(trk->dxy(beamSpot)) < max_dxy && fabs(trk->dz(vtx.position())) < max_dz;
+                                });
 }
 
 // Calculate jet alphaMax based on dz matching between track and vertex
 double
 EmJetAnalyzer::compute_alphaMax_dz(vector<reco::TransientTrack> tracks, double max_dz, double max_dxy) const
 {
-  double alphaMax = -1.;
-  // Loop over all tracks and calculate scalar pt-sum of all tracks in current jet
-  double jet_pt_sum = 0.;
-  for (auto ijt = tracks.begin(); ijt != tracks.end(); ++ijt) {
-    jet_pt_sum += (ijt)->track().pt();
-  } // End of track loop
-
-  auto ipv_chosen = primary_verticesH_->end(); // iterator to chosen primary vertex
-  double max_vertex_pt_sum = 0.; // scalar pt contribution of vertex to jet
-  // Loop over all PVs and choose the one with highest scalar pt contribution to jet
-  for (auto ipv = primary_verticesH_->begin(); ipv != primary_verticesH_->end(); ++ipv) {
-    double vertex_pt_sum = 0.; // scalar pt contribution of vertex to jet
-    for (auto ijt = tracks.begin(); ijt != tracks.end(); ++ijt) {
-      double dxy = (ijt)->track().dxy(*theBeamSpot_);
-      double dz = (ijt)->track().dz(ipv->position());
-      // OUTPUT(dz);
-      if ( fabs(dxy) < max_dxy && fabs(dz) < max_dz ) vertex_pt_sum += (ijt)->track().pt();
-      // double trackWeight = ipv->trackWeight(*ijt);
-      // if (trackWeight > 0) vertex_pt_sum += (*ijt)->track().pt();
-    } // End of track loop
-    if (vertex_pt_sum > max_vertex_pt_sum) {
-      max_vertex_pt_sum = vertex_pt_sum;
-      ipv_chosen = ipv;
-    }
-  } // End of vertex loop
-  // Calculate alpha
-  alphaMax = max_vertex_pt_sum / jet_pt_sum;
-  return alphaMax;
+  const reco::BeamSpot& beamSpot = *theBeamSpot_;
+  return emjet::computeAlphaMax(tracks, *primary_verticesH_,
+                                [](const reco::TransientTrack& trk) { return trk.track().pt(); },
+                                [&](const reco::Vertex& vtx, const reco::TransientTrack& trk) {
+                                  return fabs(trk.track().dxy(beamSpot)) < max_dxy && fabs(trk.track().dz(vtx.position())) < max_dz;
+                                });
 }
 
 // Calculate jet median theta2D in radians
@@ -2186,8 +2330,7 @@ EmJetAnalyzer::compute_theta2D(const edm::EventSetup& iSetup) const
 int
 EmJetAnalyzer::compute_nDarkPions(const reco::PFJet& ijet) const
 {
-  TLorentzVector jetVector;
-  jetVector.SetPtEtaPhiM(ijet.pt(),ijet.eta(),ijet.phi(),0.);
+  auto jetDirection = emjet::kin::EtaPhi::fromPtEtaPhi(ijet.pt(), ijet.eta(), ijet.phi());
   // Count number of dark pions
   int nDarkPions = 0;
   double minDist = 9999.;
@@ -2195,9 +2338,7 @@ EmJetAnalyzer::compute_nDarkPions(const reco::PFJet& ijet) const
     if (!isData_) {
       for (auto gp = genParticlesH_->begin(); gp != genParticlesH_->end(); ++gp) {
         if (fabs(gp->pdgId()) != 4900111) continue;
-        TLorentzVector gpVector;
-        gpVector.SetPtEtaPhiM(gp->pt(),gp->eta(),gp->phi(),gp->mass());
-        double dist = jetVector.DeltaR(gpVector);
+        double dist = emjet::kin::deltaR(jetDirection.eta, jetDirection.phi, gp->eta(), gp->phi());
         if (dist < 0.4) {
           nDarkPions++;
         }
@@ -2211,8 +2352,7 @@ EmJetAnalyzer::compute_nDarkPions(const reco::PFJet& ijet) const
 int
 EmJetAnalyzer::compute_nDarkGluons(const reco::PFJet& ijet) const
 {
-  TLorentzVector jetVector;
-  jetVector.SetPtEtaPhiM(ijet.pt(),ijet.eta(),ijet.phi(),0.);
+  auto jetDirection = emjet::kin::EtaPhi::fromPtEtaPhi(ijet.pt(), ijet.eta(), ijet.phi());
   // Count number of dark pions
   int nDarkPions = 0;
   double minDist = 9999.;
@@ -2220,9 +2360,7 @@ EmJetAnalyzer::compute_nDarkGluons(const reco::PFJet& ijet) const
     if (!isData_) {
       for (auto gp = genParticlesH_->begin(); gp != genParticlesH_->end(); ++gp) {
         if (fabs(gp->pdgId()) != 4900021) continue;
-        TLorentzVector gpVector;
-        gpVector.SetPtEtaPhiM(gp->pt(),gp->eta(),gp->phi(),gp->mass());
-        double dist = jetVector.DeltaR(gpVector);
+        double dist = emjet::kin::deltaR(jetDirection.eta, jetDirection.phi, gp->eta(), gp->phi());
         if (dist < 0.4) {
           nDarkPions++;
         }
@@ -2262,40 +2400,19 @@ EmJetAnalyzer::jetdump(reco::TrackRefVector& trackRefs) const
 void
 EmJetAnalyzer::jetscan(const reco::PFJet& ijet) {
   reco::TrackRefVector trackRefs = ijet.getTrackRefs();
-  scanJet_->push_back(ijet);
-  for (auto tref : trackRefs) {
-    scanJetTracks_->push_back(*tref);
+  if (scanJet_.get()) scanJet_->push_back(ijet);
+  if (scanJetTracks_.get()) {
+    for (auto tref : trackRefs) {
+      scanJetTracks_->push_back(*tref);
+    }
   }
+  if (!scanJetSelectedTracks_.get()) return;
   for (std::vector<reco::TransientTrack>::iterator itk = generalTracks_.begin(); itk != generalTracks_.end(); ++itk) {
     if ( !selectJetTrack(*itk, jet_, track_) ) continue; // :CUT: Apply Track selection
     scanJetSelectedTracks_->push_back(itk->track());
   }
 }
 
-double
-EmJetAnalyzer::compute_pt2Sum (const TransientVertex& ivertex) const {
-  auto vtx = reco::Vertex(ivertex);
-  // Modified from reco::Vertex::p4()
-  double sum = 0.;
-  double pt = 0.;
-  if(vtx.hasRefittedTracks()) {
-    for(std::vector<reco::Track>::const_iterator iter = vtx.refittedTracks().begin();
-        iter != vtx.refittedTracks().end(); ++iter) {
-      pt = iter->pt();
-      sum += pt*pt;
-    }
-  }
-  else
-    {
-      for(std::vector<reco::TrackBaseRef>::const_iterator iter = vtx.tracks_begin();
-          iter != vtx.tracks_end(); iter++) {
-        pt = (*iter)->pt();
-        sum += pt*pt;
-      }
-    }
-  return sum;
-}
-
 double
 EmJetAnalyzer::compute_alpha_global () const {
   return -999.999;
@@ -2335,29 +2452,23 @@ EmJetAnalyzer::compute_track_minVertexDz (const reco::TransientTrack& itrack) co
 }
 
 
-double
-EmJetAnalyzer::compute_btag(const reco::PFJet& ijet) const
+void
+EmJetAnalyzer::resolveJetConditions(const JetCorrectorParameters& jecUncParameters)
 {
+  JetCorrectionUncertainty jecUnc(jecUncParameters);
+  vector<int> tagIndex = associateJetTags(*selectedJets_, *bTagH_);
   const reco::JetTagCollection & bTags = *(bTagH_.product());
-  auto obj1 = &ijet;
-  TLorentzVector vector1; vector1.SetPxPyPzE(obj1->px(), obj1->py(), obj1->pz(), obj1->energy());
-  double btagValue = -999;
-  int nMatched = 0;
-  for (unsigned i = 0; i != bTags.size(); ++i) {
-    edm::RefToBase<reco::Jet> obj2 = bTags[i].first;
-    TLorentzVector vector2; vector2.SetPxPyPzE(obj2->px(), obj2->py(), obj2->pz(), obj2->energy());
-    double dr = vector1.DeltaR(vector2);
-    // OUTPUT(dr);
-    if (dr < 0.01) {
-      btagValue = bTags[i].second;
-      nMatched++;
-    }
-    // if (nMatched!=1) OUTPUT(nMatched);
-    // else OUTPUT(bTags[i].second);
+  jetConditions_.clear();
+  for (unsigned ijet = 0; ijet < selectedJets_->size(); ijet++) {
+    const auto& jet = (*selectedJets_)[ijet];
+    JetConditions conditions;
+    conditions.jec = jetCorrector_->correction(jet);
+    jecUnc.setJetEta(jet.eta());
+    jecUnc.setJetPt(jet.pt() * conditions.jec); // here you must use the CORRECTED jet pt
+    conditions.unc = jecUnc.getUncertainty(true);
+    conditions.csv = tagIndex[ijet]!=-1 ? bTags[tagIndex[ijet]].second : -999;
+    jetConditions_.push_back(conditions);
   }
-  // OUTPUT(nMatched);
-  if (nMatched==1) return btagValue;
-  else             return -999;
 }
 
 template <class T>
@@ -2397,22 +2508,22 @@ EmJetAnalyzer::vertexdump(DistanceResults result) const
   // std::cout << "--------------------------------\n";
   // std::cout << "GenToReco\n";
   for (auto distance: std::get<0>(result)) {
-    hist_LogVertexDistance_GenToReco_->Fill(TMath::Log10(distance));
+    histos_.fill(hist_LogVertexDistance_GenToReco_, TMath::Log10(distance));
     // OUTPUT(distance);
   }
   // std::cout << "RecoToGen\n";
   for (auto distance: std::get<2>(result)) {
-    hist_LogVertexDistance_RecoToGen_->Fill(TMath::Log10(distance));
+    histos_.fill(hist_LogVertexDistance_RecoToGen_, TMath::Log10(distance));
     // OUTPUT(distance);
   }
   // std::cout << "GenToReco\n";
   for (auto distance: std::get<1>(result)) {
-    hist_LogVertexDistance2D_GenToReco_->Fill(TMath::Log10(distance));
+    histos_.fill(hist_LogVertexDistance2D_GenToReco_, TMath::Log10(distance));
     // OUTPUT(distance);
   }
   // std::cout << "RecoToGen\n";
   for (auto distance: std::get<3>(result)) {
-    hist_LogVertexDistance2D_RecoToGen_->Fill(TMath::Log10(distance));
+    histos_.fill(hist_LogVertexDistance2D_RecoToGen_, TMath::Log10(distance));
     // OUTPUT(distance);
   }
 }
@@ -0,0 +1,209 @@
+// -*- C++ -*-
+//
+// Package:    EmergingJetAnalysis/EmJetAnalyzer
+// Class:      EmJetReplayExporter
+//
+/**\class EmJetReplayExporter EmJetReplayExporter.cc EmergingJetAnalysis/EmJetAnalyzer/plugins/EmJetReplayExporter.cc
+
+ Description: Write the inputs of EmJetAnalyzer to a compact replay snapshot
+
+ Implementation:
+     Writes generalTracks, primary vertices with track weights, beam spot, selected jets with track indices and b-tags,
+     secondary vertices and gen particles of each event to a ReplaySnapshot file, to be read by emjetReplay.
+     edm::one module, since all events are written sequentially to one file.
+*/
+
+// system include files
+#include <memory>
+#include <string>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "DataFormats/BeamSpot/interface/BeamSpot.h"
+#include "DataFormats/JetReco/interface/PFJet.h"
+#include "DataFormats/BTauReco/interface/JetTag.h"
+#include "DataFormats/HepMCCandidate/interface/GenParticle.h"
+#include "RecoVertex/PrimaryVertexProducer/interface/VertexHigherPtSquared.h"
+#include "TVector3.h"
+#include "TLorentzVector.h"
+
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/ReplaySnapshot.h"
+using std::vector;
+#include "EmergingJetAnalysis/EmJetAnalyzer/interface/EmJetAlgos.h"
+
+//
+// class declaration
+//
+
+class EmJetReplayExporter : public edm::one::EDAnalyzer<> {
+   public:
+      explicit EmJetReplayExporter(const edm::ParameterSet&);
+      ~EmJetReplayExporter() {}
+
+   private:
+      virtual void analyze(const edm::Event&, const edm::EventSetup&) override;
+
+      void fillVertex(const reco::Vertex& ivertex, emjet::replay::Vertex& overtex, edm::ProductID tracksID) const;
+
+      // ----------member data ---------------------------
+      bool isData_;
+      edm::EDGetTokenT<reco::TrackCollection> tracksToken_;
+      edm::EDGetTokenT<reco::VertexCollection> primaryVerticesToken_;
+      edm::EDGetTokenT<reco::VertexCollection> secondaryVerticesToken_;
+      edm::EDGetTokenT<reco::BeamSpot> beamSpotToken_;
+      edm::EDGetTokenT< edm::View<reco::PFJet> > jetsToken_;
+      edm::EDGetTokenT<reco::JetTagCollection> bTagsToken_;
+      edm::EDGetTokenT<reco::GenParticleCollection> genParticlesToken_;
+      emjet::replay::ReplayWriter writer_;
+      emjet::replay::Event event_; // Reused to avoid reallocation
+};
+
+EmJetReplayExporter::EmJetReplayExporter(const edm::ParameterSet& iConfig) :
+  isData_ ( iConfig.getParameter<bool>("isData") ),
+  tracksToken_            ( consumes<reco::TrackCollection>        (edm::InputTag("generalTracks")) ),
+  primaryVerticesToken_   ( consumes<reco::VertexCollection>       (edm::InputTag("offlinePrimaryVertices")) ),
+  secondaryVerticesToken_ ( consumes<reco::VertexCollection>       (iConfig.getUntrackedParameter<edm::InputTag>("srcSecondaryVertices", edm::InputTag("inclusiveSecondaryVertices"))) ),
+  beamSpotToken_          ( consumes<reco::BeamSpot>               (edm::InputTag("offlineBeamSpot")) ),
+  jetsToken_              ( consumes< edm::View<reco::PFJet> >     (iConfig.getParameter<edm::InputTag>("srcJets")) ),
+  bTagsToken_             ( consumes<reco::JetTagCollection>       (edm::InputTag("pfCombinedInclusiveSecondaryVertexV2BJetTags")) ),
+  writer_ ( iConfig.getUntrackedParameter<std::string>("fileName") )
+{
+  if (!isData_) genParticlesToken_ = consumes<reco::GenParticleCollection>(edm::InputTag("genParticles"));
+}
+
+void
+EmJetReplayExporter::fillVertex(const reco::Vertex& ivertex, emjet::replay::Vertex& overtex, edm::ProductID tracksID) const
+{
+  overtex.position_ = { float(ivertex.x()), float(ivertex.y()), float(ivertex.z()) };
+  overtex.error_ = { { float(ivertex.covariance(0,0)), float(ivertex.covariance(0,1)), float(ivertex.covariance(0,2)),
+                       float(ivertex.covariance(1,1)), float(ivertex.covariance(1,2)), float(ivertex.covariance(2,2)) } };
+  overtex.chi2   = ivertex.chi2();
+  overtex.ndof   = ivertex.ndof();
+  overtex.isFake = ivertex.isFake();
+  overtex.trackIndex.clear();
+  overtex.trackWeights.clear();
+  for (auto itk = ivertex.tracks_begin(); itk != ivertex.tracks_end(); ++itk) {
+    if (itk->id() != tracksID) continue; // Only references to generalTracks can be replayed
+    overtex.trackIndex.push_back(itk->key());
+    overtex.trackWeights.push_back(ivertex.trackWeight(*itk));
+  }
+}
+
+// ------------ method called for each event  ------------
+void
+EmJetReplayExporter::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
+{
+  emjet::replay::Event& event = event_;
+  event.run   = iEvent.id().run();
+  event.lumi  = iEvent.id().luminosityBlock();
+  event.event = iEvent.id().event();
+
+  edm::Handle<reco::BeamSpot> beamSpotH;
+  iEvent.getByToken(beamSpotToken_, beamSpotH);
+  event.beamSpot = { float(beamSpotH->x0()), float(beamSpotH->y0()), float(beamSpotH->z0()),
+                     float(beamSpotH->dxdz()), float(beamSpotH->dydz()),
+                     float(beamSpotH->sigmaZ()), float(beamSpotH->BeamWidthX()), float(beamSpotH->BeamWidthY()) };
+
+  edm::Handle<reco::TrackCollection> tracksH;
+  iEvent.getByToken(tracksToken_, tracksH);
+  event.tracks.resize(tracksH->size());
+  for (unsigned i = 0; i < tracksH->size(); i++) {
+    const reco::Track& itrack = (*tracksH)[i];
+    emjet::replay::Track& otrack = event.tracks[i];
+    for (int p = 0; p < 5; p++) otrack.parameters[p] = itrack.parameter(p);
+    int k = 0;
+    for (int p = 0; p < 5; p++) for (int q = 0; q <= p; q++) otrack.covariance[k++] = itrack.covariance(p, q);
+    otrack.referencePoint = { float(itrack.vx()), float(itrack.vy()), float(itrack.vz()) };
+    otrack.qualityMask = itrack.qualityMask();
+    otrack.charge_     = itrack.charge();
+    otrack.nValidHits  = itrack.numberOfValidHits();
+  }
+
+  // Leading primary vertex is chosen as in EmJetAnalyzer
+  edm::Handle<reco::VertexCollection> primaryVerticesH;
+  iEvent.getByToken(primaryVerticesToken_, primaryVerticesH);
+  event.primaryVertices.resize(primaryVerticesH->size());
+  event.primaryVertexIndex = -1;
+  double pt2sumMax = 0.;
+  VertexHigherPtSquared vertexPt2Calculator;
+  for (unsigned i = 0; i < primaryVerticesH->size(); i++) {
+    fillVertex((*primaryVerticesH)[i], event.primaryVertices[i], tracksH.id());
+    double pt2sum = vertexPt2Calculator.sumPtSquared((*primaryVerticesH)[i]);
+    if (pt2sum > pt2sumMax) {
+      pt2sumMax = pt2sum;
+      event.primaryVertexIndex = i;
+    }
+  }
+
+  edm::Handle<reco::VertexCollection> secondaryVerticesH;
+  iEvent.getByToken(secondaryVerticesToken_, secondaryVerticesH);
+  event.secondaryVertices.resize(secondaryVerticesH->size());
+  for (unsigned i = 0; i < secondaryVerticesH->size(); i++) {
+    fillVertex((*secondaryVerticesH)[i], event.secondaryVertices[i], tracksH.id());
+  }
+
+  edm::Handle< edm::View<reco::PFJet> > jetsH;
+  iEvent.getByToken(jetsToken_, jetsH);
+  edm::Handle<reco::JetTagCollection> bTagsH;
+  iEvent.getByToken(bTagsToken_, bTagsH);
+  vector<int> tagIndex = associateJetTags(*jetsH, *bTagsH);
+  event.jets.resize(jetsH->size());
+  for (unsigned i = 0; i < jetsH->size(); i++) {
+    const reco::PFJet& ijet = (*jetsH)[i];
+    emjet::replay::Jet& ojet = event.jets[i];
+    ojet.pt   = ijet.pt();
+    ojet.eta  = ijet.eta();
+    ojet.phi  = ijet.phi();
+    ojet.mass = ijet.mass();
+    ojet.cef  = ijet.chargedEmEnergyFraction()     ;
+    ojet.nef  = ijet.neutralEmEnergyFraction()     ;
+    ojet.chf  = ijet.chargedHadronEnergyFraction() ;
+    ojet.nhf  = ijet.neutralHadronEnergyFraction() ;
+    ojet.pef  = ijet.photonEnergyFraction()        ;
+    ojet.mef  = ijet.muonEnergyFraction()          ;
+    ojet.csv  = tagIndex[i]!=-1 ? (*bTagsH)[tagIndex[i]].second : -999;
+    ojet.trackIndex.clear();
+    reco::TrackRefVector trackRefs = ijet.getTrackRefs();
+    for (const auto& ref : trackRefs) {
+      if (ref.id() != tracksH.id()) continue; // Only references to generalTracks can be replayed
+      ojet.trackIndex.push_back(ref.key());
+    }
+  }
+
+  event.genParticles.clear();
+  if (!isData_) {
+    edm::Handle<reco::GenParticleCollection> genParticlesH;
+    iEvent.getByToken(genParticlesToken_, genParticlesH);
+    event.genParticles.resize(genParticlesH->size());
+    for (unsigned i = 0; i < genParticlesH->size(); i++) {
+      const reco::GenParticle& igp = (*genParticlesH)[i];
+      emjet::replay::GenParticle& ogp = event.genParticles[i];
+      ogp.pdgId_  = igp.pdgId();
+      ogp.status_ = igp.status();
+      ogp.charge_ = igp.charge();
+      ogp.pt_     = igp.pt();
+      ogp.eta_    = igp.eta();
+      ogp.phi_    = igp.phi();
+      ogp.mass_   = igp.mass();
+      ogp.vx_     = igp.vx();
+      ogp.vy_     = igp.vy();
+      ogp.vz_     = igp.vz();
+      ogp.firstDaughter = igp.numberOfDaughters()>0 ? int(igp.daughterRef(0).key()) : -1;
+    }
+  }
+
+  writer_.write(event);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(EmJetReplayExporter);
@@ -12,6 +12,20 @@ emJetAnalyzer = cms.EDFilter('EmJetAnalyzer',
         minweight = cms.double( 0.5 ),
         finder = cms.string( "avr" )
     ),
+    # Stored as bits of HLT_bits, in order. Wildcards match any version.
+    hltPaths = cms.vstring(
+        # EXO-16-003 Triggers
+        "HLT_HT250_DisplacedDijet40_DisplacedTrack_v*",
+        "HLT_HT350_DisplacedDijet40_DisplacedTrack_v*",
+        "HLT_HT400_DisplacedDijet40_Inclusive_v*",
+        "HLT_HT500_DisplacedDijet40_Inclusive_v*",
+        # Emerging Jets Analysis Triggers
+        "HLT_PFHT400_v*",
+        "HLT_PFHT475_v*",
+        "HLT_PFHT600_v*",
+        "HLT_PFHT800_v*",
+        "HLT_PFHT900_v*",
+    ),
     # scanJet = cms.bool(False),
     # scanJet = cms.
 )
@@ -0,0 +1,304 @@
+#!/usr/bin/env python
+"""Output-equivalence and throughput regression check for EmJetAnalyzer.
+
+Runs the analyzer on a pinned event sample, compares its output with a stored reference and writes a JSON report
+with events/s, per-stage time and peak RSS. Exits with status 1 if outputs diverge beyond tolerance or throughput
+drops by more than --max-slowdown w.r.t. the reference.
+
+Modes:
+  cmsrun : Configuration/test/test_cfg.py on AOD input files, compares every emJetTree branch
+           (per-stage time from the framework TimeReport, per module)
+  replay : emjetReplay on a replay snapshot (see EmJetReplayExporter), compares the dumped jet/vertex quantities
+           (per-stage time from emjetReplay)
+
+Usage:
+  # Create reference once (and after intended output changes)
+  emjetRegression.py --mode replay --input sample.bin --reference ref/ --update-reference
+  # Check
+  emjetRegression.py --mode replay --input sample.bin --reference ref/ [--report report.json]
+
+Tolerances: variables are matched against fnmatch patterns, first match wins, default otherwise.
+A value passes if |a-b| <= abs + rel*|b|. Override with --tolerances file.json, containing
+  {"default": {"rel": 1e-6, "abs": 1e-9}, "patterns": [["jet_alphaMax*", {"rel": 1e-5, "abs": 1e-7}], ...]}
+"""
+from __future__ import print_function
+import argparse
+import fnmatch
+import json
+import math
+import os
+import re
+import resource
+import shutil
+import subprocess
+import sys
+import time
+
+DEFAULT_TOLERANCES = {
+    "default": {"rel": 1e-6, "abs": 1e-9},
+    "patterns": [
+        # Event/object bookkeeping must match exactly
+        ["run", {"rel": 0., "abs": 0.}],
+        ["lumi", {"rel": 0., "abs": 0.}],
+        ["event", {"rel": 0., "abs": 0.}],
+        ["*_index", {"rel": 0., "abs": 0.}],
+        ["*_source", {"rel": 0., "abs": 0.}],
+        # Vertex fits and trajectory extrapolation are sensitive to floating point evaluation order
+        ["vertex_*", {"rel": 1e-4, "abs": 1e-6}],
+        ["track_innerHit_*", {"rel": 1e-4, "abs": 1e-6}],
+        ["track_pca_*", {"rel": 1e-4, "abs": 1e-6}],
+        ["track_ip*", {"rel": 1e-4, "abs": 1e-7}],
+        ["vtx_distance", {"rel": 1e-5, "abs": 1e-6}],
+    ],
+}
+
+# Columns of emjetReplay -d output
+NDZ = 21
+REPLAY_JET_COLUMNS = (["jet_alpha", "jet_alphaMax", "jet_alpha2", "jet_alphaMax2", "jet_alpha_gen"]
+                      + ["jet_alphaMax_dz%d" % i for i in range(NDZ)]
+                      + ["jet_alphaMax2_dz%d" % i for i in range(NDZ)])
+
+
+class Tolerances(object):
+    def __init__(self, config):
+        self.default = config["default"]
+        self.patterns = config.get("patterns", [])
+        self.cache = {}
+
+    def get(self, name):
+        if name not in self.cache:
+            self.cache[name] = self.default
+            for pattern, tol in self.patterns:
+                if fnmatch.fnmatch(name, pattern):
+                    self.cache[name] = tol
+                    break
+        return self.cache[name]
+
+    def equal(self, name, a, b):
+        if a == b: return True
+        a, b = float(a), float(b)
+        if math.isnan(a) and math.isnan(b): return True
+        tol = self.get(name)
+        return abs(a - b) <= tol["abs"] + tol["rel"] * abs(b)
+
+
+class Comparison(object):
+    """Per-variable mismatch counts"""
+    def __init__(self):
+        self.compared = {}
+        self.mismatched = {}
+        self.maxdiff = {}
+        self.errors = []
+
+    def add(self, name, a, b, tolerances):
+        self.compared[name] = self.compared.get(name, 0) + 1
+        if not tolerances.equal(name, a, b):
+            self.mismatched[name] = self.mismatched.get(name, 0) + 1
+            try:
+                diff = abs(float(a) - float(b))
+            except ValueError:
+                diff = float('inf')
+            self.maxdiff[name] = max(self.maxdiff.get(name, 0.), diff)
+
+    def ok(self):
+        return not self.mismatched and not self.errors
+
+    def summary(self):
+        return {
+            "variables": len(self.compared),
+            "values": sum(self.compared.values()),
+            "mismatched": dict((k, {"count": v, "maxAbsDiff": self.maxdiff[k]}) for k, v in self.mismatched.items()),
+            "errors": self.errors,
+        }
+
+
+def flatten(value):
+    """Flatten ROOT vectors (and vectors of vectors) into a list of numbers"""
+    if isinstance(value, (int, float, bool)) or hasattr(value, '__float__'):
+        return [value]
+    out = []
+    for v in value:
+        out.extend(flatten(v))
+    return out
+
+
+def compare_trees(filename, reference, tolerances, treename="emJetAnalyzer/emJetTree"):
+    import ROOT
+    result = Comparison()
+    f, fref = ROOT.TFile.Open(filename), ROOT.TFile.Open(reference)
+    tree, treeref = f.Get(treename), fref.Get(treename)
+    if not tree or not treeref:
+        result.errors.append("%s missing in output or reference" % treename)
+        return result
+    branches = set(b.GetName() for b in tree.GetListOfBranches())
+    branchesref = set(b.GetName() for b in treeref.GetListOfBranches())
+    for name in sorted(branchesref - branches): result.errors.append("branch %s missing in output" % name)
+    for name in sorted(branches - branchesref): result.errors.append("branch %s not in reference" % name)
+    if tree.GetEntries() != treeref.GetEntries():
+        result.errors.append("entries differ: %d vs reference %d" % (tree.GetEntries(), treeref.GetEntries()))
+        return result
+    common = sorted(branches & branchesref)
+    for ientry in range(tree.GetEntries()):
+        tree.GetEntry(ientry)
+        treeref.GetEntry(ientry)
+        for name in common:
+            values, valuesref = flatten(getattr(tree, name)), flatten(getattr(treeref, name))
+            if len(values) != len(valuesref):
+                result.errors.append("entry %d: %s has %d values, reference %d" % (ientry, name, len(values), len(valuesref)))
+                continue
+            for a, b in zip(values, valuesref):
+                result.add(name, a, b, tolerances)
+    return result
+
+
+def compare_dumps(filename, reference, tolerances):
+    result = Comparison()
+    with open(filename) as f: lines = f.read().splitlines()
+    with open(reference) as f: linesref = f.read().splitlines()
+    if len(lines) != len(linesref):
+        result.errors.append("%d lines, reference %d" % (len(lines), len(linesref)))
+        return result
+    for line, lineref in zip(lines, linesref):
+        fields, fieldsref = line.split(), lineref.split()
+        # Record type, run, lumi, event (and jet index) identify the line
+        nkey = 5 if fields[0] == "jet" else 4
+        if fields[:nkey] != fieldsref[:nkey] or len(fields) != len(fieldsref):
+            result.errors.append("line mismatch: '%s' vs reference '%s'" % (" ".join(fields[:nkey]), " ".join(fieldsref[:nkey])))
+            continue
+        for i, (a, b) in enumerate(zip(fields[nkey:], fieldsref[nkey:])):
+            name = REPLAY_JET_COLUMNS[i] if fields[0] == "jet" else "vtx_distance"
+            result.add(name, a, b, tolerances)
+    return result
+
+
+def run_timed(cmd, logfile, stdout=None):
+    """Run cmd, return wall time in seconds. stderr (and stdout unless given) go to logfile"""
+    print("Running: %s" % " ".join(cmd))
+    start = time.time()
+    with open(logfile, "w") as log:
+        status = subprocess.call(cmd, stdout=(stdout or log), stderr=log)
+    seconds = time.time() - start
+    if status != 0:
+        sys.exit("Command failed with status %d, see %s" % (status, logfile))
+    return seconds
+
+
+def run_cmsrun(args, workdir):
+    cfg = os.path.join(os.environ.get("CMSSW_BASE", ""), "src/EmergingJetAnalysis/Configuration/test/test_cfg.py")
+    inputs = ["inputFiles=%s" % (f if ":" in f else "file:" + os.path.abspath(f)) for f in args.input]
+    cmd = ["cmsRun", cfg] + inputs + ["maxEvents=%d" % args.events, "data=%d" % args.data, "wantSummary=1", "outputLabel=regression"]
+    log = os.path.join(workdir, "cmsRun.log")
+    cwd = os.getcwd()
+    os.chdir(workdir)
+    try:
+        seconds = run_timed(cmd, log)
+    finally:
+        os.chdir(cwd)
+    with open(log) as f: text = f.read()
+    m = re.search(r"TrigReport Events total = (\d+)", text)
+    events = int(m.group(1)) if m else 0
+    # TimeReport module summary lines: per event, per exec, per visit, module label
+    stages = {}
+    in_modules = False
+    for line in text.splitlines():
+        if "Module Summary" in line: in_modules = True; continue
+        if in_modules:
+            fields = line.split()
+            if len(fields) != 5 or fields[0] != "TimeReport":
+                if stages: in_modules = False
+                continue
+            try:
+                stages[fields[4]] = float(fields[1]) * events
+            except ValueError:
+                pass
+    return seconds, events, stages, os.path.join(workdir, "ntuple-regression.root")
+
+
+def run_replay(args, workdir):
+    output = os.path.join(workdir, "replay.txt")
+    cmd = ["emjetReplay", "-d"] + (["-n", str(args.events)] if args.events > 0 else []) + [args.input[0]]
+    log = os.path.join(workdir, "emjetReplay.log")
+    with open(output, "w") as out:
+        seconds = run_timed(cmd, log, stdout=out)
+    with open(log) as f: text = f.read()
+    m = re.search(r"emjetReplay: (\d+) events", text)
+    events = int(m.group(1)) if m else 0
+    stages = dict((name, float(value)) for name, value in re.findall(r"emjetReplay: stage (\w+) ([0-9.eE+-]+) s", text))
+    return seconds, events, stages, output
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--mode", choices=["cmsrun", "replay"], default="replay")
+    parser.add_argument("--input", nargs="+", required=True, help="AOD file(s) for cmsrun, snapshot for replay")
+    parser.add_argument("--events", type=int, default=-1, help="Maximum number of events (-1: all)")
+    parser.add_argument("--data", type=int, default=0, help="Set to 1 for data (cmsrun mode)")
+    parser.add_argument("--reference", required=True, help="Directory with reference output and report")
+    parser.add_argument("--workdir", default="regression", help="Directory for output, logs and report")
+    parser.add_argument("--report", default=None, help="Report file (default: <workdir>/report.json)")
+    parser.add_argument("--tolerances", default=None, help="JSON file overriding default tolerances")
+    parser.add_argument("--max-slowdown", type=float, default=0.10, help="Maximum allowed relative drop in events/s")
+    parser.add_argument("--update-reference", action="store_true", help="Store this run as the new reference")
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.workdir): os.makedirs(args.workdir)
+    tolerances = DEFAULT_TOLERANCES
+    if args.tolerances:
+        with open(args.tolerances) as f: tolerances = json.load(f)
+    tolerances = Tolerances(tolerances)
+
+    if args.mode == "cmsrun":
+        seconds, events, stages, output = run_cmsrun(args, args.workdir)
+    else:
+        seconds, events, stages, output = run_replay(args, args.workdir)
+    peak_rss_kb = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+
+    report = {
+        "mode": args.mode,
+        "input": args.input,
+        "events": events,
+        "seconds": seconds,
+        "eventsPerSecond": events / seconds if seconds > 0 else 0.,
+        "stageSeconds": stages,
+        "peakRSSkB": peak_rss_kb,
+    }
+    referenceOutput = os.path.join(args.reference, os.path.basename(output))
+    referenceReport = os.path.join(args.reference, "report.json")
+
+    if args.update_reference:
+        if not os.path.isdir(args.reference): os.makedirs(args.reference)
+        shutil.copy(output, referenceOutput)
+        report["status"] = "reference"
+        with open(referenceReport, "w") as f: json.dump(report, f, indent=2, sort_keys=True)
+        print("Stored reference in %s" % args.reference)
+        return 0
+
+    failures = []
+    if args.mode == "cmsrun":
+        comparison = compare_trees(output, referenceOutput, tolerances)
+    else:
+        comparison = compare_dumps(output, referenceOutput, tolerances)
+    report["comparison"] = comparison.summary()
+    if not comparison.ok():
+        failures.append("outputs differ from reference")
+    with open(referenceReport) as f: ref = json.load(f)
+    report["referenceEventsPerSecond"] = ref["eventsPerSecond"]
+    if ref["eventsPerSecond"] > 0 and report["eventsPerSecond"] < (1. - args.max_slowdown) * ref["eventsPerSecond"]:
+        failures.append("throughput %.3g events/s below reference %.3g events/s by more than %d%%"
+                        % (report["eventsPerSecond"], ref["eventsPerSecond"], 100 * args.max_slowdown))
+    report["failures"] = failures
+    report["status"] = "fail" if failures else "pass"
+
+    reportfile = args.report or os.path.join(args.workdir, "report.json")
+    with open(reportfile, "w") as f: json.dump(report, f, indent=2, sort_keys=True)
+    print("%.1f events/s (reference %.1f), peak RSS %d kB" % (report["eventsPerSecond"], ref["eventsPerSecond"], peak_rss_kb))
+    for name, info in sorted(comparison.summary()["mismatched"].items()):
+        print("  %s: %d values differ, max |diff| %g" % (name, info["count"], info["maxAbsDiff"]))
+    for error in comparison.errors[:20]: print("  " + error)
+    print("Regression %s, report in %s" % (report["status"].upper(), reportfile))
+    for failure in failures: print("  " + failure)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
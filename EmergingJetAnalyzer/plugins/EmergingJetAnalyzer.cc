@@ -80,6 +80,7 @@ Implementation:
 #include "TStopwatch.h"
 
 #include "EmergingJetAnalysis/EmergingJetAnalyzer/interface/OutputTree.h"
+#include "EmergingJetAnalysis/Utils/interface/Kinematics.h"
 //
 // class declaration
 //
@@ -133,11 +134,11 @@ class EmergingJetAnalyzer : public edm::EDAnalyzer {
     reco::VertexCollection selectedSecondaryVertices_;
     std::vector<TransientVertex> avrVertices_;
     edm::Handle<reco::GenJetCollection> genJets_;
-    std::vector<GlobalPoint> dt_points_;
-    std::vector<GlobalPoint> csc_points_;
+    emjet::kin::EtaPhiArray dt_points_; // Directions of DT segment positions
+    emjet::kin::EtaPhiArray csc_points_; // Directions of CSC segment positions
 
     // Calculate once per jet
-    TLorentzVector jetVector_;
+    emjet::kin::EtaPhi jetDirection_;
 
     bool isData_;
 
@@ -389,7 +390,7 @@ EmergingJetAnalyzer::analyze(const edm::Event& iEvent, const edm::EventSetup& iS
     for (auto iseg = segments4D->begin(); iseg != segments4D->end(); ++iseg) {
       const GeomDet* geomDet = theTrackingGeometry->idToDet((*iseg).geographicalId());
       segpos = geomDet->toGlobal((*iseg).localPosition());
-      dt_points_.push_back(segpos);
+      dt_points_.push_back(emjet::kin::EtaPhi::fromPosition(segpos));
     }
 
     Handle<CSCSegmentCollection> csc_segments;
@@ -399,7 +400,7 @@ EmergingJetAnalyzer::analyze(const edm::Event& iEvent, const edm::EventSetup& iS
     for (auto icsc = csc_segments->begin(); icsc != csc_segments->end(); ++icsc) {
       const GeomDet* geomDet = theTrackingGeometry->idToDet((*icsc).geographicalId());
       segpos = geomDet->toGlobal((*icsc).localPosition());
-      csc_points_.push_back(segpos);
+      csc_points_.push_back(emjet::kin::EtaPhi::fromPosition(segpos));
     }
 
     Handle<RPCRecHitCollection> rpc_hits;
@@ -516,7 +517,7 @@ void
 EmergingJetAnalyzer::fillSingleJet(const reco::PFJet& jet, int jet_index) {
   // Shared objects
   const reco::Vertex& primary_vertex = primary_verticesH_->at(0);
-  jetVector_.SetPtEtaPhiM(jet.pt(),jet.eta(),jet.phi(),0.);
+  jetDirection_ = emjet::kin::EtaPhi::fromPtEtaPhi(jet.pt(), jet.eta(), jet.phi());
   // std::cout << "jet.pt(): " << jet.pt() << std::endl;
   const float maxSigPromptTrack = 3.;
   const float minSigDispTrack = 3.;
@@ -649,16 +650,14 @@ EmergingJetAnalyzer::fillSingleJet(const reco::PFJet& jet, int jet_index) {
       GlobalVector pcaToJet = jetLine.distance(closestPoint);
       double distanceToJet = pcaToJet.mag();
 
-      TLorentzVector trackVector;
-      trackVector.SetPxPyPzE(
+      auto pcaDirection = emjet::kin::EtaPhi::fromXYZ(
           closestPoint.x() - primary_vertex.position().x(),
           closestPoint.y() - primary_vertex.position().y(),
-          closestPoint.z() - primary_vertex.position().z(),
-          itk->track().p());
+          closestPoint.z() - primary_vertex.position().z());
 
 
       // Skip tracks with deltaR > 0.4 w.r.t. current jet :CUT:
-      float deltaR = trackVector.DeltaR(jetVector_);
+      float deltaR = emjet::kin::deltaR(pcaDirection, jetDirection_);
       // if (itrack==1) std::cout << "deltaR: " << deltaR << std::endl;
       if (deltaR > 0.4) continue;
       float dRToJetAxis = deltaR;
@@ -800,9 +799,7 @@ EmergingJetAnalyzer::fillSingleJet(const reco::PFJet& jet, int jet_index) {
         //                   std::cout << "             mass = " << gp->mass() << std::endl;
         //                   std::cout << "               pT = " << gp->pt()   << std::endl;
         //                   std::cout << "      r, eta, phi = " << gp->vertex().r() << "\t" << gp->vertex().eta() << "\t" << gp->vertex().phi() << std::endl;
-        TLorentzVector gpVector;
-        gpVector.SetPtEtaPhiM(gp->pt(),gp->eta(),gp->phi(),gp->mass());
-        double dist = jetVector_.DeltaR(gpVector);
+        double dist = emjet::kin::deltaR(jetDirection_.eta, jetDirection_.phi, gp->eta(), gp->phi());
         if (dist < 0.4) {
           nDarkPions++;
         }
@@ -815,30 +812,18 @@ EmergingJetAnalyzer::fillSingleJet(const reco::PFJet& jet, int jet_index) {
   if (!isData_) {
     // Find out if there is a GenJet with deltaR < 0.2 relative to current jet
     for ( auto igj = genJets_->begin(); igj != genJets_->end(); ++igj) {
-      TLorentzVector gjVector;
-      gjVector.SetPtEtaPhiM(igj->pt(), igj->eta(), igj->phi(), 0.);
-      if (gjVector.DeltaR(jetVector_) < 0.2) {
+      if (emjet::kin::deltaR(jetDirection_.eta, jetDirection_.phi, igj->eta(), igj->phi()) < 0.2) {
         matched = true;
         break;
       }
     }
   }
 
-  int dtHits = 0;
   // Count DT hits with position vector that has deltaR < 0.5 relative to current jet
-  for (std::vector<GlobalPoint>::iterator idt = dt_points_.begin(); idt != dt_points_.end(); ++idt) {
-    TLorentzVector pointVector;
-    pointVector.SetPtEtaPhiM(idt->perp(), idt->eta(), idt->phi(), 0.);
-    if (pointVector.DeltaR(jetVector_) < 0.5) ++dtHits;
-  }
+  int dtHits = dt_points_.countWithin(jetDirection_.eta, jetDirection_.phi, 0.5);
 
-  int cscHits = 0;
   // Count CSC hits with position vector that has deltaR < 0.5 relative to current jet
-  for (std::vector<GlobalPoint>::iterator icp = csc_points_.begin(); icp != csc_points_.end(); ++icp) {
-    TLorentzVector pointVector;
-    pointVector.SetPtEtaPhiM(icp->perp(), icp->eta(), icp->phi(), 0.);
-    if (pointVector.DeltaR(jetVector_) < 0.5) ++cscHits;
-  }
+  int cscHits = csc_points_.countWithin(jetDirection_.eta, jetDirection_.phi, 0.5);
 
   // Calculate number of vertices within jet cone, and median of displacement
   int matchedVertices = 0;
@@ -847,8 +832,7 @@ EmergingJetAnalyzer::fillSingleJet(const reco::PFJet& jet, int jet_index) {
     std::vector<float> radiusVector;
     // Loop over a given vertex vector/collection
     for (reco::VertexCollection::iterator ivtx = selectedSecondaryVertices_.begin(); ivtx != selectedSecondaryVertices_.end(); ++ivtx) {
-      TLorentzVector vertexPosition;  vertexPosition.SetPtEtaPhiM(ivtx->position().r(),ivtx->position().eta(),ivtx->position().phi(),0.);
-      if (vertexPosition.DeltaR(jetVector_) < 0.4) ++matchedVertices;
+      if (emjet::kin::deltaR(emjet::kin::EtaPhi::fromPosition(ivtx->position()), jetDirection_) < 0.4) ++matchedVertices;
       if (ivtx->normalizedChi2() > 15.) continue;
       radiusVector.push_back(ivtx->position().r());
       TLorentzVector cand;
@@ -886,11 +870,9 @@ EmergingJetAnalyzer::fillSingleJet(const reco::PFJet& jet, int jet_index) {
     for (TransientVertex vertex: avrVertices_) {
       int source = 1; // For AVR vertices
       auto vtx = reco::Vertex(vertex);
-      TLorentzVector vertexVector;
-      vertexVector.SetXYZT(vtx.x(), vtx.y(), vtx.z(), 0.0);
       // Ignore vertices outside jet cone
-      double deltaR = vertexVector.DeltaR(jetVector_) > 0.4;
-      if (deltaR) continue;
+      double deltaR = emjet::kin::deltaR(emjet::kin::EtaPhi::fromPosition(vtx), jetDirection_);
+      if (deltaR > 0.4) continue;
       double Lxy = 0;
       float dx = primary_vertex.position().x() - vtx.position().x();
       float dy = primary_vertex.position().y() - vtx.position().y();
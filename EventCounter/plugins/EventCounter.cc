@@ -5,10 +5,12 @@
 // 
 /**\class EventCounter EventCounter.cc EmergingJetAnalysis/EventCounter/plugins/EventCounter.cc
 
- Description: [one line class summary]
+ Description: Count events reaching this point of a path, in total and per luminosity block
 
  Implementation:
-     [Notes on implementation]
+     Fills a histogram with the number of events, and writes the number of events and sums of generator weights of
+     each luminosity block to the lumiSummary tree (Utils/interface/LumiSummary.h), aggregated by emjetLumiSummary.
+     Counts are accumulated per stream and added to the luminosity block summary at the end of each block.
 */
 //
 // Original Author:  Young Ho Shin
@@ -19,13 +21,15 @@
 
 // system include files
 #include <memory>
+#include <mutex>
 #include <string>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 
 #include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
@@ -37,6 +41,12 @@
 #include "TH2.h"
 #include "TTree.h"
 
+#include "SimDataFormats/GeneratorProducts/interface/GenEventInfoProduct.h"
+
+#include "EmergingJetAnalysis/Utils/interface/HistogramRegistry.h"
+#include "EmergingJetAnalysis/Utils/interface/LumiSummary.h"
+#include "EmergingJetAnalysis/Utils/interface/TreeCollector.h"
+
 // Namespace shorthands
 using std::string;
 
@@ -44,7 +54,8 @@ using std::string;
 // class declaration
 //
 
-class EventCounter : public edm::EDAnalyzer {
+class EventCounter : public edm::global::EDAnalyzer< edm::StreamCache<emjet::LumiCounts>,
+                                                     edm::LuminosityBlockSummaryCache<emjet::LumiCounts> > {
    public:
       explicit EventCounter(const edm::ParameterSet&);
       ~EventCounter();
@@ -54,16 +65,22 @@ class EventCounter : public edm::EDAnalyzer {
 
    private:
       virtual void beginJob() override;
-      virtual void analyze(const edm::Event&, const edm::EventSetup&) override;
+      virtual void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
       virtual void endJob() override;
 
       //virtual void beginRun(edm::Run const&, edm::EventSetup const&) override;
       //virtual void endRun(edm::Run const&, edm::EventSetup const&) override;
-      //virtual void beginLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) override;
-      //virtual void endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) override;
+      virtual std::unique_ptr<emjet::LumiCounts> beginStream(edm::StreamID) const override;
+      virtual std::shared_ptr<emjet::LumiCounts> globalBeginLuminosityBlockSummary(edm::LuminosityBlock const&, edm::EventSetup const&) const override;
+      virtual void streamEndLuminosityBlockSummary(edm::StreamID, edm::LuminosityBlock const&, edm::EventSetup const&, emjet::LumiCounts*) const override;
+      virtual void globalEndLuminosityBlockSummary(edm::LuminosityBlock const&, edm::EventSetup const&, emjet::LumiCounts*) const override;
 
       // ----------member data ---------------------------
-      TH1D* hist_EventCount;
+      mutable emjet::HistogramRegistry histos_; // Filled concurrently from analyze()
+      emjet::HistogramRegistry::H1 hist_EventCount;
+      edm::EDGetTokenT<GenEventInfoProduct> genEventInfoToken_; // Missing for data, weight 1
+      TTree* lumiTree_;
+      mutable emjet::LumiSummaryRow lumiRow_; // Bound to lumiTree_ branches, only accessed under emjet::treeCollectorMutex()
 
 };
 
@@ -78,14 +95,15 @@ class EventCounter : public edm::EDAnalyzer {
 //
 // constructors and destructor
 //
-EventCounter::EventCounter(const edm::ParameterSet& iConfig)
-
+EventCounter::EventCounter(const edm::ParameterSet& iConfig) :
+  genEventInfoToken_ ( consumes<GenEventInfoProduct>(iConfig.getUntrackedParameter<edm::InputTag>("genEventInfo", edm::InputTag("generator"))) )
 {
   //now do what ever initialization is needed
-  edm::Service<TFileService> fs;
   string name = iConfig.getParameter<string>("@module_label");
-  hist_EventCount = fs->make<TH1D>(name.c_str() , name.c_str() , 2 , 0., 2.);
-
+  hist_EventCount = histos_.book1D(name, name, 2, 0., 2.);
+  edm::Service<TFileService> fs;
+  lumiTree_ = fs->make<TTree>(emjet::LumiSummaryRow::treeName(), emjet::LumiSummaryRow::treeName());
+  lumiRow_.Branch(lumiTree_);
 }
 
 
@@ -104,10 +122,15 @@ EventCounter::~EventCounter()
 
 // ------------ method called for each event  ------------
 void
-EventCounter::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
+EventCounter::analyze(edm::StreamID iStream, const edm::Event& iEvent, const edm::EventSetup& iSetup) const
 {
   using namespace edm;
-  hist_EventCount->Fill(1.0);
+  histos_.fill(hist_EventCount, 1.0);
+
+  double weight = 1.;
+  Handle<GenEventInfoProduct> genEventInfo;
+  if (iEvent.getByToken(genEventInfoToken_, genEventInfo)) weight = genEventInfo->weight();
+  streamCache(iStream)->fill(weight);
 
 
 
@@ -133,6 +156,7 @@ EventCounter::beginJob()
 void 
 EventCounter::endJob() 
 {
+  histos_.merge();
 }
 
 // ------------ method called when starting to processes a run  ------------
@@ -151,21 +175,39 @@ EventCounter::endRun(edm::Run const&, edm::EventSetup const&)
 }
 */
 
+// ------------ method called once for each stream, to create its counts  ------------
+std::unique_ptr<emjet::LumiCounts>
+EventCounter::beginStream(edm::StreamID) const
+{
+  return std::unique_ptr<emjet::LumiCounts>(new emjet::LumiCounts);
+}
+
 // ------------ method called when starting to processes a luminosity block  ------------
-/*
-void 
-EventCounter::beginLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&)
+std::shared_ptr<emjet::LumiCounts>
+EventCounter::globalBeginLuminosityBlockSummary(edm::LuminosityBlock const&, edm::EventSetup const&) const
 {
+  return std::make_shared<emjet::LumiCounts>();
+}
+
+// ------------ method called when a stream is done with a luminosity block, calls are serialized  ------------
+void
+EventCounter::streamEndLuminosityBlockSummary(edm::StreamID iStream, edm::LuminosityBlock const&, edm::EventSetup const&, emjet::LumiCounts* summary) const
+{
+  summary->add(*streamCache(iStream));
+  *streamCache(iStream) = emjet::LumiCounts();
 }
-*/
 
 // ------------ method called when ending the processing of a luminosity block  ------------
-/*
-void 
-EventCounter::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&)
+void
+EventCounter::globalEndLuminosityBlockSummary(edm::LuminosityBlock const& iLumi, edm::EventSetup const&, emjet::LumiCounts* summary) const
 {
+  // Same lock as the TreeCollector trees of other modules, all trees are written to the TFileService file
+  std::lock_guard<std::mutex> lock(emjet::treeCollectorMutex());
+  lumiRow_.run = iLumi.run();
+  lumiRow_.lumi = iLumi.luminosityBlock();
+  lumiRow_.counts = *summary;
+  lumiTree_->Fill();
 }
-*/
 
 // ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
 void
@@ -0,0 +1,76 @@
+// -*- C++ -*-
+//
+// Package:    EmergingJetAnalysis/EventCounter
+// Class:      EventIndexWriter
+//
+/**\class EventIndexWriter EventIndexWriter.cc EmergingJetAnalysis/EventCounter/plugins/EventIndexWriter.cc
+
+ Description: Write the (run, lumi, event) of events passing a skim to an event index next to the skimmed EDM file
+
+ Implementation:
+     Placed at the end of the skim path, so that it sees the same events as the PoolOutputModule selecting that path.
+     Entries are recorded as EventIndex::kNoEntry, since PoolSource jumps to events through the file's own index
+     (eventsToProcess) and only the file is needed. emjetEventIndex build adds exact Events tree entries if wanted.
+     edm::one module, since all events are recorded in one index.
+*/
+
+// system include files
+#include <iostream>
+#include <memory>
+#include <string>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "EmergingJetAnalysis/Utils/interface/EventIndex.h"
+
+//
+// class declaration
+//
+
+class EventIndexWriter : public edm::one::EDAnalyzer<> {
+   public:
+      explicit EventIndexWriter(const edm::ParameterSet&);
+      ~EventIndexWriter() {}
+
+   private:
+      virtual void analyze(const edm::Event&, const edm::EventSetup&) override;
+      virtual void endJob() override;
+
+      // ----------member data ---------------------------
+      std::string outputFile_; // EDM file the events are written to
+      std::string indexName_;
+      emjet::EventIndex index_;
+};
+
+EventIndexWriter::EventIndexWriter(const edm::ParameterSet& iConfig) :
+  outputFile_ ( iConfig.getUntrackedParameter<std::string>("outputFile") ),
+  indexName_  ( iConfig.getUntrackedParameter<std::string>("fileName", "") )
+{
+  if (outputFile_.compare(0, 5, "file:") == 0) outputFile_.erase(0, 5);
+  if (indexName_.empty()) indexName_ = emjet::EventIndex::sidecarName(outputFile_);
+  // Index is written next to the EDM file, refer to it without directory
+  outputFile_ = outputFile_.substr(outputFile_.rfind('/') + 1);
+}
+
+void
+EventIndexWriter::analyze(const edm::Event& iEvent, const edm::EventSetup&)
+{
+  index_.Add(iEvent.id().run(), iEvent.id().luminosityBlock(), iEvent.id().event(), outputFile_);
+}
+
+void
+EventIndexWriter::endJob()
+{
+  index_.Write(indexName_);
+  std::cout << "EventIndexWriter: wrote " << index_.size() << " events to " << indexName_ << std::endl;
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(EventIndexWriter);
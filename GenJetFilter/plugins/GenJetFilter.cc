@@ -22,7 +22,7 @@ Implementation:
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
-#include "FWCore/Framework/interface/EDFilter.h"
+#include "FWCore/Framework/interface/global/EDFilter.h"
 
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
@@ -37,7 +37,7 @@ Implementation:
 // class declaration
 //
 
-class GenJetFilter : public edm::EDFilter {
+class GenJetFilter : public edm::global::EDFilter<> {
   public:
     explicit GenJetFilter(const edm::ParameterSet&);
     ~GenJetFilter();
@@ -46,7 +46,7 @@ class GenJetFilter : public edm::EDFilter {
 
   private:
     virtual void beginJob() override;
-    virtual bool filter(edm::Event&, const edm::EventSetup&) override;
+    virtual bool filter(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
     virtual void endJob() override;
 
     edm::EDGetTokenT< reco::GenJetCollection > jetCollectionToken_;
@@ -94,15 +94,15 @@ GenJetFilter::~GenJetFilter()
 
 // ------------ method called on each new Event  ------------
   bool
-GenJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
+GenJetFilter::filter(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
 {
   using namespace edm;
   edm::Handle< reco::GenJetCollection > jetCollection;
   iEvent.getByToken(jetCollectionToken_, jetCollection);
-  auto jets = *(jetCollection.product());
+  const auto& jets = *(jetCollection.product());
 
   double genHt = 0;
-  for ( auto jet : jets ) {
+  for ( const auto& jet : jets ) {
   // for ( auto jet = jets->begin(); jet != jets->end(); jet++ ) {
     if ( jet.pt() > minPt_ ) {
       genHt += jet.pt();
@@ -41,6 +41,8 @@
 #include "TMath.h"
 #include "TLorentzVector.h"
 
+#include "EmergingJetAnalysis/Utils/interface/HistogramRegistry.h"
+
 //
 // class declaration
 //
@@ -93,24 +95,25 @@ private:
   edm::Service<TFileService> fs;
   TFile* ofile_;
   TTree* tree_;
+  emjet::HistogramRegistry histos_;
   // Dark pion histograms
-  TH1F* hist_nDarkPion_;
-  TH1F* hist_pt_DarkPion_;
-  TH1F* hist_nDaughter_DarkPion_;
-  TH1F* hist_pt_Daughter_DarkPion_;
-  TH1F* hist_pdgId_Daughter_DarkPion_;
-  TH1F* hist_nStableDaughter_DarkPion_;
-  TH1F* hist_pt_StableDaughter_DarkPion_;
-  TH1F* hist_pdgId_StableDaughter_DarkPion_;
+  emjet::HistogramRegistry::H1 hist_nDarkPion_;
+  emjet::HistogramRegistry::H1 hist_pt_DarkPion_;
+  emjet::HistogramRegistry::H1 hist_nDaughter_DarkPion_;
+  emjet::HistogramRegistry::H1 hist_pt_Daughter_DarkPion_;
+  emjet::HistogramRegistry::H1 hist_pdgId_Daughter_DarkPion_;
+  emjet::HistogramRegistry::H1 hist_nStableDaughter_DarkPion_;
+  emjet::HistogramRegistry::H1 hist_pt_StableDaughter_DarkPion_;
+  emjet::HistogramRegistry::H1 hist_pdgId_StableDaughter_DarkPion_;
   // Dark rho histograms
-  TH1F* hist_nDarkRho_;
-  TH1F* hist_pt_DarkRho_;
-  TH1F* hist_nDaughter_DarkRho_;
-  TH1F* hist_pt_Daughter_DarkRho_;
-  TH1F* hist_pdgId_Daughter_DarkRho_;
-  TH1F* hist_nStableDaughter_DarkRho_;
-  TH1F* hist_pt_StableDaughter_DarkRho_;
-  TH1F* hist_pdgId_StableDaughter_DarkRho_;
+  emjet::HistogramRegistry::H1 hist_nDarkRho_;
+  emjet::HistogramRegistry::H1 hist_pt_DarkRho_;
+  emjet::HistogramRegistry::H1 hist_nDaughter_DarkRho_;
+  emjet::HistogramRegistry::H1 hist_pt_Daughter_DarkRho_;
+  emjet::HistogramRegistry::H1 hist_pdgId_Daughter_DarkRho_;
+  emjet::HistogramRegistry::H1 hist_nStableDaughter_DarkRho_;
+  emjet::HistogramRegistry::H1 hist_pt_StableDaughter_DarkRho_;
+  emjet::HistogramRegistry::H1 hist_pdgId_StableDaughter_DarkRho_;
   std::vector<float> genParticlesPt_;
   std::vector<float> genParticlesEta_;
   std::vector<float> genParticlesPhi_;
@@ -173,22 +176,22 @@ GenParticleAnalyzer::GenParticleAnalyzer(const edm::ParameterSet& iConfig)
   tree_->Branch("Lxy"                , &genParticleLxy_                ) ;
   tree_->Branch("decayTime"          , &genParticleDecayTime_          ) ;
   tree_->Branch("pdgId"		     , &genParticlePdgId_	       ) ;
-  hist_nDarkPion_                     = fs->make<TH1F>("nDarkPion_"                     , "nDarkPion_"                     , 25  , 0    , 25 );
-  hist_pt_DarkPion_                   = fs->make<TH1F>("pt_DarkPion_"                   , "pt_DarkPion_"                   , 100 , 0.   , 10. );
-  hist_nDaughter_DarkPion_            = fs->make<TH1F>("nDaughter_DarkPion_"            , "nDaughter_DarkPion_"            , 25  , 0    , 25 );
-  hist_pt_Daughter_DarkPion_          = fs->make<TH1F>("pt_Daughter_DarkPion_"          , "pt_Daughter_DarkPion_"          , 100 , 0.   , 10. );
-  hist_pdgId_Daughter_DarkPion_       = fs->make<TH1F>("pdgId_Daughter_DarkPion_"       , "pdgId_Daughter_DarkPion_"       , 400 , -200 , 200 );
-  hist_nStableDaughter_DarkPion_      = fs->make<TH1F>("nStableDaughter_DarkPion_"      , "nStableDaughter_DarkPion_"      , 25  , 0    , 25 );
-  hist_pt_StableDaughter_DarkPion_    = fs->make<TH1F>("pt_StableDaughter_DarkPion_"    , "pt_StableDaughter_DarkPion_"    , 100 , 0.   , 10. );
-  hist_pdgId_StableDaughter_DarkPion_ = fs->make<TH1F>("pdgId_StableDaughter_DarkPion_" , "pdgId_StableDaughter_DarkPion_" , 400 , -200 , 200 );
-  hist_nDarkRho_                      = fs->make<TH1F>("nDarkRho_"                      , "nDarkRho_"                      , 25  , 0    , 25 );
-  hist_pt_DarkRho_                    = fs->make<TH1F>("pt_DarkRho_"                    , "pt_DarkRho_"                    , 100 , 0.   , 10. );
-  hist_nDaughter_DarkRho_             = fs->make<TH1F>("nDaughter_DarkRho_"             , "nDaughter_DarkRho_"             , 25  , 0    , 25 );
-  hist_pt_Daughter_DarkRho_           = fs->make<TH1F>("pt_Daughter_DarkRho_"           , "pt_Daughter_DarkRho_"           , 100 , 0.   , 100. );
-  hist_pdgId_Daughter_DarkRho_        = fs->make<TH1F>("pdgId_Daughter_DarkRho_"        , "pdgId_Daughter_DarkRho_"        , 400 , -200 , 200 );
-  hist_nStableDaughter_DarkRho_       = fs->make<TH1F>("nStableDaughter_DarkRho_"       , "nStableDaughter_DarkRho_"       , 25  , 0    , 25 );
-  hist_pt_StableDaughter_DarkRho_     = fs->make<TH1F>("pt_StableDaughter_DarkRho_"     , "pt_StableDaughter_DarkRho_"     , 100 , 0.   , 10. );
-  hist_pdgId_StableDaughter_DarkRho_  = fs->make<TH1F>("pdgId_StableDaughter_DarkRho_"  , "pdgId_StableDaughter_DarkRho_"  , 400 , -200 , 200 );
+  hist_nDarkPion_                     = histos_.book1D<TH1F>("nDarkPion_"                     , "nDarkPion_"                     , 25  , 0    , 25 );
+  hist_pt_DarkPion_                   = histos_.book1D<TH1F>("pt_DarkPion_"                   , "pt_DarkPion_"                   , 100 , 0.   , 10. );
+  hist_nDaughter_DarkPion_            = histos_.book1D<TH1F>("nDaughter_DarkPion_"            , "nDaughter_DarkPion_"            , 25  , 0    , 25 );
+  hist_pt_Daughter_DarkPion_          = histos_.book1D<TH1F>("pt_Daughter_DarkPion_"          , "pt_Daughter_DarkPion_"          , 100 , 0.   , 10. );
+  hist_pdgId_Daughter_DarkPion_       = histos_.book1D<TH1F>("pdgId_Daughter_DarkPion_"       , "pdgId_Daughter_DarkPion_"       , 400 , -200 , 200 );
+  hist_nStableDaughter_DarkPion_      = histos_.book1D<TH1F>("nStableDaughter_DarkPion_"      , "nStableDaughter_DarkPion_"      , 25  , 0    , 25 );
+  hist_pt_StableDaughter_DarkPion_    = histos_.book1D<TH1F>("pt_StableDaughter_DarkPion_"    , "pt_StableDaughter_DarkPion_"    , 100 , 0.   , 10. );
+  hist_pdgId_StableDaughter_DarkPion_ = histos_.book1D<TH1F>("pdgId_StableDaughter_DarkPion_" , "pdgId_StableDaughter_DarkPion_" , 400 , -200 , 200 );
+  hist_nDarkRho_                      = histos_.book1D<TH1F>("nDarkRho_"                      , "nDarkRho_"                      , 25  , 0    , 25 );
+  hist_pt_DarkRho_                    = histos_.book1D<TH1F>("pt_DarkRho_"                    , "pt_DarkRho_"                    , 100 , 0.   , 10. );
+  hist_nDaughter_DarkRho_             = histos_.book1D<TH1F>("nDaughter_DarkRho_"             , "nDaughter_DarkRho_"             , 25  , 0    , 25 );
+  hist_pt_Daughter_DarkRho_           = histos_.book1D<TH1F>("pt_Daughter_DarkRho_"           , "pt_Daughter_DarkRho_"           , 100 , 0.   , 100. );
+  hist_pdgId_Daughter_DarkRho_        = histos_.book1D<TH1F>("pdgId_Daughter_DarkRho_"        , "pdgId_Daughter_DarkRho_"        , 400 , -200 , 200 );
+  hist_nStableDaughter_DarkRho_       = histos_.book1D<TH1F>("nStableDaughter_DarkRho_"       , "nStableDaughter_DarkRho_"       , 25  , 0    , 25 );
+  hist_pt_StableDaughter_DarkRho_     = histos_.book1D<TH1F>("pt_StableDaughter_DarkRho_"     , "pt_StableDaughter_DarkRho_"     , 100 , 0.   , 10. );
+  hist_pdgId_StableDaughter_DarkRho_  = histos_.book1D<TH1F>("pdgId_StableDaughter_DarkRho_"  , "pdgId_StableDaughter_DarkRho_"  , 400 , -200 , 200 );
 
   consumes< reco::GenParticleCollection > (edm::InputTag("genParticles"));
 }
@@ -333,25 +336,25 @@ GenParticleAnalyzer::analyze(const edm::Event& iEvent, const edm::EventSetup& iS
         // std::cout << "Dark pion at pointer: " << it << std::endl;
         // std::cout << "Dark pion final descendents: " << countFinalDescendents(&candidate) << std::endl;
         nDarkPion++;
-        hist_pt_DarkPion_->Fill(candidate.pt());
+        histos_.fill(hist_pt_DarkPion_, candidate.pt());
         int nDaughter = 0;
         int nStableDaughter = 0;
         for (unsigned i = 0; i < candidate.numberOfDaughters(); i++) {
           auto dau = candidate.daughter(i);
           nDaughter++;
-          hist_pt_Daughter_DarkPion_->Fill( dau->pt() );
-          hist_pdgId_Daughter_DarkPion_->Fill( dau->pdgId() );
+          histos_.fill(hist_pt_Daughter_DarkPion_, dau->pt());
+          histos_.fill(hist_pdgId_Daughter_DarkPion_, dau->pdgId());
           if ( dau->numberOfDaughters()==0 ) {
             nStableDaughter++;
-            hist_pt_StableDaughter_DarkPion_->Fill( dau->pt() );
-            hist_pdgId_StableDaughter_DarkPion_->Fill( dau->pdgId() );
+            histos_.fill(hist_pt_StableDaughter_DarkPion_, dau->pt());
+            histos_.fill(hist_pdgId_StableDaughter_DarkPion_, dau->pdgId());
           }
         }
-        hist_nDaughter_DarkPion_->Fill(nDaughter);
-        hist_nStableDaughter_DarkPion_->Fill(nStableDaughter);
+        histos_.fill(hist_nDaughter_DarkPion_, nDaughter);
+        histos_.fill(hist_nStableDaughter_DarkPion_, nStableDaughter);
       }
     }
-    hist_nDarkPion_->Fill(nDarkPion);
+    histos_.fill(hist_nDarkPion_, nDarkPion);
 
     int nDarkRho = 0;
     for (auto it = genParticles->begin(); it != genParticles->end(); it++) {
@@ -361,25 +364,25 @@ GenParticleAnalyzer::analyze(const edm::Event& iEvent, const edm::EventSetup& iS
         // std::cout << "Dark rho at pointer: " << it << std::endl;
         // std::cout << "Dark rho final descendents: " << countFinalDescendents(&candidate) << std::endl;
         nDarkRho++;
-        hist_pt_DarkRho_->Fill(candidate.pt());
+        histos_.fill(hist_pt_DarkRho_, candidate.pt());
         int nDaughter = 0;
         int nStableDaughter = 0;
         for (unsigned i = 0; i < candidate.numberOfDaughters(); i++) {
           auto dau = candidate.daughter(i);
           nDaughter++;
-          hist_pt_Daughter_DarkRho_->Fill( dau->pt() );
-          hist_pdgId_Daughter_DarkRho_->Fill( dau->pdgId() );
+          histos_.fill(hist_pt_Daughter_DarkRho_, dau->pt());
+          histos_.fill(hist_pdgId_Daughter_DarkRho_, dau->pdgId());
           if ( dau->numberOfDaughters()==0 ) {
             nStableDaughter++;
-            hist_pt_StableDaughter_DarkRho_->Fill( dau->pt() );
-            hist_pdgId_StableDaughter_DarkRho_->Fill( dau->pdgId() );
+            histos_.fill(hist_pt_StableDaughter_DarkRho_, dau->pt());
+            histos_.fill(hist_pdgId_StableDaughter_DarkRho_, dau->pdgId());
           }
         }
-        hist_nDaughter_DarkRho_->Fill(nDaughter);
-        hist_nStableDaughter_DarkRho_->Fill(nStableDaughter);
+        histos_.fill(hist_nDaughter_DarkRho_, nDaughter);
+        histos_.fill(hist_nStableDaughter_DarkRho_, nStableDaughter);
       }
     }
-    hist_nDarkRho_->Fill(nDarkRho);
+    histos_.fill(hist_nDarkRho_, nDarkRho);
   }
 
 
@@ -405,6 +408,7 @@ GenParticleAnalyzer::beginJob()
 void
 GenParticleAnalyzer::endJob()
 {
+  histos_.merge();
 }
 
 // ------------ method called when starting to processes a run  ------------
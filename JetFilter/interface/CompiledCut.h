@@ -0,0 +1,209 @@
+#ifndef EmergingJetAnalysis_JetFilter_CompiledCut_h
+#define EmergingJetAnalysis_JetFilter_CompiledCut_h
+
+// Drop-in replacement for StringCutObjectSelector for simple cuts
+// Cut strings consisting of a conjunction of simple comparisons, e.g. "abs(eta) < 2.5 && pt > 50.0 && chf > 0.1",
+// are parsed once at construction and folded into one interval per variable, evaluated without the expression tree.
+// Any other cut string is passed to StringCutObjectSelector.
+// Supported terms: [abs(]var[()][)] op number, or number op [abs(]var[()][)], with op one of <, <=, >, >=, ==
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#include "DataFormats/JetReco/interface/PFJet.h"
+#include "CommonTools/Utils/interface/StringCutObjectSelector.h"
+
+namespace emjet
+{
+  inline std::string trimCutString(const std::string& s)
+  {
+    size_t first = s.find_first_not_of(" \t\n");
+    if (first == std::string::npos) return "";
+    size_t last = s.find_last_not_of(" \t\n");
+    return s.substr(first, last-first+1);
+  }
+
+  // Variables available to CompiledCut<T>
+  // index() returns -1 for unknown variables, which makes the cut fall back to StringCutObjectSelector
+  template <class T>
+  struct CutVariables {
+    enum { PT, ETA, PHI, ENERGY, ET, MASS, PX, PY, PZ, P, THETA, RAPIDITY, NVARIABLES };
+    static int index(const std::string& name) {
+      static const char* names[NVARIABLES] = {"pt", "eta", "phi", "energy", "et", "mass", "px", "py", "pz", "p", "theta", "rapidity"};
+      for (int i = 0; i < NVARIABLES; i++) { if (name == names[i]) return i; }
+      return -1;
+    }
+    static double value(const T& obj, int index) {
+      switch (index) {
+        case PT       : return obj.pt();
+        case ETA      : return obj.eta();
+        case PHI      : return obj.phi();
+        case ENERGY   : return obj.energy();
+        case ET       : return obj.et();
+        case MASS     : return obj.mass();
+        case PX       : return obj.px();
+        case PY       : return obj.py();
+        case PZ       : return obj.pz();
+        case P        : return obj.p();
+        case THETA    : return obj.theta();
+        case RAPIDITY : return obj.rapidity();
+      }
+      return 0;
+    }
+  };
+
+  // PF jets additionally provide energy fractions, both as method names and the short names used in the ntuples
+  template <>
+  struct CutVariables<reco::PFJet> {
+    typedef CutVariables<reco::Candidate> Kinematic;
+    enum { CEF = Kinematic::NVARIABLES, NEF, CHF, NHF, PEF, MEF, CHM, NCONSTITUENTS, NVARIABLES };
+    static int index(const std::string& name) {
+      int kinematic = Kinematic::index(name);
+      if (kinematic != -1) return kinematic;
+      static const std::pair<const char*, int> names[] = {
+        {"cef", CEF}, {"chargedEmEnergyFraction"     , CEF},
+        {"nef", NEF}, {"neutralEmEnergyFraction"     , NEF},
+        {"chf", CHF}, {"chargedHadronEnergyFraction" , CHF},
+        {"nhf", NHF}, {"neutralHadronEnergyFraction" , NHF},
+        {"pef", PEF}, {"photonEnergyFraction"        , PEF},
+        {"mef", MEF}, {"muonEnergyFraction"          , MEF},
+        {"chargedMultiplicity", CHM},
+        {"numberOfDaughters", NCONSTITUENTS}, {"nConstituents", NCONSTITUENTS},
+      };
+      for (auto entry : names) { if (name == entry.first) return entry.second; }
+      return -1;
+    }
+    static double value(const reco::PFJet& obj, int index) {
+      switch (index) {
+        case CEF           : return obj.chargedEmEnergyFraction();
+        case NEF           : return obj.neutralEmEnergyFraction();
+        case CHF           : return obj.chargedHadronEnergyFraction();
+        case NHF           : return obj.neutralHadronEnergyFraction();
+        case PEF           : return obj.photonEnergyFraction();
+        case MEF           : return obj.muonEnergyFraction();
+        case CHM           : return obj.chargedMultiplicity();
+        case NCONSTITUENTS : return obj.numberOfDaughters();
+      }
+      return Kinematic::value(obj, index);
+    }
+  };
+
+  template <class T>
+  class CompiledCut {
+  public:
+    // If useCompiled is false, always use StringCutObjectSelector (for validation and benchmarking)
+    explicit CompiledCut(const std::string& cut, bool useCompiled=true);
+
+    bool operator()(const T& obj) const {
+      if (fallback_) return (*fallback_)(obj);
+      for (const auto& interval : intervals_) {
+        double x = CutVariables<T>::value(obj, interval.variable);
+        if (interval.useAbs) x = std::fabs(x);
+        if ( interval.minStrict ? !(x >  interval.min) : !(x >= interval.min) ) return false;
+        if ( interval.maxStrict ? !(x <  interval.max) : !(x <= interval.max) ) return false;
+      }
+      return true;
+    }
+
+    // True if cut is evaluated without StringCutObjectSelector
+    bool isCompiled() const { return !fallback_; }
+
+  private:
+    struct Interval {
+      int variable;
+      bool useAbs;
+      double min, max;
+      bool minStrict, maxStrict;
+    };
+    bool compile(const std::string& cut);
+    bool addTerm(std::string term);
+
+    std::vector<Interval> intervals_;
+    std::shared_ptr< StringCutObjectSelector<T> > fallback_; // Shared so that cuts remain copyable
+  };
+}
+
+template <class T>
+emjet::CompiledCut<T>::CompiledCut(const std::string& cut, bool useCompiled)
+{
+  if ( !useCompiled || !compile(cut) ) {
+    intervals_.clear();
+    fallback_.reset( new StringCutObjectSelector<T>(cut) );
+  }
+}
+
+template <class T>
+bool
+emjet::CompiledCut<T>::compile(const std::string& cut)
+{
+  // Only plain conjunctions are compiled
+  if ( cut.find_first_of("|!?:[") != std::string::npos ) return false;
+  std::string remaining = trimCutString(cut);
+  if (remaining.empty()) return true; // Empty cut selects everything
+  while (true) {
+    size_t pos = remaining.find("&&");
+    if ( !addTerm(remaining.substr(0, pos)) ) return false;
+    if (pos == std::string::npos) break;
+    remaining = remaining.substr(pos+2);
+  }
+  return true;
+}
+
+template <class T>
+bool
+emjet::CompiledCut<T>::addTerm(std::string term)
+{
+  term = trimCutString(term);
+  // Split into lhs op rhs
+  size_t pos = term.find_first_of("<>=");
+  if (pos == std::string::npos) return false;
+  size_t opLength = (pos+1 < term.size() && term[pos+1] == '=') ? 2 : 1;
+  std::string op = term.substr(pos, opLength);
+  if (op == "=" || op == "=<" || op == "=>") return false;
+  std::string lhs = trimCutString(term.substr(0, pos));
+  std::string rhs = trimCutString(term.substr(pos+opLength));
+  if ( rhs.find_first_of("<>=") != std::string::npos ) return false;
+  // Normalize to "variable op number"
+  char* end = nullptr;
+  double value = std::strtod(rhs.c_str(), &end);
+  if ( rhs.empty() || *end != '\0' ) {
+    value = std::strtod(lhs.c_str(), &end);
+    if ( lhs.empty() || *end != '\0' ) return false;
+    std::swap(lhs, rhs);
+    if      (op[0] == '<') op[0] = '>';
+    else if (op[0] == '>') op[0] = '<';
+  }
+  // Parse variable
+  bool useAbs = false;
+  if ( lhs.compare(0, 4, "abs(") == 0 && lhs[lhs.size()-1] == ')' ) {
+    useAbs = true;
+    lhs = trimCutString(lhs.substr(4, lhs.size()-5));
+  }
+  if ( lhs.size() > 2 && lhs.compare(lhs.size()-2, 2, "()") == 0 ) lhs = lhs.substr(0, lhs.size()-2);
+  int variable = CutVariables<T>::index(lhs);
+  if (variable == -1) return false;
+  // Fold into existing interval for the same variable
+  Interval* interval = nullptr;
+  for (auto& existing : intervals_) {
+    if (existing.variable == variable && existing.useAbs == useAbs) interval = &existing;
+  }
+  if (!interval) {
+    const double inf = std::numeric_limits<double>::infinity();
+    intervals_.push_back( Interval{variable, useAbs, -inf, inf, false, false} );
+    interval = &intervals_.back();
+  }
+  bool strict = (opLength == 1);
+  if (op[0] == '>' || op == "==") {
+    if ( value > interval->min || (value == interval->min && strict) ) { interval->min = value; interval->minStrict = strict; }
+  }
+  if (op[0] == '<' || op == "==") {
+    if ( value < interval->max || (value == interval->max && strict) ) { interval->max = value; interval->maxStrict = strict; }
+  }
+  return true;
+}
+
+#endif
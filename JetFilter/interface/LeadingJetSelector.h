@@ -0,0 +1,111 @@
+#ifndef EmergingJetAnalysis_JetFilter_LeadingJetSelector_h
+#define EmergingJetAnalysis_JetFilter_LeadingJetSelector_h
+
+// Signal region jet selection shared by JetFilter and MultiSkimFilter
+// The i-th jet passing (minPt, maxEta, stringCut) of the i-th entry of jetCuts is selected, in collection order.
+// If all jetCuts are satisfied, all remaining jets passing additionalCut are selected as well.
+
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "DataFormats/JetReco/interface/PFJetCollection.h"
+#include "EmergingJetAnalysis/JetFilter/interface/CompiledCut.h"
+
+namespace emjet
+{
+  class LeadingJetSelector {
+  public:
+    // Reads doFilter, additionalCut, jetCuts and untracked useCompiledCuts from pset
+    explicit LeadingJetSelector(const edm::ParameterSet& pset);
+
+    // Fill selectedIndex with indices of selected jets in output order, return true if event passed
+    // If doFilter is false, pass all events and select all jets passing additionalCut
+    bool select(const reco::PFJetCollection& jets, std::vector<unsigned>& selectedIndex) const;
+
+  private:
+    bool doFilter_;
+    bool useCompiledCuts_; // If false, evaluate all cuts with StringCutObjectSelector
+    std::vector<double> minPts_;  // minPts_[i] corresponds to the i-th minimum pt-cut
+    std::vector<double> maxEtas_; // maxEtas_[i] corresponds to the i-th max eta-cut
+    std::vector<emjet::CompiledCut<reco::PFJet> > stringCutSelectors_; // String cuts for the i-th jet
+    int nCuts_;
+    // Generic cuts for the jets that don't pass the previous criteria
+    emjet::CompiledCut<reco::PFJet> additionalCutSelector_;
+  };
+}
+
+inline
+emjet::LeadingJetSelector::LeadingJetSelector(const edm::ParameterSet& pset) :
+  doFilter_(pset.getParameter<bool>("doFilter")),
+  useCompiledCuts_(pset.getUntrackedParameter<bool>("useCompiledCuts", true)),
+  additionalCutSelector_( pset.getParameter<std::string>("additionalCut"), useCompiledCuts_ )
+{
+  std::vector<edm::ParameterSet> jetCuts(pset.getParameter<std::vector<edm::ParameterSet> >("jetCuts"));
+  for (auto jetCut = jetCuts.begin(); jetCut != jetCuts.end(); jetCut++) {
+    double minPt  = jetCut->getParameter<double>("minPt");
+    double maxEta = jetCut->getParameter<double>("maxEta");
+    std::string stringCut = jetCut->getParameter<std::string>("stringCut");
+    emjet::CompiledCut<reco::PFJet> stringCutSelector(stringCut, useCompiledCuts_);
+    LogDebug("JetFilter") << "Printing pt-cut for jets" << "minPt: " << minPt;
+    LogDebug("JetFilter") << "stringCut \"" << stringCut << "\" compiled: " << stringCutSelector.isCompiled();
+
+    minPts_.push_back(minPt);
+    maxEtas_.push_back(maxEta);
+    stringCutSelectors_.push_back(stringCutSelector);
+  }
+  nCuts_ = jetCuts.size();
+  LogDebug("JetFilter") << "additionalCut compiled: " << additionalCutSelector_.isCompiled();
+}
+
+inline bool
+emjet::LeadingJetSelector::select(const reco::PFJetCollection& jets, std::vector<unsigned>& selectedIndex) const
+{
+  bool eventPassed = false;
+  selectedIndex.clear();
+  selectedIndex.reserve(jets.size());
+  std::vector<bool> jetSelected(jets.size(), false);
+
+  int nJetsPassing = 0;
+  unsigned jetIndex = 0;
+  if (doFilter_) {
+    for (auto it = jets.begin(); it != jets.end(); it++) {
+      const auto& jet = *it;
+      if (nJetsPassing < nCuts_) {
+        if (std::fabs(jet.eta()) < maxEtas_[nJetsPassing] && jet.pt() > minPts_[nJetsPassing]) {
+          bool passStringCut = stringCutSelectors_[nJetsPassing](jet);
+          if (passStringCut) {
+            selectedIndex.push_back(jetIndex);
+            jetSelected[jetIndex] = true;
+            nJetsPassing++;
+          }
+        }
+      } else if (nJetsPassing > 3) {
+        eventPassed = true;
+        break;
+      }
+      jetIndex++;
+    }
+  }
+  else eventPassed = true;
+  if (eventPassed) {
+    unsigned jetIndex = 0;
+    for (auto it = jets.begin(); it != jets.end(); it++) {
+      const auto& jet = *it;
+      // If jet has NOT been selected already
+      if (!jetSelected[jetIndex]) {
+        bool jetPassed = additionalCutSelector_(jet);
+        if (jetPassed) {
+          selectedIndex.push_back(jetIndex);
+          nJetsPassing++;
+        }
+      }
+      jetIndex++;
+    }
+  }
+  return eventPassed;
+}
+
+#endif
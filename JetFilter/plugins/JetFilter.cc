@@ -21,13 +21,12 @@ Implementation:
 #include <memory>
 #include <vector>
 #include <string>
-#include <unordered_map>
 #include <iostream>
 #include <algorithm>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
-#include "FWCore/Framework/interface/EDFilter.h"
+#include "FWCore/Framework/interface/global/EDFilter.h"
 
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
@@ -46,6 +45,8 @@ Implementation:
 
 // Utils
 #include "CommonTools/Utils/interface/StringCutObjectSelector.h"
+#include "EmergingJetAnalysis/JetFilter/interface/LeadingJetSelector.h"
+#include "EmergingJetAnalysis/Utils/interface/HistogramRegistry.h"
 
 // Namespace shorthands
 using std::string;
@@ -55,7 +56,7 @@ using std::vector;
 // class declaration
 //
 
-class JetFilter : public edm::EDFilter {
+class JetFilter : public edm::global::EDFilter<> {
   public:
     explicit JetFilter(const edm::ParameterSet&);
     ~JetFilter();
@@ -64,7 +65,7 @@ class JetFilter : public edm::EDFilter {
 
   private:
     virtual void beginJob() override;
-    virtual bool filter(edm::Event&, const edm::EventSetup&) override;
+    virtual bool filter(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
     virtual void endJob() override;
 
     //virtual void beginRun(edm::Run const&, edm::EventSetup const&) override;
@@ -77,23 +78,17 @@ class JetFilter : public edm::EDFilter {
     // inputs
     ////////////////////////////////////////
     edm::EDGetTokenT< reco::PFJetCollection > jetCollectionToken_;
-    bool doFilter_; // If false, pass all events, and select all jets passing additionalCut
-    std::vector<double> minPts_;  // minPts_[i] corresponds to the i-th minimum pt-cut
-    std::vector<double> maxEtas_; // maxEtas_[i] corresponds to the i-th max eta-cut
-    std::vector<StringCutObjectSelector<reco::PFJet> > stringCutSelectors_; // String cuts for the i-th jet
-    int nCuts_;
-
-    // Generic cuts for the jets that don't pass the previous criteria
-    StringCutObjectSelector<reco::PFJet> additionalCutSelector_;
+    bool outputRefs_; // If true, output PFJetRefVector pointing to input jets instead of PFJetCollection copies
+    // Selection from doFilter, jetCuts and additionalCut
+    // If doFilter is false, pass all events, and select all jets passing additionalCut
+    emjet::LeadingJetSelector jetSelector_;
 
     ////////////////////////////////////////
     // outputs
     ////////////////////////////////////////
-    std::auto_ptr< reco::PFJetCollection > selectedJets_;
-    std::vector<int> selectedJetsIndex_;
-
-    std::unordered_map<string, TH1*> histoMap1D_;
-    std::unordered_map<string, TH2*> histoMap2D_;
+    mutable emjet::HistogramRegistry histos_;
+    emjet::HistogramRegistry::H2 hist_jetPt_jetIndex_;
+    emjet::HistogramRegistry::H2 hist_jetEta_jetIndex_;
 };
 
 //
@@ -108,36 +103,22 @@ class JetFilter : public edm::EDFilter {
 // constructors and destructor
 //
 JetFilter::JetFilter(const edm::ParameterSet& iConfig):
-  doFilter_(iConfig.getParameter<bool>("doFilter")),
-  additionalCutSelector_( StringCutObjectSelector<reco::PFJet>(iConfig.getParameter<std::string>("additionalCut")) )
+  outputRefs_(iConfig.getUntrackedParameter<bool>("outputRefs", false)),
+  jetSelector_(iConfig)
 {
   LogDebug("JetFilter") << "Construcing JetFilter";
   //now do what ever initialization is needed
   jetCollectionToken_ = consumes< reco::PFJetCollection > (iConfig.getParameter<edm::InputTag>("srcJets"));
-  vector<edm::ParameterSet> jetCuts(iConfig.getParameter<std::vector<edm::ParameterSet> >("jetCuts"));
-  for (auto jetCut = jetCuts.begin(); jetCut != jetCuts.end(); jetCut++) {
-    double minPt  = jetCut->getParameter<double>("minPt");
-    double maxEta = jetCut->getParameter<double>("maxEta");
-    string stringCut = jetCut->getParameter<std::string>("stringCut");
-    StringCutObjectSelector<reco::PFJet> stringCutSelector(stringCut);
-    LogDebug("JetFilter") << "Printing pt-cut for jets" << "minPt: " << minPt;
-
-    minPts_.push_back(minPt);
-    maxEtas_.push_back(maxEta);
-    stringCutSelectors_.push_back(stringCutSelector);
-  }
-  nCuts_ = jetCuts.size();
 
   // additionalCutString = iConfig.getParameter<std::string>("additionalCut");
   // additionalCutSelector_ = StringCutObjectSelector<reco::PFJet>(additionalCutString);
 
-  edm::Service<TFileService> fs;
-  string name;
-  name="jetPt_jetIndex"  ; histoMap2D_.emplace( name , fs->make<TH2D>(name.c_str() , name.c_str() , 100 , 0.  , 500. , 10 , 0. , 10. )) ;
-  name="jetEta_jetIndex" ; histoMap2D_.emplace( name , fs->make<TH2D>(name.c_str() , name.c_str() , 100 , -5. , 5.   , 10 , 0. , 10. ))  ;
+  hist_jetPt_jetIndex_  = histos_.book2D( "jetPt_jetIndex"  , "jetPt_jetIndex"  , 100 , 0.  , 500. , 10 , 0. , 10. );
+  hist_jetEta_jetIndex_ = histos_.book2D( "jetEta_jetIndex" , "jetEta_jetIndex" , 100 , -5. , 5.   , 10 , 0. , 10. );
 
 
-  produces< reco::PFJetCollection > ("selectedJets"). setBranchAlias( "selectedJets" );
+  if (outputRefs_) produces< reco::PFJetRefVector > ("selectedJets"). setBranchAlias( "selectedJets" );
+  else             produces< reco::PFJetCollection > ("selectedJets"). setBranchAlias( "selectedJets" );
 }
 
 
@@ -156,7 +137,7 @@ JetFilter::~JetFilter()
 
 // ------------ method called on each new Event  ------------
   bool
-JetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
+JetFilter::filter(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
 {
   using namespace edm;
   bool eventPassed = false;
@@ -164,51 +145,23 @@ JetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
   edm::Handle< reco::PFJetCollection > jetCollection;
   iEvent.getByToken(jetCollectionToken_, jetCollection);
 
-  std::auto_ptr< reco::PFJetCollection > selectedJets_( new reco::PFJetCollection() );
-  selectedJets_->reserve(jetCollection->size());
-
+  // Indices of selected jets in output order
+  std::vector<unsigned> selectedJetsIndex;
   LogDebug("JetFilter") << "Iterating over jets";
-  int nJetsPassing = 0;
-  int jetIndex = 0;
-  if (doFilter_) {
-    for (auto it = jetCollection->begin(); it != jetCollection->end(); it++) {
-      auto jet = *it;
-      if (nJetsPassing < nCuts_) {
-        if (fabs(jet.eta()) < maxEtas_[nJetsPassing] && jet.pt() > minPts_[nJetsPassing]) {
-          bool passStringCut = stringCutSelectors_[nJetsPassing](jet);
-          if (passStringCut) {
-            selectedJets_->push_back(jet);
-            selectedJetsIndex_.push_back(jetIndex);
-            nJetsPassing++;
-          }
-        }
-      } else if (nJetsPassing > 3) {
-        eventPassed = true;
-        break;
-      }
-      jetIndex++;
-    }
+  eventPassed = jetSelector_.select(*jetCollection, selectedJetsIndex);
+
+  if (outputRefs_) {
+    std::auto_ptr< reco::PFJetRefVector > selectedJets( new reco::PFJetRefVector() );
+    for (unsigned index : selectedJetsIndex) selectedJets->push_back( reco::PFJetRef(jetCollection, index) );
+    iEvent.put(selectedJets, "selectedJets");
   }
-  else eventPassed = true;
-  if (eventPassed) {
-    int jetIndex = 0;
-    for (auto it = jetCollection->begin(); it != jetCollection->end(); it++) {
-      auto jet = *it;
-      auto find = std::find(selectedJetsIndex_.begin(), selectedJetsIndex_.end(), jetIndex);
-      // If jet has NOT been selected already
-      if (find == selectedJetsIndex_.end()) {
-        bool jetPassed = additionalCutSelector_(jet);
-        if (jetPassed) {
-          selectedJets_->push_back(jet);
-          nJetsPassing++;
-        }
-      }
-      jetIndex++;
-    }
+  else {
+    std::auto_ptr< reco::PFJetCollection > selectedJets( new reco::PFJetCollection() );
+    selectedJets->reserve(selectedJetsIndex.size());
+    for (unsigned index : selectedJetsIndex) selectedJets->push_back( (*jetCollection)[index] );
+    iEvent.put(selectedJets, "selectedJets");
   }
 
-  iEvent.put(selectedJets_, "selectedJets");
-
   // std::auto_ptr< double > _dummy( new double (0.0) );
   // iEvent.put(_dummy, "dummy");
 
@@ -233,6 +186,7 @@ JetFilter::beginJob()
 // ------------ method called once each job just after ending the event loop  ------------
 void 
 JetFilter::endJob() {
+  histos_.merge();
 }
 
 // ------------ method called when starting to processes a run  ------------
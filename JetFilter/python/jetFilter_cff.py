@@ -2,6 +2,7 @@ import FWCore.ParameterSet.Config as cms
 
 jetFilter = cms.EDFilter("JetFilter",
     srcJets = cms.InputTag("ak4PFJetsCHS"),
+    # outputRefs = cms.untracked.bool(True), # Output PFJetRefVector instead of copying selected jets
     # srcJets = cms.InputTag("patJets"),
     # additionalCut = cms.string(""),
     additionalCut = cms.string("abs(eta) < 2.5 && pt > 50.0"),
@@ -0,0 +1,54 @@
+############################################################
+# Benchmark compiled cuts against StringCutObjectSelector
+# Runs identical JetFilter instances with useCompiledCuts True/False on the same input.
+# Compare per-module times in the TimeReport summary, and pass counts in the TrigReport (must be identical).
+# Usage: cmsRun cutBenchmark_cfg.py inputFiles=<large skim> maxEvents=-1
+############################################################
+
+import FWCore.ParameterSet.Config as cms
+# Command line argument parsing
+import FWCore.ParameterSet.VarParsing as VarParsing
+
+process = cms.Process('CUTBENCHMARK')
+
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.MessageLogger.cerr.FwkReport.reportEvery = 10000
+
+process.options = cms.untracked.PSet( wantSummary = cms.untracked.bool(True) )
+# Per-module timing summary
+process.Timing = cms.Service("Timing",
+    summaryOnly = cms.untracked.bool(True),
+    useJobReport = cms.untracked.bool(True),
+)
+
+# setup 'analysis'  options
+options = VarParsing.VarParsing ('analysis')
+options.maxEvents = -1 # -1 means all events
+options.inputFiles= '/store/group/phys_exotica/EmergingJets/EmergingJets_ModelA_TuneCUETP8M1_13TeV_pythia8Mod/RECO/150715_195547/0000/aodsim_10.root'
+options.parseArguments()
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles),
+)
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.TFileService = cms.Service("TFileService",
+    fileName = cms.string("cutBenchmark.root")
+)
+
+# Skim cuts, plus jet ID style energy fraction cuts to exercise more terms per jet
+from EmergingJetAnalysis.JetFilter.jetFilter_cff import jetFilter
+jetId = "neutralHadronEnergyFraction < 0.99 && neutralEmEnergyFraction < 0.99 && chargedHadronEnergyFraction > 0.0 && chargedEmEnergyFraction < 0.99"
+jetFilter.doFilter = cms.bool(True)
+jetFilter.additionalCut = cms.string("abs(eta) < 2.5 && pt > 50.0 && " + jetId)
+for jetCut in jetFilter.jetCuts:
+    jetCut.stringCut = cms.string(jetId)
+
+process.jetFilterCompiled = jetFilter.clone( useCompiledCuts = cms.untracked.bool(True) )
+process.jetFilterString   = jetFilter.clone( useCompiledCuts = cms.untracked.bool(False) )
+
+# Separate paths so both filters see every event
+process.pCompiled = cms.Path( process.jetFilterCompiled )
+process.pString   = cms.Path( process.jetFilterString )
@@ -0,0 +1,94 @@
+#ifndef EmergingJetAnalysis_LeptonPreselector_PreselectedLeptons_h
+#define EmergingJetAnalysis_LeptonPreselector_PreselectedLeptons_h
+
+// Read access to the products of LeptonPreselector for one lepton flavour ("electron" or "muon")
+// For the i-th preselected lepton:
+//   index(i)        : index into the original pat::Electron/pat::Muon collection
+//   passID(i, bit)  : true if the lepton passed the bit-th entry of electronIDs/muonIDs
+//   relIso(i)       : (trackIso + caloIso) / pt
+//   p4(i)           : four-momentum
+// Leptons are stored in the order of the original collection (i.e. sorted by pt).
+//
+// Usage:
+//   ctor:   PreselectedLeptonTokens electronTokens_(src, "electron", consumesCollector());
+//           checkPreselectionThreshold(src, "electron", minPtElectron_, "WJetFilter");
+//   filter: PreselectedLeptons electrons = electronTokens_.get(iEvent);
+
+#include <string>
+#include <vector>
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/ConsumesCollector.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/Registry.h"
+#include "DataFormats/Math/interface/LorentzVector.h"
+
+namespace emjet
+{
+  // Products of one event
+  class PreselectedLeptons {
+  public:
+    typedef math::PtEtaPhiMLorentzVector PolarLorentzVector;
+
+    unsigned size() const { return index_->size(); }
+    unsigned index(unsigned i) const { return (*index_)[i]; }
+    bool passID(unsigned i, unsigned bit) const { return ((*idBits_)[i] >> bit) & 1; }
+    float relIso(unsigned i) const { return (*relIso_)[i]; }
+    const PolarLorentzVector& p4(unsigned i) const { return (*p4_)[i]; }
+
+  private:
+    friend class PreselectedLeptonTokens;
+    edm::Handle< std::vector<unsigned>           > index_;
+    edm::Handle< std::vector<unsigned>           > idBits_;
+    edm::Handle< std::vector<float>              > relIso_;
+    edm::Handle< std::vector<PolarLorentzVector> > p4_;
+  };
+
+  // Tokens, held by the consuming module
+  class PreselectedLeptonTokens {
+  public:
+    typedef PreselectedLeptons::PolarLorentzVector PolarLorentzVector;
+
+    PreselectedLeptonTokens(const edm::InputTag& src, const std::string& flavour, edm::ConsumesCollector&& iC) :
+      indexToken_  ( iC.consumes< std::vector<unsigned>           >(edm::InputTag(src.label(), flavour+"Index" , src.process())) ),
+      idBitsToken_ ( iC.consumes< std::vector<unsigned>           >(edm::InputTag(src.label(), flavour+"IDBits", src.process())) ),
+      relIsoToken_ ( iC.consumes< std::vector<float>              >(edm::InputTag(src.label(), flavour+"RelIso", src.process())) ),
+      p4Token_     ( iC.consumes< std::vector<PolarLorentzVector> >(edm::InputTag(src.label(), flavour+"P4"    , src.process())) )
+    {}
+
+    PreselectedLeptons get(const edm::Event& iEvent) const {
+      PreselectedLeptons leptons;
+      iEvent.getByToken(indexToken_  , leptons.index_  );
+      iEvent.getByToken(idBitsToken_ , leptons.idBits_ );
+      iEvent.getByToken(relIsoToken_ , leptons.relIso_ );
+      iEvent.getByToken(p4Token_     , leptons.p4_     );
+      return leptons;
+    }
+
+  private:
+    edm::EDGetTokenT< std::vector<unsigned>           > indexToken_;
+    edm::EDGetTokenT< std::vector<unsigned>           > idBitsToken_;
+    edm::EDGetTokenT< std::vector<float>              > relIsoToken_;
+    edm::EDGetTokenT< std::vector<PolarLorentzVector> > p4Token_;
+  };
+
+  // Throw if the LeptonPreselector module src of the current process preselects flavour leptons with a pt threshold
+  // above minPt, since it would then drop leptons that the consuming module accepts
+  inline void checkPreselectionThreshold(const edm::InputTag& src, const std::string& flavour, double minPt, const std::string& consumer)
+  {
+    const edm::ParameterSet& process = edm::getProcessParameterSet();
+    if ( !process.existsAs<edm::ParameterSet>(src.label()) ) return; // Products read from file
+    const edm::ParameterSet& preselector = process.getParameterSet(src.label());
+    std::string name = flavour == "electron" ? "minPtElectron" : "minPtMuon";
+    if ( !preselector.existsAs<double>(name) ) return;
+    double preselectionMinPt = preselector.getParameter<double>(name);
+    if ( preselectionMinPt > minPt ) {
+      throw cms::Exception("Configuration") << consumer << ": " << src.label() << "." << name << " = " << preselectionMinPt
+                                            << " is above the " << flavour << " pt threshold " << minPt << " of this module";
+    }
+  }
+}
+
+#endif
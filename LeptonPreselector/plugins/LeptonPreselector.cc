@@ -0,0 +1,212 @@
+// -*- C++ -*-
+//
+// Package:    EmergingAnalysis/LeptonPreselector
+// Class:      LeptonPreselector
+//
+/**\class LeptonPreselector LeptonPreselector.cc EmergingAnalysis/LeptonPreselector/plugins/LeptonPreselector.cc
+
+ Description: Loose lepton preselection shared by WJetFilter and ZJetFilter
+
+ Implementation:
+     Electrons and muons passing (minPt, maxEta) and at least one of electronIDs/muonIDs are stored as
+     parallel vectors, one set per flavour (<flavour> is "electron" or "muon"):
+       <flavour>Index  : vector<unsigned>, index into the input collection
+       <flavour>IDBits : vector<unsigned>, bit i set if lepton passed the i-th ID
+       <flavour>RelIso : vector<float>, (trackIso + caloIso) / pt
+       <flavour>P4     : vector<PtEtaPhiMLorentzVector>
+     Use EmergingJetAnalysis/LeptonPreselector/interface/PreselectedLeptons.h to read them.
+     Downstream filters apply their own (tighter) pt, ID and isolation cuts.
+*/
+//
+
+
+// system include files
+#include <memory>
+#include <vector>
+#include <string>
+#include <cmath>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+// Data formats
+#include "DataFormats/PatCandidates/interface/Muon.h"
+#include "DataFormats/PatCandidates/interface/Electron.h"
+#include "DataFormats/Math/interface/LorentzVector.h"
+
+// Namespace shorthands
+using std::string;
+using std::vector;
+
+//
+// class declaration
+//
+
+class LeptonPreselector : public edm::global::EDProducer<> {
+  public:
+    explicit LeptonPreselector(const edm::ParameterSet&);
+    ~LeptonPreselector();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  private:
+    virtual void produce(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
+
+    typedef math::PtEtaPhiMLorentzVector PolarLorentzVector;
+    // Output vectors for one lepton flavour
+    struct Output {
+      std::unique_ptr< vector<unsigned> > index;
+      std::unique_ptr< vector<unsigned> > idBits;
+      std::unique_ptr< vector<float> > relIso;
+      std::unique_ptr< vector<PolarLorentzVector> > p4;
+      Output() : index(new vector<unsigned>), idBits(new vector<unsigned>), relIso(new vector<float>), p4(new vector<PolarLorentzVector>) {}
+      void put(edm::Event& iEvent, const string& flavour);
+    };
+    void registerProducts(const string& flavour);
+    unsigned electronIDBits(const pat::Electron& electron) const;
+    unsigned muonIDBits(const pat::Muon& muon) const;
+    template <class T, class IDFunction>
+    void preselect(const vector<T>& leptons, double minPt, IDFunction idBits, Output& output) const;
+
+    // ----------member data ---------------------------
+    edm::EDGetTokenT< pat::MuonCollection > muonCollectionToken_;
+    edm::EDGetTokenT< pat::ElectronCollection > electronCollectionToken_;
+    double minPtMuon_;
+    double minPtElectron_;
+    double maxEta_;
+    vector<string> electronIDs_;
+    vector<string> muonIDs_;
+};
+
+//
+// constructors and destructor
+//
+LeptonPreselector::LeptonPreselector(const edm::ParameterSet& iConfig) :
+    minPtMuon_     ( iConfig.getParameter<double> ( "minPtMuon"     )  ) ,
+    minPtElectron_ ( iConfig.getParameter<double> ( "minPtElectron" )  ) ,
+    maxEta_        ( iConfig.getParameter<double> ( "maxEta"        )  ) ,
+    electronIDs_   ( iConfig.getParameter< vector<string> > ( "electronIDs" )  ) ,
+    muonIDs_       ( iConfig.getParameter< vector<string> > ( "muonIDs"     )  )
+{
+  if ( electronIDs_.size() > 32 || muonIDs_.size() > 32 ) {
+    throw cms::Exception("Configuration") << "LeptonPreselector: at most 32 electronIDs and muonIDs are supported";
+  }
+  muonCollectionToken_ = consumes< pat::MuonCollection > (iConfig.getParameter<edm::InputTag>("srcMuons"));
+  electronCollectionToken_ = consumes< pat::ElectronCollection > (iConfig.getParameter<edm::InputTag>("srcElectrons"));
+
+  registerProducts("electron");
+  registerProducts("muon");
+}
+
+
+LeptonPreselector::~LeptonPreselector()
+{
+}
+
+
+//
+// member functions
+//
+
+void
+LeptonPreselector::registerProducts(const string& flavour)
+{
+  produces< vector<unsigned> >           (flavour+"Index" );
+  produces< vector<unsigned> >           (flavour+"IDBits");
+  produces< vector<float> >              (flavour+"RelIso");
+  produces< vector<PolarLorentzVector> > (flavour+"P4"    );
+}
+
+void
+LeptonPreselector::Output::put(edm::Event& iEvent, const string& flavour)
+{
+  iEvent.put(std::move(index ), flavour+"Index" );
+  iEvent.put(std::move(idBits), flavour+"IDBits");
+  iEvent.put(std::move(relIso), flavour+"RelIso");
+  iEvent.put(std::move(p4    ), flavour+"P4"    );
+}
+
+unsigned
+LeptonPreselector::electronIDBits(const pat::Electron& electron) const
+{
+  unsigned bits = 0;
+  for (unsigned i = 0; i < electronIDs_.size(); i++) {
+    if ( electron.electronID(electronIDs_[i]) >= 1 ) bits |= (1u << i);
+  }
+  return bits;
+}
+
+unsigned
+LeptonPreselector::muonIDBits(const pat::Muon& muon) const
+{
+  unsigned bits = 0;
+  for (unsigned i = 0; i < muonIDs_.size(); i++) {
+    if ( muon.muonID(muonIDs_[i]) ) bits |= (1u << i);
+  }
+  return bits;
+}
+
+template <class T, class IDFunction>
+void
+LeptonPreselector::preselect(const vector<T>& leptons, double minPt, IDFunction idBits, Output& output) const
+{
+  for (unsigned i = 0; i < leptons.size(); i++) {
+    const T& lepton = leptons[i];
+    if ( lepton.pt() < minPt ) continue;
+    if ( std::fabs(lepton.eta()) > maxEta_ ) continue;
+    // ID lookups are by name, evaluate each once here so that downstream modules only test bits
+    unsigned bits = idBits(lepton);
+    if ( bits == 0 ) continue;
+    output.index->push_back(i);
+    output.idBits->push_back(bits);
+    output.relIso->push_back( (lepton.trackIso() + lepton.caloIso()) / lepton.pt() );
+    output.p4->push_back( PolarLorentzVector(lepton.p4()) );
+  }
+}
+
+// ------------ method called to produce the data  ------------
+void
+LeptonPreselector::produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
+{
+  edm::Handle< pat::ElectronCollection > electronCollection;
+  iEvent.getByToken(electronCollectionToken_, electronCollection);
+  edm::Handle< pat::MuonCollection > muonCollection;
+  iEvent.getByToken(muonCollectionToken_, muonCollection);
+
+  Output electrons;
+  preselect(*electronCollection, minPtElectron_, [this](const pat::Electron& e){ return electronIDBits(e); }, electrons);
+  Output muons;
+  preselect(*muonCollection, minPtMuon_, [this](const pat::Muon& m){ return muonIDBits(m); }, muons);
+  LogTrace("LeptonPreselector") << "nElectron: " << electrons.index->size() << " nMuon: " << muons.index->size();
+
+  electrons.put(iEvent, "electron");
+  muons.put(iEvent, "muon");
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+LeptonPreselector::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  // Defaults as in leptonPreselector_cff.py
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("srcMuons", edm::InputTag("slimmedMuons"));
+  desc.add<edm::InputTag>("srcElectrons", edm::InputTag("slimmedElectrons"));
+  desc.add<double>("minPtMuon", 20.0);
+  desc.add<double>("minPtElectron", 20.0);
+  desc.add<double>("maxEta", 2.5);
+  desc.add< vector<string> >("electronIDs", vector<string>(1, "cutBasedElectronID-Spring15-25ns-V1-standalone-medium"));
+  desc.add< vector<string> >("muonIDs", vector<string>(1, "AllGlobalMuons"));
+  descriptions.add("leptonPreselector", desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(LeptonPreselector);
@@ -0,0 +1,14 @@
+import FWCore.ParameterSet.Config as cms
+
+# Loose lepton preselection shared by wJetFilter and zJetFilter
+# Thresholds must be at least as loose as those of all downstream filters (wJetFilter throws otherwise).
+# Downstream filters select an ID by its position in electronIDs/muonIDs (electronIDBit/muonIDBit).
+leptonPreselector = cms.EDProducer("LeptonPreselector",
+    srcMuons = cms.InputTag("slimmedMuons"),
+    srcElectrons = cms.InputTag("slimmedElectrons"),
+    minPtMuon = cms.double(20.0),
+    minPtElectron = cms.double(20.0),
+    maxEta = cms.double(2.5),
+    electronIDs = cms.vstring('cutBasedElectronID-Spring15-25ns-V1-standalone-medium'),
+    muonIDs = cms.vstring('AllGlobalMuons'),
+)
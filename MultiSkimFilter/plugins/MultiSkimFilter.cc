@@ -0,0 +1,410 @@
+// -*- C++ -*-
+//
+// Package:    EmergingAnalysis/MultiSkimFilter
+// Class:      MultiSkimFilter
+//
+/**\class MultiSkimFilter MultiSkimFilter.cc EmergingAnalysis/MultiSkimFilter/plugins/MultiSkimFilter.cc
+
+ Description: Evaluate all skim selections (signal, W+jet, Z+jet, gen HT) in a single pass over each event
+
+ Implementation:
+     Selections follow JetFilter, WJetFilter, ZJetFilter and GenJetFilter.
+     Lepton, MET and jet inputs are retrieved once and shared between the W and Z regions.
+     Leptons are read from LeptonPreselector, each region selects its electron and muon ID by bit
+     (electronIDBit/muonIDBit) and applies its minPtLepton to electrons and muons alike, as WJetFilter and
+     ZJetFilter apply minPtElectron to both flavours.
+     Only inputs needed by enabled regions are retrieved.
+     Products:
+       regionMask : int, bit i set if region i passed (see Region enum)
+       signalJets : PFJetRefVector of jets selected by signal region (same as JetFilter "selectedJets")
+       wjetJets   : PFJetCollection of jets selected by W+jet region (same as WJetFilter)
+       zjetJets   : pat::JetRefVector containing the jet recoiling against the Z
+       zP4        : PolarLorentzVector of Z candidate
+       genHt      : double, scalar sum of gen jet pt (same as GenJetFilter "genHt")
+     The filter passes if any enabled region passed.
+*/
+//
+
+
+// system include files
+#include <memory>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <utility>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDFilter.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <TMath.h>
+#include <Math/VectorUtil.h>
+
+// For creating/writing histograms
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+#include "TH1.h"
+
+// Data formats
+#include "DataFormats/JetReco/interface/PFJetCollection.h"
+#include "DataFormats/JetReco/interface/GenJetCollection.h"
+#include "DataFormats/PatCandidates/interface/Jet.h"
+#include "DataFormats/PatCandidates/interface/MET.h"
+
+// Utils
+#include "EmergingJetAnalysis/JetFilter/interface/LeadingJetSelector.h"
+#include "EmergingJetAnalysis/LeptonPreselector/interface/PreselectedLeptons.h"
+#include "EmergingJetAnalysis/Utils/interface/HistogramRegistry.h"
+
+// Namespace shorthands
+using std::string;
+using std::vector;
+
+//
+// constants, enums and typedefs
+//
+/// Lorentz vector
+typedef reco::Candidate::LorentzVector RecoLorentzVector;
+/// Lorentz vector
+typedef math::PtEtaPhiMLorentzVector PolarLorentzVector;
+
+//
+// class declaration
+//
+
+class MultiSkimFilter : public edm::global::EDFilter<> {
+  public:
+    explicit MultiSkimFilter(const edm::ParameterSet&);
+    ~MultiSkimFilter();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+    // Bit positions in regionMask
+    enum Region { SIGNAL=0, WJET, ZJET, GENHT, NREGIONS };
+
+  private:
+    virtual void beginJob() override;
+    virtual bool filter(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
+    virtual void endJob() override;
+
+    bool selectWJet(const emjet::PreselectedLeptons& electrons, const emjet::PreselectedLeptons& muons, const pat::MET& met,
+        const pat::JetCollection& jets, reco::PFJetCollection& selectedJets) const;
+    bool selectZJet(const emjet::PreselectedLeptons& electrons, const emjet::PreselectedLeptons& muons,
+        const pat::JetCollection& jets, int& selectedJetIndex, PolarLorentzVector& zP4) const;
+
+    // ----------member data ---------------------------
+    bool enabled_[NREGIONS];
+
+    // Signal region
+    edm::EDGetTokenT< reco::PFJetCollection > jetCollectionToken_;
+    std::unique_ptr<emjet::LeadingJetSelector> signalJetSelector_;
+
+    // Shared lepton/MET/jet inputs for W+jet and Z+jet regions
+    std::unique_ptr<emjet::PreselectedLeptonTokens> electronTokens_; // From LeptonPreselector
+    std::unique_ptr<emjet::PreselectedLeptonTokens> muonTokens_;
+    edm::EDGetTokenT< pat::JetCollection > patJetCollectionToken_;
+    edm::EDGetTokenT< pat::METCollection > metCollectionToken_;
+
+    // W+jet region
+    unsigned wjet_electronIDBit_; // Index of electron ID in LeptonPreselector electronIDs
+    unsigned wjet_muonIDBit_;     // Index of muon ID in LeptonPreselector muonIDs
+    double wjet_minPtLepton_;
+    double wjet_maxMuonRelIso_;
+    double wjet_minPtMET_;
+    double wjet_minMt_;
+    double wjet_maxMt_;
+    double wjet_minDeltaR_;
+    double wjet_minPtSelectedJet_;
+
+    // Z+jet region
+    unsigned zjet_electronIDBit_;
+    unsigned zjet_muonIDBit_;
+    double zjet_minPtLepton_;
+    double zjet_minZMass_;
+    double zjet_maxZMass_;
+    double zjet_maxDeltaPhi_;
+    double zjet_minPtSelectedJet_;
+    double zjet_maxPtAdditionalJets_;
+
+    // Gen HT region
+    edm::EDGetTokenT< reco::GenJetCollection > genJetCollectionToken_;
+    double genht_minPt_;
+    double genht_minGenHt_;
+
+    // Outputs
+    mutable emjet::HistogramRegistry histos_; // Filled concurrently from filter()
+    emjet::HistogramRegistry::H1 regionCount_; // Bin i+1 counts events passing region i, last bin counts all events
+};
+
+//
+// static data member definitions
+//
+static const char* regionNames[MultiSkimFilter::NREGIONS] = {"signal", "wjet", "zjet", "genht"};
+
+//
+// constructors and destructor
+//
+MultiSkimFilter::MultiSkimFilter(const edm::ParameterSet& iConfig)
+{
+  LogTrace("MultiSkimFilter") << "Constructing MultiSkimFilter";
+
+  vector<string> regions = iConfig.getParameter< vector<string> >("regions");
+  for (int iregion = 0; iregion < NREGIONS; iregion++) {
+    enabled_[iregion] = std::find(regions.begin(), regions.end(), regionNames[iregion]) != regions.end();
+  }
+  for (auto region : regions) {
+    if ( std::find(regionNames, regionNames+NREGIONS, region) == regionNames+NREGIONS )
+      throw cms::Exception("Configuration") << "MultiSkimFilter: Unknown region " << region;
+  }
+
+  if (enabled_[SIGNAL]) {
+    edm::ParameterSet pset = iConfig.getParameter<edm::ParameterSet>("signal");
+    jetCollectionToken_ = consumes< reco::PFJetCollection > (pset.getParameter<edm::InputTag>("srcJets"));
+    signalJetSelector_.reset( new emjet::LeadingJetSelector(pset) );
+    produces< reco::PFJetRefVector > ("signalJets"). setBranchAlias( "signalJets" );
+  }
+
+  if (enabled_[WJET] || enabled_[ZJET]) {
+    edm::InputTag srcLeptons = iConfig.getParameter<edm::InputTag>("srcLeptons");
+    electronTokens_.reset( new emjet::PreselectedLeptonTokens(srcLeptons, "electron", consumesCollector()) );
+    muonTokens_.reset( new emjet::PreselectedLeptonTokens(srcLeptons, "muon", consumesCollector()) );
+    patJetCollectionToken_ = consumes< pat::JetCollection > (iConfig.getParameter<edm::InputTag>("srcPatJets"));
+  }
+
+  if (enabled_[WJET]) {
+    edm::ParameterSet pset = iConfig.getParameter<edm::ParameterSet>("wjet");
+    metCollectionToken_ = consumes< pat::METCollection > (iConfig.getParameter<edm::InputTag>("srcMET"));
+    wjet_electronIDBit_    = pset.getParameter<unsigned>("electronIDBit");
+    wjet_muonIDBit_        = pset.getParameter<unsigned>("muonIDBit");
+    wjet_minPtLepton_      = pset.getParameter<double>("minPtLepton");
+    wjet_maxMuonRelIso_    = pset.getParameter<double>("maxMuonRelIso");
+    wjet_minPtMET_         = pset.getParameter<double>("minPtMET");
+    wjet_minMt_            = pset.getParameter<double>("minMt");
+    wjet_maxMt_            = pset.getParameter<double>("maxMt");
+    wjet_minDeltaR_        = pset.getParameter<double>("minDeltaR");
+    wjet_minPtSelectedJet_ = pset.getParameter<double>("minPtSelectedJet");
+    produces< reco::PFJetCollection > ("wjetJets"). setBranchAlias( "wjetJets" );
+  }
+
+  if (enabled_[ZJET]) {
+    edm::ParameterSet pset = iConfig.getParameter<edm::ParameterSet>("zjet");
+    zjet_electronIDBit_       = pset.getParameter<unsigned>("electronIDBit");
+    zjet_muonIDBit_           = pset.getParameter<unsigned>("muonIDBit");
+    zjet_minPtLepton_         = pset.getParameter<double>("minPtLepton");
+    zjet_minZMass_            = pset.getParameter<double>("minZMass");
+    zjet_maxZMass_            = pset.getParameter<double>("maxZMass");
+    zjet_maxDeltaPhi_         = pset.getParameter<double>("maxDeltaPhi");
+    zjet_minPtSelectedJet_    = pset.getParameter<double>("minPtSelectedJet");
+    zjet_maxPtAdditionalJets_ = pset.getParameter<double>("maxPtAdditionalJets");
+    produces< pat::JetRefVector > ("zjetJets"). setBranchAlias( "zjetJets" );
+    produces< PolarLorentzVector > ("zP4"). setBranchAlias( "zP4" );
+  }
+
+  if (enabled_[GENHT]) {
+    edm::ParameterSet pset = iConfig.getParameter<edm::ParameterSet>("genht");
+    genJetCollectionToken_ = consumes< reco::GenJetCollection > (pset.getParameter<edm::InputTag>("srcJets"));
+    genht_minPt_    = pset.getParameter<double>("minPt");
+    genht_minGenHt_ = pset.getParameter<double>("minGenHt");
+    produces< double > ("genHt"). setBranchAlias( "genHt" );
+  }
+
+  produces< int > ("regionMask"). setBranchAlias( "regionMask" );
+
+  regionCount_ = histos_.book1D("regionCount", "regionCount", NREGIONS+1, 0., NREGIONS+1.);
+  for (int iregion = 0; iregion < NREGIONS; iregion++) histos_.hist(regionCount_)->GetXaxis()->SetBinLabel(iregion+1, regionNames[iregion]);
+  histos_.hist(regionCount_)->GetXaxis()->SetBinLabel(NREGIONS+1, "all");
+}
+
+
+MultiSkimFilter::~MultiSkimFilter()
+{
+}
+
+
+//
+// member functions
+//
+
+// Same selection as WJetFilter
+bool
+MultiSkimFilter::selectWJet(const emjet::PreselectedLeptons& electrons, const emjet::PreselectedLeptons& muons, const pat::MET& met,
+    const pat::JetCollection& jets, reco::PFJetCollection& selectedJets) const
+{
+  if ( met.pt() < wjet_minPtMET_ ) return false;
+  // Require exactly one good lepton
+  const PolarLorentzVector* lepton = nullptr;
+  int nGoodLepton = 0;
+  for ( unsigned i = 0; i < electrons.size(); i++ ) {
+    if ( electrons.p4(i).pt() < wjet_minPtLepton_ ) continue;
+    if ( !electrons.passID(i, wjet_electronIDBit_) ) continue;
+    nGoodLepton++;
+    lepton = &electrons.p4(i);
+  }
+  for ( unsigned i = 0; i < muons.size(); i++ ) {
+    if ( muons.p4(i).pt() < wjet_minPtLepton_ ) continue;
+    if ( !muons.passID(i, wjet_muonIDBit_) ) continue;
+    if ( muons.relIso(i) > wjet_maxMuonRelIso_ ) continue;
+    nGoodLepton++;
+    lepton = &muons.p4(i);
+  }
+  if ( nGoodLepton != 1 ) return false;
+  float dPhi = TMath::Abs( ROOT::Math::VectorUtil::DeltaPhi( met.p4(), *lepton ) );
+  double mT = TMath::Sqrt( 2. * lepton->pt() * met.pt() * ( 1 - TMath::Cos(dPhi) ) );
+  // Select jets that are more than minDeltaR away from the lepton, and with pt > minPtSelectedJet
+  for ( const auto& jet : jets ) {
+    if ( ROOT::Math::VectorUtil::DeltaR( *lepton, jet.p4() ) < wjet_minDeltaR_ ) continue;
+    if ( jet.pt() < wjet_minPtSelectedJet_ ) continue;
+    const reco::Candidate* recoJet = jet.originalObject();
+    if ( recoJet && jet.isPFJet() ) {
+      if ( const reco::PFJet* pfJet = dynamic_cast<const reco::PFJet*>(recoJet) ) selectedJets.push_back( *pfJet );
+    }
+  }
+  if ( selectedJets.size() == 0 ) return false;
+  if ( mT < wjet_minMt_ || mT > wjet_maxMt_ ) return false;
+  return true;
+}
+
+// Same selection as ZJetFilter
+bool
+MultiSkimFilter::selectZJet(const emjet::PreselectedLeptons& electrons, const emjet::PreselectedLeptons& muons,
+    const pat::JetCollection& jets, int& selectedJetIndex, PolarLorentzVector& zP4) const
+{
+  bool zValidity = false;
+  // Leading two leptons of each flavour, assuming collections are sorted by pt
+  const std::pair<const emjet::PreselectedLeptons*, unsigned> flavours[] = { {&electrons, zjet_electronIDBit_}, {&muons, zjet_muonIDBit_} };
+  for ( const auto& flavour : flavours ) {
+    const emjet::PreselectedLeptons& leptons = *flavour.first;
+    vector<unsigned> goodLeptons;
+    for ( unsigned i = 0; i < leptons.size(); i++ ) {
+      if ( leptons.p4(i).pt() < zjet_minPtLepton_ ) continue;
+      if ( !leptons.passID(i, flavour.second) ) continue;
+      goodLeptons.push_back(i);
+    }
+    if ( goodLeptons.size() < 2 ) continue;
+    RecoLorentzVector zP4_ = RecoLorentzVector(leptons.p4(goodLeptons[0])) + RecoLorentzVector(leptons.p4(goodLeptons[1]));
+    if ( zjet_minZMass_ < zP4_.mass() && zP4_.mass() < zjet_maxZMass_ ) {
+      zP4 = zP4_;
+      zValidity = true;
+    }
+  }
+  if (!zValidity) return false;
+
+  // Find first jet opposite to Z
+  bool eventPassed = false;
+  for ( unsigned ijet = 0; ijet < jets.size(); ijet++ ) {
+    const auto& jet = jets[ijet];
+    float dPhi = ROOT::Math::VectorUtil::DeltaPhi( jet.p4(), -zP4 );
+    if ( dPhi < zjet_maxDeltaPhi_ && jet.pt() > zjet_minPtSelectedJet_ ) {
+      eventPassed = true;
+      selectedJetIndex = ijet;
+      break;
+    }
+  }
+  // Veto presence of additional hard jets
+  for ( unsigned ijet = 0; ijet < jets.size(); ijet++ ) {
+    if ( (int)ijet == selectedJetIndex ) continue;
+    if ( jets[ijet].pt() > zjet_maxPtAdditionalJets_ ) return false;
+  }
+  return eventPassed;
+}
+
+// ------------ method called on each new Event  ------------
+bool
+MultiSkimFilter::filter(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
+{
+  int regionMask = 0;
+
+  if (enabled_[SIGNAL]) {
+    edm::Handle< reco::PFJetCollection > jetCollection;
+    iEvent.getByToken(jetCollectionToken_, jetCollection);
+    vector<unsigned> selectedIndex;
+    if ( signalJetSelector_->select(*jetCollection, selectedIndex) ) regionMask |= (1 << SIGNAL);
+    std::unique_ptr< reco::PFJetRefVector > signalJets( new reco::PFJetRefVector() );
+    for (unsigned index : selectedIndex) signalJets->push_back( reco::PFJetRef(jetCollection, index) );
+    iEvent.put(std::move(signalJets), "signalJets");
+  }
+
+  if (enabled_[WJET] || enabled_[ZJET]) {
+    // Shared preselection
+    const emjet::PreselectedLeptons electrons = electronTokens_->get(iEvent);
+    const emjet::PreselectedLeptons muons = muonTokens_->get(iEvent);
+    edm::Handle< pat::JetCollection > patJetCollection;
+    iEvent.getByToken(patJetCollectionToken_, patJetCollection);
+
+    if (enabled_[WJET]) {
+      edm::Handle< pat::METCollection > metCollection;
+      iEvent.getByToken(metCollectionToken_, metCollection);
+      std::unique_ptr< reco::PFJetCollection > wjetJets( new reco::PFJetCollection() );
+      if ( selectWJet(electrons, muons, metCollection->at(0), *patJetCollection, *wjetJets) ) regionMask |= (1 << WJET);
+      iEvent.put(std::move(wjetJets), "wjetJets");
+    }
+
+    if (enabled_[ZJET]) {
+      int selectedJetIndex = -1;
+      PolarLorentzVector zP4;
+      bool passed = selectZJet(electrons, muons, *patJetCollection, selectedJetIndex, zP4);
+      if (passed) regionMask |= (1 << ZJET);
+      std::unique_ptr< pat::JetRefVector > zjetJets( new pat::JetRefVector() );
+      if (passed) zjetJets->push_back( pat::JetRef(patJetCollection, selectedJetIndex) );
+      iEvent.put(std::move(zjetJets), "zjetJets");
+      std::unique_ptr< PolarLorentzVector > _zP4( new PolarLorentzVector (zP4) );
+      iEvent.put(std::move(_zP4), "zP4");
+    }
+  }
+
+  if (enabled_[GENHT]) {
+    edm::Handle< reco::GenJetCollection > genJetCollection;
+    iEvent.getByToken(genJetCollectionToken_, genJetCollection);
+    double genHt = 0;
+    for ( const auto& jet : *genJetCollection ) {
+      if ( jet.pt() > genht_minPt_ ) genHt += jet.pt();
+    }
+    if ( genHt >= genht_minGenHt_ ) regionMask |= (1 << GENHT);
+    std::unique_ptr<double> _genHt( new double (genHt) );
+    iEvent.put(std::move(_genHt), "genHt");
+  }
+
+  for (int iregion = 0; iregion < NREGIONS; iregion++) {
+    if ( regionMask & (1 << iregion) ) histos_.fill(regionCount_, iregion);
+  }
+  histos_.fill(regionCount_, NREGIONS);
+  LogTrace("MultiSkimFilter") << "regionMask: " << regionMask;
+
+  std::unique_ptr< int > _regionMask( new int (regionMask) );
+  iEvent.put(std::move(_regionMask), "regionMask");
+
+  return regionMask != 0;
+}
+
+// ------------ method called once each job just before starting event loop  ------------
+void
+MultiSkimFilter::beginJob()
+{
+}
+
+// ------------ method called once each job just after ending the event loop  ------------
+void
+MultiSkimFilter::endJob() {
+  histos_.merge();
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+MultiSkimFilter::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  //The following says we do not know what parameters are allowed so do no validation
+  // Please change this to state exactly what you do use, even if it is no parameters
+  edm::ParameterSetDescription desc;
+  desc.setUnknown();
+  descriptions.addDefault(desc);
+}
+//define this as a plug-in
+DEFINE_FWK_MODULE(MultiSkimFilter);
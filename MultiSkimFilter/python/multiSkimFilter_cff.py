@@ -0,0 +1,64 @@
+import FWCore.ParameterSet.Config as cms
+
+# Single pass skim over all analysis regions
+# Bit i of regionMask is set if the i-th region passed: signal=0, wjet=1, zjet=2, genht=3
+# Remove regions from the list to skip them (and their inputs) entirely, e.g. genht for data
+multiSkimFilter = cms.EDFilter("MultiSkimFilter",
+    regions = cms.vstring("signal", "wjet", "zjet", "genht"),
+    # Signal region, same as jetFilter
+    signal = cms.PSet(
+        srcJets = cms.InputTag("ak4PFJetsCHS"),
+        doFilter = cms.bool(True),
+        additionalCut = cms.string("abs(eta) < 2.5 && pt > 50.0"),
+        jetCuts = cms.VPSet(
+            cms.PSet( minPt = cms.double(400.0), maxEta = cms.double(2.5), stringCut = cms.string(""), ),
+            cms.PSet( minPt = cms.double(200.0), maxEta = cms.double(2.5), stringCut = cms.string(""), ),
+            cms.PSet( minPt = cms.double(125.0), maxEta = cms.double(2.5), stringCut = cms.string(""), ),
+            cms.PSet( minPt = cms.double(50.0) , maxEta = cms.double(2.5), stringCut = cms.string(""), ),
+        ),
+    ),
+    # Shared inputs for wjet and zjet regions
+    srcPatJets = cms.InputTag("slimmedJets"),
+    srcMET = cms.InputTag("slimmedMETs"),
+    # Leptons from multiSkimLeptonPreselector (below), electronIDBit/muonIDBit are indices into its electronIDs/muonIDs
+    # minPtLepton is applied to electrons and muons alike, as minPtElectron in wJetFilter and zJetFilter
+    srcLeptons = cms.InputTag("multiSkimLeptonPreselector"),
+    # W+jet region, same as wJetFilter
+    wjet = cms.PSet(
+        electronIDBit = cms.uint32(0), # cutBasedElectronID-Spring15-25ns-V1-standalone-medium
+        muonIDBit = cms.uint32(0), # AllGlobalMuons
+        minPtLepton = cms.double(20.0),
+        maxMuonRelIso = cms.double(0.2),
+        minPtMET = cms.double(20.0),
+        minMt = cms.double(50.0),
+        maxMt = cms.double(100.0),
+        minDeltaR = cms.double(0.4),
+        minPtSelectedJet = cms.double(20.0),
+    ),
+    # Z+jet region, same as zJetFilter (ZJetFilter/test/ZJetFilter_cfg.py)
+    zjet = cms.PSet(
+        electronIDBit = cms.uint32(1), # cutBasedElectronID-CSA14-PU20bx25-V0-standalone-medium
+        muonIDBit = cms.uint32(0), # AllGlobalMuons
+        minPtLepton = cms.double(30.0),
+        minZMass = cms.double(80.0),
+        maxZMass = cms.double(100.0),
+        maxDeltaPhi = cms.double(0.4),
+        minPtSelectedJet = cms.double(50.0),
+        maxPtAdditionalJets = cms.double(50.0),
+    ),
+    # Gen HT, same as genJetFilter
+    genht = cms.PSet(
+        srcJets = cms.InputTag("ak4GenJets"),
+        minPt = cms.double(0.0),
+        minGenHt = cms.double(0.0),
+    ),
+)
+
+# Lepton preselection for the wjet and zjet regions, must contain the electron IDs of both regions
+from EmergingJetAnalysis.LeptonPreselector.leptonPreselector_cff import leptonPreselector
+multiSkimLeptonPreselector = leptonPreselector.clone(
+    electronIDs = cms.vstring(
+        'cutBasedElectronID-Spring15-25ns-V1-standalone-medium',
+        'cutBasedElectronID-CSA14-PU20bx25-V0-standalone-medium',
+    ),
+)
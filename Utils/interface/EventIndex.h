@@ -0,0 +1,188 @@
+#ifndef EmergingJetAnalysis_Utils_EventIndex_h
+#define EmergingJetAnalysis_Utils_EventIndex_h
+
+// Sorted event index, mapping (run, lumi, event) to (file, entry)
+// Written next to ntuples (EmJetAnalyzer) and skimmed EDM files (EventIndexWriter) as <file>.evtidx, and read by
+// emjetEventIndex to jump straight to listed events instead of streaming through whole files.
+// Entries of ntuples are tree entries. Entries of EDM files may be kNoEntry, since PoolSource finds events by
+// (run, lumi, event) through the file's own index (eventsToProcess), so only the file is needed.
+// File names are stored as given, relative names are relative to the directory of the index file.
+// Only depends on the standard library.
+//
+// File layout (native byte order):
+//   header  : char[4] "EJEI", uint32 VERSION
+//   files   : uint32 n, n times (uint32 length, chars)
+//   entries : uint32 n, n Entry records sorted by (run, event, lumi)
+//
+// Usage:
+//   EventIndex index;  index.Add(run, lumi, event, "ntuple.root", entry);  index.Write("ntuple.evtidx");
+//   EventIndex index("ntuple.evtidx");  for (const auto& e : index.Find(run, event)) index.fileName(e.file), e.entry
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace emjet
+{
+  class EventIndex {
+  public:
+    static const uint32_t VERSION = 1;
+    static const uint64_t kNoEntry = ~uint64_t(0);
+
+    struct Entry {
+      uint32_t run, lumi;
+      uint64_t event;
+      uint64_t entry;
+      uint32_t file; // Index into fileNames()
+      bool operator<(const Entry& other) const {
+        if (run != other.run) return run < other.run;
+        if (event != other.event) return event < other.event;
+        return lumi < other.lumi;
+      }
+    };
+
+    EventIndex() : sorted_(true) {}
+    explicit EventIndex(const std::string& filename) : sorted_(true) { Read(filename); }
+
+    void Add(uint32_t run, uint32_t lumi, uint64_t event, const std::string& fileName, uint64_t entry = kNoEntry);
+    // Add all entries of other, e.g. to combine the indices of several jobs
+    void Merge(const EventIndex& other);
+    void Read(const std::string& filename);
+    void Write(const std::string& filename);
+    // Needed before Find after Add or Merge, done by Write
+    void Sort();
+
+    // Entries of (run, event), lumi = 0 matches any lumi
+    std::vector<Entry> Find(uint32_t run, uint64_t event, uint32_t lumi = 0) const;
+
+    size_t size() const { return entries_.size(); }
+    const std::vector<Entry>& entries() const { return entries_; }
+    const std::vector<std::string>& fileNames() const { return fileNames_; }
+    const std::string& fileName(uint32_t file) const { return fileNames_.at(file); }
+
+    // Sidecar name of a data file, "dir/ntuple.root" -> "dir/ntuple.evtidx"
+    static std::string sidecarName(const std::string& fileName) {
+      std::string base = fileName;
+      if (base.size() > 5 && base.compare(base.size()-5, 5, ".root") == 0) base.erase(base.size()-5);
+      return base + ".evtidx";
+    }
+
+  private:
+    uint32_t fileIndex(const std::string& fileName);
+
+    std::vector<std::string> fileNames_;
+    std::map<std::string, uint32_t> fileIds_;
+    std::vector<Entry> entries_;
+    bool sorted_;
+  };
+}
+
+inline uint32_t
+emjet::EventIndex::fileIndex(const std::string& fileName)
+{
+  auto it = fileIds_.find(fileName);
+  if (it != fileIds_.end()) return it->second;
+  uint32_t id = fileNames_.size();
+  fileNames_.push_back(fileName);
+  fileIds_[fileName] = id;
+  return id;
+}
+
+inline void
+emjet::EventIndex::Add(uint32_t run, uint32_t lumi, uint64_t event, const std::string& fileName, uint64_t entry)
+{
+  Entry e = { run, lumi, event, entry, fileIndex(fileName) };
+  if (sorted_ && !entries_.empty() && e < entries_.back()) sorted_ = false;
+  entries_.push_back(e);
+}
+
+inline void
+emjet::EventIndex::Merge(const EventIndex& other)
+{
+  for (const auto& e : other.entries_) Add(e.run, e.lumi, e.event, other.fileNames_[e.file], e.entry);
+}
+
+inline void
+emjet::EventIndex::Sort()
+{
+  if (!sorted_) std::stable_sort(entries_.begin(), entries_.end());
+  sorted_ = true;
+}
+
+inline std::vector<emjet::EventIndex::Entry>
+emjet::EventIndex::Find(uint32_t run, uint64_t event, uint32_t lumi) const
+{
+  if (!sorted_) throw std::logic_error("EventIndex: Find called on unsorted index, Sort first");
+  Entry first = { run, 0, event, 0, 0 };
+  std::vector<Entry> result;
+  for (auto it = std::lower_bound(entries_.begin(), entries_.end(), first);
+       it != entries_.end() && it->run == run && it->event == event; ++it) {
+    if (lumi == 0 || it->lumi == lumi) result.push_back(*it);
+  }
+  return result;
+}
+
+inline void
+emjet::EventIndex::Write(const std::string& filename)
+{
+  Sort();
+  std::ofstream os(filename.c_str(), std::ios::binary);
+  if (!os) throw std::runtime_error("EventIndex: can not open " + filename);
+  auto writePOD = [&os](const void* p, size_t n) { os.write(reinterpret_cast<const char*>(p), n); };
+  uint32_t version = VERSION;
+  os.write("EJEI", 4);
+  writePOD(&version, sizeof(version));
+  uint32_t n = fileNames_.size();
+  writePOD(&n, sizeof(n));
+  for (const auto& name : fileNames_) {
+    uint32_t length = name.size();
+    writePOD(&length, sizeof(length));
+    os.write(name.data(), length);
+  }
+  n = entries_.size();
+  writePOD(&n, sizeof(n));
+  for (const auto& e : entries_) {
+    writePOD(&e.run, sizeof(e.run)); writePOD(&e.lumi, sizeof(e.lumi)); writePOD(&e.event, sizeof(e.event));
+    writePOD(&e.entry, sizeof(e.entry)); writePOD(&e.file, sizeof(e.file));
+  }
+  if (!os) throw std::runtime_error("EventIndex: write to " + filename + " failed");
+}
+
+inline void
+emjet::EventIndex::Read(const std::string& filename)
+{
+  std::ifstream is(filename.c_str(), std::ios::binary);
+  auto readPOD = [&is](void* p, size_t n) { is.read(reinterpret_cast<char*>(p), n); };
+  char magic[4];
+  uint32_t version = 0;
+  if (!is || !is.read(magic, 4) || std::strncmp(magic, "EJEI", 4) != 0)
+    throw std::runtime_error("EventIndex: " + filename + " is not an event index");
+  readPOD(&version, sizeof(version));
+  if (version != VERSION)
+    throw std::runtime_error("EventIndex: " + filename + " has unsupported version " + std::to_string(version));
+  fileNames_.clear(); fileIds_.clear(); entries_.clear();
+  uint32_t n = 0;
+  readPOD(&n, sizeof(n));
+  for (uint32_t i = 0; i < n && is; i++) {
+    uint32_t length = 0;
+    readPOD(&length, sizeof(length));
+    std::string name(length, ' ');
+    if (length) is.read(&name[0], length);
+    fileIndex(name);
+  }
+  readPOD(&n, sizeof(n));
+  entries_.resize(n);
+  for (auto& e : entries_) {
+    readPOD(&e.run, sizeof(e.run)); readPOD(&e.lumi, sizeof(e.lumi)); readPOD(&e.event, sizeof(e.event));
+    readPOD(&e.entry, sizeof(e.entry)); readPOD(&e.file, sizeof(e.file));
+  }
+  if (!is) throw std::runtime_error("EventIndex: " + filename + " is truncated");
+  sorted_ = true;
+}
+
+#endif
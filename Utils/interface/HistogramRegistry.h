@@ -0,0 +1,197 @@
+#ifndef EmergingJetAnalysis_Utils_HistogramRegistry_h
+#define EmergingJetAnalysis_Utils_HistogramRegistry_h
+
+// Histograms with pre-resolved handles and per-thread fill buffers
+// Histograms are booked once (typically in the module constructor) through TFileService,
+// each booking returns a typed handle that is used for filling, so there is no lookup by name per fill.
+// Fills only touch a buffer owned by the calling thread, and are added to the booked histograms by merge(),
+// which must be called once all fills are done (typically in endJob).
+// Fill semantics follow TH1::Fill: under/overflow bins are filled, statistics only count in-range fills.
+//
+// Usage:
+//   emjet::HistogramRegistry histos_;
+//   emjet::HistogramRegistry::H1 hist_pt_;
+//   ctor:    hist_pt_ = histos_.book1D("pt", "pt", 100, 0., 1000.);
+//   analyze: histos_.fill(hist_pt_, jet.pt());
+//   endJob:  histos_.merge();
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cmath>
+#include <algorithm>
+
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+#include "TH1.h"
+#include "TH2.h"
+
+namespace emjet
+{
+  class HistogramRegistry {
+  public:
+    // Typed handles, only valid for the registry that returned them
+    struct H1 { int index; H1() : index(-1) {} };
+    struct H2 { int index; H2() : index(-1) {} };
+
+    HistogramRegistry() : id_(nextId()) {}
+
+    // Book histogram in TFileService
+    // TH may be any TH1 (TH2) subclass with the usual (name, title, nbins, low, high) constructor
+    template <class TH=TH1D>
+    H1 book1D(const std::string& name, const std::string& title, int nbinsx, double xlow, double xhigh);
+    template <class TH=TH2D>
+    H2 book2D(const std::string& name, const std::string& title, int nbinsx, double xlow, double xhigh,
+              int nbinsy, double ylow, double yhigh);
+
+    void fill(H1 h, double x, double w=1.0) { buffer().fill(h.index, layout_[h.index], x, 0, w); }
+    void fill(H2 h, double x, double y, double w=1.0) { buffer().fill(h.index, layout_[h.index], x, y, w); }
+
+    // Booked histogram, for setting options (e.g. Sumw2) or reading back after merge()
+    TH1* hist(H1 h) const { return layout_[h.index].hist; }
+    TH2* hist(H2 h) const { return static_cast<TH2*>(layout_[h.index].hist); }
+
+    // Add all thread buffers to the booked histograms, and reset buffers
+    void merge();
+
+  private:
+    // Axis definition and position in buffer of one histogram
+    struct Layout {
+      TH1* hist;
+      int nx, ny;             // Number of bins, ny=0 for 1D
+      double xlow, xhigh, ylow, yhigh;
+      unsigned offset;        // Offset of first bin in Buffer::sumw
+    };
+    // Statistics kept per histogram, same meaning as TH1::GetStats
+    enum { SUMW, SUMW2, SUMWX, SUMWX2, SUMWY, SUMWY2, SUMWXY, NSTATS };
+    struct Buffer {
+      std::vector<double> sumw, sumw2; // Per bin, for all histograms
+      std::vector<double> stats;       // NSTATS per histogram
+      std::vector<double> entries;     // Per histogram
+      void fill(int index, const Layout& l, double x, double y, double w);
+    };
+
+    static int axisBin(int n, double low, double high, double x) {
+      if (x < low) return 0;
+      if (!(x < high)) return n+1;
+      return 1 + int( n * (x - low) / (high - low) );
+    }
+    static unsigned long nextId() { static std::atomic<unsigned long> id(0); return ++id; }
+    Buffer& buffer();
+
+    unsigned long id_; // Unique per registry, identifies thread buffers
+    std::vector<Layout> layout_;
+    unsigned nBins_ = 0;
+    std::mutex mutex_;
+    std::vector< std::unique_ptr<Buffer> > buffers_;
+  };
+}
+
+template <class TH>
+emjet::HistogramRegistry::H1
+emjet::HistogramRegistry::book1D(const std::string& name, const std::string& title, int nbinsx, double xlow, double xhigh)
+{
+  edm::Service<TFileService> fs;
+  TH* hist = fs->make<TH>(name.c_str(), title.c_str(), nbinsx, xlow, xhigh);
+  layout_.push_back( Layout{hist, nbinsx, 0, xlow, xhigh, 0., 0., nBins_} );
+  nBins_ += nbinsx+2;
+  H1 h; h.index = layout_.size()-1;
+  return h;
+}
+
+template <class TH>
+emjet::HistogramRegistry::H2
+emjet::HistogramRegistry::book2D(const std::string& name, const std::string& title, int nbinsx, double xlow, double xhigh,
+                                 int nbinsy, double ylow, double yhigh)
+{
+  edm::Service<TFileService> fs;
+  TH* hist = fs->make<TH>(name.c_str(), title.c_str(), nbinsx, xlow, xhigh, nbinsy, ylow, yhigh);
+  layout_.push_back( Layout{hist, nbinsx, nbinsy, xlow, xhigh, ylow, yhigh, nBins_} );
+  nBins_ += (nbinsx+2)*(nbinsy+2);
+  H2 h; h.index = layout_.size()-1;
+  return h;
+}
+
+inline void
+emjet::HistogramRegistry::Buffer::fill(int index, const Layout& l, double x, double y, double w)
+{
+  int binx = axisBin(l.nx, l.xlow, l.xhigh, x);
+  int biny = l.ny ? axisBin(l.ny, l.ylow, l.yhigh, y) : 0;
+  unsigned bin = l.offset + biny*(l.nx+2) + binx; // Same global bin numbering as TH1::GetBin
+  sumw[bin]  += w;
+  sumw2[bin] += w*w;
+  entries[index] += 1;
+  if ( binx == 0 || binx == l.nx+1 ) return;
+  if ( l.ny && (biny == 0 || biny == l.ny+1) ) return;
+  double* s = &stats[index*NSTATS];
+  s[SUMW]   += w;
+  s[SUMW2]  += w*w;
+  s[SUMWX]  += w*x;
+  s[SUMWX2] += w*x*x;
+  s[SUMWY]  += w*y;
+  s[SUMWY2] += w*y*y;
+  s[SUMWXY] += w*x*y;
+}
+
+inline emjet::HistogramRegistry::Buffer&
+emjet::HistogramRegistry::buffer()
+{
+  // Per-thread list of (registry id, buffer), usually only a few registries (modules) per job
+  thread_local std::vector< std::pair<unsigned long, Buffer*> > threadBuffers;
+  for (const auto& entry : threadBuffers) {
+    if (entry.first == id_) return *entry.second;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  Buffer* b = new Buffer;
+  b->sumw.assign(nBins_, 0.);
+  b->sumw2.assign(nBins_, 0.);
+  b->stats.assign(layout_.size()*NSTATS, 0.);
+  b->entries.assign(layout_.size(), 0.);
+  buffers_.emplace_back(b);
+  threadBuffers.push_back( std::make_pair(id_, b) );
+  return *b;
+}
+
+inline void
+emjet::HistogramRegistry::merge()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& b : buffers_) {
+    for (unsigned ih = 0; ih < layout_.size(); ih++) {
+      const Layout& l = layout_[ih];
+      if ( b->entries[ih] == 0 ) continue;
+      TH1* hist = l.hist;
+      // Statistics are recomputed from bin contents by SetBinContent, so save and restore them
+      double stats[NSTATS] = {0};
+      hist->GetStats(stats);
+      double entries = hist->GetEntries();
+      unsigned nbins = (l.nx+2) * (l.ny ? l.ny+2 : 1);
+      // Like TH1::Fill, weighted fills switch on Sumw2
+      bool hasSumw2 = hist->GetSumw2N() > 0;
+      for (unsigned bin = 0; bin < nbins && !hasSumw2; bin++) {
+        if ( b->sumw2[l.offset+bin] != b->sumw[l.offset+bin] ) { hist->Sumw2(); hasSumw2 = true; }
+      }
+      for (unsigned bin = 0; bin < nbins; bin++) {
+        double sumw = b->sumw[l.offset+bin];
+        if ( sumw == 0 && b->sumw2[l.offset+bin] == 0 ) continue;
+        if ( hasSumw2 ) {
+          double error = hist->GetBinError(bin);
+          hist->SetBinError( bin, std::sqrt(error*error + b->sumw2[l.offset+bin]) );
+        }
+        hist->SetBinContent( bin, hist->GetBinContent(bin) + sumw );
+      }
+      int nstats = l.ny ? NSTATS : SUMWY;
+      for (int i = 0; i < nstats; i++) stats[i] += b->stats[ih*NSTATS+i];
+      hist->PutStats(stats);
+      hist->SetEntries(entries + b->entries[ih]);
+    }
+    std::fill(b->sumw.begin(), b->sumw.end(), 0.);
+    std::fill(b->sumw2.begin(), b->sumw2.end(), 0.);
+    std::fill(b->stats.begin(), b->stats.end(), 0.);
+    std::fill(b->entries.begin(), b->entries.end(), 0.);
+  }
+}
+
+#endif
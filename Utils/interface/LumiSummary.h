@@ -0,0 +1,58 @@
+#ifndef EmergingJetAnalysis_Utils_LumiSummary_h
+#define EmergingJetAnalysis_Utils_LumiSummary_h
+
+// Per luminosity block event counts of one selection stage
+// Written by EventCounter at the end of each luminosity block to a small lumiSummary tree in the module's
+// TFileService directory (one stage per EventCounter instance), and aggregated by emjetLumiSummary.
+// Normalization only needs these trees, never the event trees.
+//
+// Tree layout, one entry per luminosity block:
+//   run/i, lumi/i, events/l, sumWeights/D, sumWeights2/D
+// Weights are generator event weights (1 for data), sumWeights2 gives the statistical uncertainty of sumWeights.
+//
+// Usage:
+//   LumiSummaryRow row;  row.Branch(tree);  row.run = ...; row.counts = counts; tree->Fill();
+//   LumiSummaryRow row;  row.SetAddresses(tree);  tree->GetEntry(i);  row.counts.sumWeights
+
+#include "TTree.h"
+
+namespace emjet
+{
+  struct LumiCounts {
+    ULong64_t events;
+    double sumWeights, sumWeights2;
+
+    LumiCounts() : events(0), sumWeights(0.), sumWeights2(0.) {}
+    void fill(double weight) { events++; sumWeights += weight; sumWeights2 += weight*weight; }
+    void add(const LumiCounts& other) {
+      events += other.events;
+      sumWeights += other.sumWeights;
+      sumWeights2 += other.sumWeights2;
+    }
+  };
+
+  struct LumiSummaryRow {
+    static const char* treeName() { return "lumiSummary"; }
+
+    UInt_t run, lumi;
+    LumiCounts counts;
+
+    LumiSummaryRow() : run(0), lumi(0) {}
+    void Branch(TTree* tree) {
+      tree->Branch("run"        , &run               , "run/i"        );
+      tree->Branch("lumi"       , &lumi              , "lumi/i"       );
+      tree->Branch("events"     , &counts.events     , "events/l"     );
+      tree->Branch("sumWeights" , &counts.sumWeights , "sumWeights/D" );
+      tree->Branch("sumWeights2", &counts.sumWeights2, "sumWeights2/D");
+    }
+    void SetAddresses(TTree* tree) {
+      tree->SetBranchAddress("run"        , &run               );
+      tree->SetBranchAddress("lumi"       , &lumi              );
+      tree->SetBranchAddress("events"     , &counts.events     );
+      tree->SetBranchAddress("sumWeights" , &counts.sumWeights );
+      tree->SetBranchAddress("sumWeights2", &counts.sumWeights2);
+    }
+  };
+}
+
+#endif
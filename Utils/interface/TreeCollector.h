@@ -0,0 +1,56 @@
+#ifndef EmergingJetAnalysis_Utils_TreeCollector_h
+#define EmergingJetAnalysis_Utils_TreeCollector_h
+
+// Thread-safe TTree output for edm::global and edm::stream modules
+// Modules fill a Row object local to the event, and pass it to fill(),
+// which copies it into the row bound to the tree branches and fills the tree under a lock.
+// The lock is shared by all collectors, since all trees are written to the same TFileService file.
+//
+// Usage:
+//   struct Row { int run; vector<double> jets_pt; };
+//   emjet::TreeCollector<Row> tree_;
+//   ctor:    tree_.book("MyTree", "MyTree"); tree_.branch("run", &Row::run); tree_.branch("jets_pt", &Row::jets_pt);
+//   filter:  Row row; row.run = ...; tree_.fill(row);
+
+#include <string>
+#include <mutex>
+
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+#include "TTree.h"
+
+namespace emjet
+{
+  // Lock for writing to TFileService trees
+  inline std::mutex& treeCollectorMutex() { static std::mutex m; return m; }
+
+  template <class Row>
+  class TreeCollector {
+  public:
+    TreeCollector() : tree_(nullptr) {}
+    explicit TreeCollector(const Row& initial) : row_(initial), tree_(nullptr) {}
+
+    // Create tree in TFileService
+    void book(const std::string& name, const std::string& title) {
+      edm::Service<TFileService> fs;
+      tree_ = fs->make<TTree>(name.c_str(), title.c_str());
+    }
+    // Bind branch to a member of Row
+    template <class T>
+    void branch(const char* name, T Row::* member) { tree_->Branch(name, &(row_.*member)); }
+
+    void fill(const Row& row) const {
+      std::lock_guard<std::mutex> lock(treeCollectorMutex());
+      row_ = row;
+      tree_->Fill();
+    }
+
+    TTree* tree() const { return tree_; }
+
+  private:
+    mutable Row row_; // Bound to branches, only accessed under lock
+    TTree* tree_;
+  };
+}
+
+#endif
@@ -22,17 +22,18 @@
 #include <vector>
 #include <string>
 #include <iostream>
-#include <unordered_map>
 #include <cassert>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
-#include "FWCore/Framework/interface/EDFilter.h"
+#include "FWCore/Framework/interface/global/EDFilter.h"
 
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 
 #include <TVector3.h>
 #include <TMath.h>
@@ -53,6 +54,10 @@
 
 #include "SimDataFormats/GeneratorProducts/interface/GenEventInfoProduct.h"
 
+#include "EmergingJetAnalysis/LeptonPreselector/interface/PreselectedLeptons.h"
+#include "EmergingJetAnalysis/Utils/interface/HistogramRegistry.h"
+#include "EmergingJetAnalysis/Utils/interface/TreeCollector.h"
+
 // Namespace shorthands
 using std::string;
 using std::vector;
@@ -61,7 +66,7 @@ using std::vector;
 // class declaration
 //
 
-class WJetFilter : public edm::EDFilter {
+class WJetFilter : public edm::global::EDFilter<> {
   public:
     explicit WJetFilter(const edm::ParameterSet&);
     ~WJetFilter();
@@ -70,7 +75,7 @@ class WJetFilter : public edm::EDFilter {
 
   private:
     virtual void beginJob() override;
-    virtual bool filter(edm::Event&, const edm::EventSetup&) override;
+    virtual bool filter(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
     virtual void endJob() override;
 
     //virtual void beginRun(edm::Run const&, edm::EventSetup const&) override;
@@ -83,8 +88,8 @@ class WJetFilter : public edm::EDFilter {
     string alias_; // Alias suffix for all products
     bool isData_;
     // Retrieve once per event
-    edm::EDGetTokenT< pat::MuonCollection > muonCollectionToken_;
-    edm::EDGetTokenT< pat::ElectronCollection > electronCollectionToken_;
+    emjet::PreselectedLeptonTokens electronTokens_; // From LeptonPreselector
+    emjet::PreselectedLeptonTokens muonTokens_;
     edm::EDGetTokenT< pat::JetCollection > jetCollectionToken_;
     edm::EDGetTokenT< pat::METCollection > metCollectionToken_;
     double minPtMuon_;
@@ -96,13 +101,24 @@ class WJetFilter : public edm::EDFilter {
     double maxDeltaPhi_;
     double minPtSelectedJet_;
     double maxPtAdditionalJets_;
-    string electronID_;
+    unsigned electronIDBit_; // Index of electron ID in LeptonPreselector electronIDs
+    unsigned muonIDBit_;     // Index of muon ID in LeptonPreselector muonIDs
 
     // Outputs
-    std::unordered_map<string, TH1*> histoMap1D_;
-    std::unordered_map<string, TH2*> histoMap2D_;
+    mutable emjet::HistogramRegistry histos_; // Filled concurrently from filter()
+    emjet::HistogramRegistry::H1 hist_eventCountPreFilter_;
+    emjet::HistogramRegistry::H1 hist_eventCountPostFilter_;
+    emjet::HistogramRegistry::H1 hist_pt_met_;
+    emjet::HistogramRegistry::H1 hist_mT_e_;
+    emjet::HistogramRegistry::H1 hist_mT_mu_;
+    emjet::HistogramRegistry::H1 hist_nGoodLepton_;
+    emjet::HistogramRegistry::H1 hist_nSelectedJet_;
+    emjet::HistogramRegistry::H1 hist_pt_selectedJet_;
+    emjet::HistogramRegistry::H1 hist_dPhi_jet_met_;
+    emjet::HistogramRegistry::H1 hist_dPhi_jet_lepton_;
+    emjet::HistogramRegistry::H1 hist_dPhi_jet_w_;
+    emjet::HistogramRegistry::H2 hist_pt_jetIndex_;
 
-    TTree* outputTree;
     struct outputClass {
       public:
         int run;
@@ -121,7 +137,7 @@ class WJetFilter : public edm::EDFilter {
         vector<double> jets_eta;
         vector<double> jets_phi;
     };
-    outputClass output;
+    emjet::TreeCollector<outputClass> outputTree;
 };
 
 //
@@ -143,6 +159,8 @@ typedef math::PtEtaPhiMLorentzVector PolarLorentzVector;
 //
 WJetFilter::WJetFilter(const edm::ParameterSet& iConfig) :
     isData_              ( iConfig.getParameter<bool  > ( "isData"              )  ) ,
+    electronTokens_      ( iConfig.getParameter<edm::InputTag>("srcLeptons"), "electron", consumesCollector() ) ,
+    muonTokens_          ( iConfig.getParameter<edm::InputTag>("srcLeptons"), "muon"    , consumesCollector() ) ,
     minPtMuon_           ( iConfig.getParameter<double> ( "minPtMuon"           )  ) ,
     minPtElectron_       ( iConfig.getParameter<double> ( "minPtElectron"       )  ) ,
     minPtMET_            ( iConfig.getParameter<double> ( "minPtMET"            )  ) ,
@@ -152,16 +170,18 @@ WJetFilter::WJetFilter(const edm::ParameterSet& iConfig) :
     maxDeltaPhi_         ( iConfig.getParameter<double> ( "maxDeltaPhi"         )  ) ,
     minPtSelectedJet_    ( iConfig.getParameter<double> ( "minPtSelectedJet"    )  ) ,
     maxPtAdditionalJets_ ( iConfig.getParameter<double> ( "maxPtAdditionalJets" )  ) ,
-    electronID_          ( iConfig.getParameter<string> ( "electronID"          )  ) ,
-    output( { -1, -1, -1, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, std::vector<double>(), std::vector<double>(), std::vector<double>() } )
+    electronIDBit_       ( iConfig.getParameter<unsigned> ( "electronIDBit"     )  ) ,
+    muonIDBit_           ( iConfig.getParameter<unsigned> ( "muonIDBit"         )  )
 {
    //now do what ever initialization is needed
   LogTrace("WJetFilter") << "Constructing WJetFilter";
 
+  // Preselection must not be tighter than the cuts below
+  emjet::checkPreselectionThreshold(iConfig.getParameter<edm::InputTag>("srcLeptons"), "electron", minPtElectron_, "WJetFilter");
+  emjet::checkPreselectionThreshold(iConfig.getParameter<edm::InputTag>("srcLeptons"), "muon"    , minPtMuon_    , "WJetFilter");
+
   alias_ = iConfig.getParameter<string>("@module_label");
 
-  muonCollectionToken_ = consumes< pat::MuonCollection > (iConfig.getParameter<edm::InputTag>("srcMuons"));
-  electronCollectionToken_ = consumes< pat::ElectronCollection > (iConfig.getParameter<edm::InputTag>("srcElectrons"));
   jetCollectionToken_ = consumes< pat::JetCollection > (iConfig.getParameter<edm::InputTag>("srcJets"));
   metCollectionToken_ = consumes< pat::METCollection > (iConfig.getParameter<edm::InputTag>("srcMET"));
 
@@ -175,50 +195,47 @@ WJetFilter::WJetFilter(const edm::ParameterSet& iConfig) :
   // produces< vector<double> > ("deltaPhi")  . setBranchAlias( string("deltaPhi_").append(alias_) );
   // produces< bool > ("eventPassed")  . setBranchAlias( string("eventPassed_").append(alias_) );
 
-  edm::Service<TFileService> fs;
-  string name;
-  name="eventCountPreFilter"  ; histoMap1D_.emplace( name , fs->make<TH1D>(name.c_str() , name.c_str() , 2 , 0., 2.) );
-  name="eventCountPostFilter" ; histoMap1D_.emplace( name , fs->make<TH1D>(name.c_str() , name.c_str() , 2 , 0., 2.) );
+  hist_eventCountPreFilter_ = histos_.book1D( "eventCountPreFilter" , "eventCountPreFilter" , 2 , 0., 2. );
+  hist_eventCountPostFilter_ = histos_.book1D( "eventCountPostFilter" , "eventCountPostFilter" , 2 , 0., 2. );
 
-  name="pt_met"  ; histoMap1D_.emplace( name , fs->make<TH1D>(name.c_str() , name.c_str() , 100 , 0., 1000.) );
+  hist_pt_met_ = histos_.book1D( "pt_met" , "pt_met" , 100 , 0., 1000. );
 
-  name="mT_e"  ; histoMap1D_.emplace( name , fs->make<TH1D>(name.c_str() , name.c_str() , 100 , 0., 200.) );
-  name="mT_mu" ; histoMap1D_.emplace( name , fs->make<TH1D>(name.c_str() , name.c_str() , 100 , 0., 200.) );
+  hist_mT_e_ = histos_.book1D( "mT_e" , "mT_e" , 100 , 0., 200. );
+  hist_mT_mu_ = histos_.book1D( "mT_mu" , "mT_mu" , 100 , 0., 200. );
 
-  name="nGoodLepton" ; histoMap1D_.emplace( name , fs->make<TH1D>(name.c_str() , name.c_str() , 20 , 0., 20.) );
-  name="nSelectedJet" ; histoMap1D_.emplace( name , fs->make<TH1D>(name.c_str() , name.c_str() , 20 , 0., 20.) );
+  hist_nGoodLepton_ = histos_.book1D( "nGoodLepton" , "nGoodLepton" , 20 , 0., 20. );
+  hist_nSelectedJet_ = histos_.book1D( "nSelectedJet" , "nSelectedJet" , 20 , 0., 20. );
 
-  name="pt_jetIndex"  ; histoMap2D_.emplace( name , fs->make<TH2D>(name.c_str() , name.c_str() , 100 , 0.  , 1000. , 10 , 0. , 10. )) ;
+  hist_pt_jetIndex_ = histos_.book2D( "pt_jetIndex" , "pt_jetIndex" , 100 , 0.  , 1000. , 10 , 0. , 10. );
 
-  name="pt_selectedJet" ; histoMap1D_.emplace( name , fs->make<TH1D>(name.c_str() , name.c_str() , 100 , 0., 200.) );
+  hist_pt_selectedJet_ = histos_.book1D( "pt_selectedJet" , "pt_selectedJet" , 100 , 0., 200. );
 
-  name="dPhi_jet_met"    ; histoMap1D_.emplace( name , fs->make<TH1D>(name.c_str() , name.c_str() , 100 , 0., 5.) ) ;
-  name="dPhi_jet_lepton" ; histoMap1D_.emplace( name , fs->make<TH1D>(name.c_str() , name.c_str() , 100 , 0., 5.) ) ;
-  name="dPhi_jet_w"      ; histoMap1D_.emplace( name , fs->make<TH1D>(name.c_str() , name.c_str() , 100 , 0., 5.) ) ;
+  hist_dPhi_jet_met_ = histos_.book1D( "dPhi_jet_met" , "dPhi_jet_met" , 100 , 0., 5. );
+  hist_dPhi_jet_lepton_ = histos_.book1D( "dPhi_jet_lepton" , "dPhi_jet_lepton" , 100 , 0., 5. );
+  hist_dPhi_jet_w_ = histos_.book1D( "dPhi_jet_w" , "dPhi_jet_w" , 100 , 0., 5. );
 
-  for ( auto const & it : histoMap1D_ ) {
-    it.second->Sumw2();
-  }
-  for ( auto const & it : histoMap2D_ ) {
-    it.second->Sumw2();
+  for ( auto h : {hist_eventCountPreFilter_, hist_eventCountPostFilter_, hist_pt_met_, hist_mT_e_, hist_mT_mu_, hist_nGoodLepton_,
+                   hist_nSelectedJet_, hist_pt_selectedJet_, hist_dPhi_jet_met_, hist_dPhi_jet_lepton_, hist_dPhi_jet_w_} ) {
+    histos_.hist(h)->Sumw2();
   }
-
-  outputTree = fs->make<TTree>("WJetFilterTree", "WJetFilterTree");
-  outputTree->Branch("run"            , &output.run            ) ;
-  outputTree->Branch("lumi"           , &output.lumi           ) ;
-  outputTree->Branch("event"          , &output.event          ) ;
-  outputTree->Branch("gen_weight"     , &output.gen_weight     ) ;
-  outputTree->Branch("met_pt"         , &output.met_pt         ) ;
-  outputTree->Branch("met_phi"        , &output.met_phi        ) ;
-  outputTree->Branch("lepton_pt"      , &output.lepton_pt      ) ;
-  outputTree->Branch("lepton_eta"     , &output.lepton_eta     ) ;
-  outputTree->Branch("lepton_phi"     , &output.lepton_phi     ) ;
-  outputTree->Branch("lepton_relIso"  , &output.lepton_relIso  ) ;
-  outputTree->Branch("mT_e"           , &output.mT_e           ) ;
-  outputTree->Branch("mT_u"           , &output.mT_u           ) ;
-  outputTree->Branch("jets_pt"        , &output.jets_pt        ) ;
-  outputTree->Branch("jets_eta"       , &output.jets_eta       ) ;
-  outputTree->Branch("jets_phi"       , &output.jets_phi       ) ;
+  histos_.hist(hist_pt_jetIndex_)->Sumw2();
+
+  outputTree.book("WJetFilterTree", "WJetFilterTree");
+  outputTree.branch("run"            , &outputClass::run            ) ;
+  outputTree.branch("lumi"           , &outputClass::lumi           ) ;
+  outputTree.branch("event"          , &outputClass::event          ) ;
+  outputTree.branch("gen_weight"     , &outputClass::gen_weight     ) ;
+  outputTree.branch("met_pt"         , &outputClass::met_pt         ) ;
+  outputTree.branch("met_phi"        , &outputClass::met_phi        ) ;
+  outputTree.branch("lepton_pt"      , &outputClass::lepton_pt      ) ;
+  outputTree.branch("lepton_eta"     , &outputClass::lepton_eta     ) ;
+  outputTree.branch("lepton_phi"     , &outputClass::lepton_phi     ) ;
+  outputTree.branch("lepton_relIso"  , &outputClass::lepton_relIso  ) ;
+  outputTree.branch("mT_e"           , &outputClass::mT_e           ) ;
+  outputTree.branch("mT_u"           , &outputClass::mT_u           ) ;
+  outputTree.branch("jets_pt"        , &outputClass::jets_pt        ) ;
+  outputTree.branch("jets_eta"       , &outputClass::jets_eta       ) ;
+  outputTree.branch("jets_phi"       , &outputClass::jets_phi       ) ;
 }
 
 
@@ -237,7 +254,7 @@ WJetFilter::~WJetFilter()
 
 // ------------ method called on each new Event  ------------
 bool
-WJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
+WJetFilter::filter(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
 {
   // eventPassed is set to false if an event fails selection,
   // but should still be taken to end of loop (e.g. for tree filling)
@@ -245,6 +262,7 @@ WJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
   bool eventPassed = true;
 
   using namespace edm;
+  outputClass output = { -1, -1, -1, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, vector<double>(), vector<double>(), vector<double>() };
   output.run           = iEvent.id().run();
   output.event         = iEvent.id().event();
   output.lumi          = iEvent.id().luminosityBlock();
@@ -261,18 +279,16 @@ WJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
   output.jets_eta.clear();
   output.jets_phi.clear();
 
-  histoMap1D_["eventCountPreFilter"]->Fill(1.);
+  histos_.fill(hist_eventCountPreFilter_, 1.);
 
-  edm::Handle< pat::MuonCollection > muonCollection;
-  iEvent.getByToken(muonCollectionToken_, muonCollection);
-  edm::Handle< pat::ElectronCollection > electronCollection;
-  iEvent.getByToken(electronCollectionToken_, electronCollection);
+  const emjet::PreselectedLeptons electrons = electronTokens_.get(iEvent);
+  const emjet::PreselectedLeptons muons = muonTokens_.get(iEvent);
   edm::Handle< pat::JetCollection > jetCollection;
   iEvent.getByToken(jetCollectionToken_, jetCollection);
   edm::Handle< pat::METCollection > metCollection;
   iEvent.getByToken(metCollectionToken_, metCollection);
   auto met = (metCollection->at(0));
-  histoMap1D_["pt_met"]->Fill(met.pt());
+  histos_.fill(hist_pt_met_, met.pt());
   if ( met.pt() < minPtMET_ ) return false;
   output.met_pt = met.pt();
   output.met_phi = met.phi();
@@ -281,74 +297,69 @@ WJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
   // Calculate mT with electrons/muons
   ////////////////////////////////////////////////////////////
 
-  // Construct zP4 from electrons
-  pat::ElectronCollection goodElectrons;
+  // Select good leptons among preselected leptons (indices into electrons_/muons_)
+  vector<unsigned> goodElectrons;
   int nGoodLepton = 0;
   {
-    pat::ElectronCollection& goodLeptons = goodElectrons;
-    // Select good leptons
-    auto leptons = electronCollection.product();
+    const emjet::PreselectedLeptons& leptons = electrons;
+    vector<unsigned>& goodLeptons = goodElectrons;
     // Lepton-specific criteria
-    for ( auto it = leptons->begin(); it != leptons->end(); it++ ) {
-      auto lepton = *it;
-      if ( lepton.pt() < minPtElectron_ ) continue;
-      if ( abs(lepton.eta()) > 2.5 ) continue;
-      if ( lepton.electronID(electronID_) < 1 ) continue;
-      double relIso = (lepton.trackIso() + lepton.caloIso()) / lepton.pt();
-      output.lepton_relIso = relIso;
+    for ( unsigned i = 0; i < leptons.size(); i++ ) {
+      if ( leptons.p4(i).pt() < minPtElectron_ ) continue;
+      if ( !leptons.passID(i, electronIDBit_) ) continue;
+      output.lepton_relIso = leptons.relIso(i);
       nGoodLepton++;
-      goodLeptons.push_back(lepton);
+      goodLeptons.push_back(i);
     }
 
     if ( goodLeptons.size() == 1 ) {
-      float dPhi = TMath::Abs( ROOT::Math::VectorUtil::DeltaPhi( met.p4(), goodLeptons[0].p4() ) );
-      double mT = TMath::Sqrt( 2. * goodLeptons[0].pt() * met.pt() * ( 1 - TMath::Cos(dPhi) ) );
+      const auto& p4 = leptons.p4(goodLeptons[0]);
+      float dPhi = TMath::Abs( ROOT::Math::VectorUtil::DeltaPhi( met.p4(), p4 ) );
+      double mT = TMath::Sqrt( 2. * p4.pt() * met.pt() * ( 1 - TMath::Cos(dPhi) ) );
       LogTrace("WJetFilter") << "mT_e: " << mT;
-      histoMap1D_["mT_e"]->Fill(mT);
+      histos_.fill(hist_mT_e_, mT);
       output.mT_e = mT;
-      output.lepton_pt  = goodLeptons[0].pt();
-      output.lepton_eta = goodLeptons[0].eta();
-      output.lepton_phi = goodLeptons[0].phi();
+      output.lepton_pt  = p4.pt();
+      output.lepton_eta = p4.eta();
+      output.lepton_phi = p4.phi();
     }
   }
 
-  pat::MuonCollection goodMuons;
+  vector<unsigned> goodMuons;
   {
-    pat::MuonCollection& goodLeptons = goodMuons;
-    // Select good leptons
-    auto leptons = muonCollection.product();
+    const emjet::PreselectedLeptons& leptons = muons;
+    vector<unsigned>& goodLeptons = goodMuons;
     // Lepton-specific criteria
-    for ( auto it = leptons->begin(); it != leptons->end(); it++ ) {
-      auto lepton = *it;
-      if ( lepton.pt() < minPtElectron_ ) continue;
-      if ( abs(lepton.eta()) > 2.5 ) continue;
-      if ( !lepton.muonID("AllGlobalMuons") ) continue;
-      double relIso = (lepton.trackIso() + lepton.caloIso()) / lepton.pt();
+    for ( unsigned i = 0; i < leptons.size(); i++ ) {
+      if ( leptons.p4(i).pt() < minPtMuon_ ) continue;
+      if ( !leptons.passID(i, muonIDBit_) ) continue;
+      double relIso = leptons.relIso(i);
       output.lepton_relIso = relIso;
       if ( relIso > 0.2 ) continue;
       nGoodLepton++;
-      goodLeptons.push_back(lepton);
+      goodLeptons.push_back(i);
     }
 
     if ( goodLeptons.size() == 1 ) {
-      float dPhi = TMath::Abs( ROOT::Math::VectorUtil::DeltaPhi( met.p4(), goodLeptons[0].p4() ) );
-      double mT = TMath::Sqrt( 2. * goodLeptons[0].pt() * met.pt() * ( 1 - TMath::Cos(dPhi) ) );
+      const auto& p4 = leptons.p4(goodLeptons[0]);
+      float dPhi = TMath::Abs( ROOT::Math::VectorUtil::DeltaPhi( met.p4(), p4 ) );
+      double mT = TMath::Sqrt( 2. * p4.pt() * met.pt() * ( 1 - TMath::Cos(dPhi) ) );
       LogTrace("WJetFilter") << "mT_mu " << mT;
-      histoMap1D_["mT_mu"]->Fill(mT);
+      histos_.fill(hist_mT_mu_, mT);
       output.mT_u = mT;
-      output.lepton_pt  = goodLeptons[0].pt();
-      output.lepton_eta = goodLeptons[0].eta();
-      output.lepton_phi = goodLeptons[0].phi();
+      output.lepton_pt  = p4.pt();
+      output.lepton_eta = p4.eta();
+      output.lepton_phi = p4.phi();
     }
   }
 
   // Get good lepton P4
   // LogTrace("WJetFilter") << "nGoodLepton " << nGoodLepton;
-  histoMap1D_["nGoodLepton"]->Fill(nGoodLepton);
+  histos_.fill(hist_nGoodLepton_, nGoodLepton);
   if ( nGoodLepton != 1 ) return false;
   RecoLorentzVector goodLeptonP4; 
-  if ( goodMuons.size()==1 ) goodLeptonP4 = goodMuons[0].p4();
-  else                       goodLeptonP4 = goodElectrons[0].p4();
+  if ( goodMuons.size()==1 ) goodLeptonP4 = muons.p4(goodMuons[0]);
+  else                       goodLeptonP4 = electrons.p4(goodElectrons[0]);
 
   // Require mT to pass selection cuts, but don't return until output has been filled
   assert ( goodMuons.size()+goodElectrons.size()==1 );
@@ -373,8 +384,8 @@ WJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
       if ( const reco::PFJet* pfJet = dynamic_cast<const reco::PFJet*>(recoJet) ) {
         selectedJet.push_back( *pfJet );
         nJetSelected++;
-        histoMap1D_["pt_selectedJet"]->Fill( pfJet->pt() );
-        histoMap2D_["pt_jetIndex"]->Fill( pfJet->pt(), jetIndex );
+        histos_.fill(hist_pt_selectedJet_, pfJet->pt());
+        histos_.fill(hist_pt_jetIndex_, pfJet->pt(), jetIndex);
         // Store jet info in Tree for first four selected jets
         if ( nJetSelected <= 4 ) {
           LogTrace("WJetFilter") << "jet_pt: " << jet->pt();
@@ -389,22 +400,22 @@ WJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
   }
   
   LogTrace("WJetFilter") << "nJetSelected " << nJetSelected;
-  histoMap1D_["nSelectedJet"]->Fill(selectedJet.size());
+  histos_.fill(hist_nSelectedJet_, selectedJet.size());
 
-  outputTree->Fill();
+  outputTree.fill(output);
 
   if ( selectedJet.size() == 0 ) return false;
   // if ( selectedJet.size() != 1 ) return false;
   auto jet = selectedJet[0];
   float dPhi_jet_met = ROOT::Math::VectorUtil::DeltaPhi( met.p4(), jet.p4() );
-  histoMap1D_["dPhi_jet_met"]->Fill(dPhi_jet_met);
+  histos_.fill(hist_dPhi_jet_met_, dPhi_jet_met);
   auto wp4 = goodLeptonP4 + met.p4();
   float dPhi_jet_lepton = ROOT::Math::VectorUtil::DeltaPhi( goodLeptonP4, jet.p4() );
-  histoMap1D_["dPhi_jet_lepton"]->Fill(dPhi_jet_lepton);
+  histos_.fill(hist_dPhi_jet_lepton_, dPhi_jet_lepton);
   float dPhi_jet_w = ROOT::Math::VectorUtil::DeltaPhi( wp4, jet.p4() );
-  histoMap1D_["dPhi_jet_w"]->Fill(dPhi_jet_w);
+  histos_.fill(hist_dPhi_jet_w_, dPhi_jet_w);
 
-  histoMap1D_["eventCountPostFilter"]->Fill(1.);
+  histos_.fill(hist_eventCountPostFilter_, 1.);
 
     // float dPhi = ROOT::Math::VectorUtil::DeltaPhi( met.p4(), jet.p4() );
     // const reco::Candidate* recoJet = jet->originalObject();
@@ -434,8 +445,8 @@ WJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
 
   // LogTrace("WJetFilter") << "eventPassed: " << eventPassed;
 
-  std::auto_ptr< reco::PFJetCollection > _selectedJet( new reco::PFJetCollection (selectedJet) );
-  iEvent.put(_selectedJet);
+  std::unique_ptr< reco::PFJetCollection > _selectedJet( new reco::PFJetCollection (selectedJet) );
+  iEvent.put(std::move(_selectedJet));
   // std::auto_ptr< vector<double> > _deltaRs( new vector<double> (deltaRs) );
   // iEvent.put(_deltaRs, "deltaR");
   // std::auto_ptr< vector<double> > _deltaPhis( new vector<double> (deltaPhis) );
@@ -455,6 +466,7 @@ WJetFilter::beginJob()
 // ------------ method called once each job just after ending the event loop  ------------
 void 
 WJetFilter::endJob() {
+  histos_.merge();
 }
 
 // ------------ method called when starting to processes a run  ------------
@@ -492,11 +504,24 @@ WJetFilter::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup cons
 // ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
 void
 WJetFilter::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
-  //The following says we do not know what parameters are allowed so do no validation
-  // Please change this to state exactly what you do use, even if it is no parameters
+  // Defaults as in wJetFilter_cff.py
   edm::ParameterSetDescription desc;
-  desc.setUnknown();
-  descriptions.addDefault(desc);
+  desc.add<bool>("isData", false);
+  desc.add<edm::InputTag>("srcLeptons", edm::InputTag("leptonPreselector"));
+  desc.add<edm::InputTag>("srcJets", edm::InputTag("slimmedJets"));
+  desc.add<edm::InputTag>("srcMET", edm::InputTag("slimmedMETs"));
+  desc.add<double>("minPtMuon", 20.0);
+  desc.add<double>("minPtElectron", 20.0);
+  desc.add<double>("minPtMET", 20.0);
+  desc.add<double>("minMt", 50.0);
+  desc.add<double>("maxMt", 100.0);
+  desc.add<double>("minDeltaR", 0.4);
+  desc.add<double>("maxDeltaPhi", 0.4); // Unused
+  desc.add<double>("minPtSelectedJet", 20.0);
+  desc.add<double>("maxPtAdditionalJets", 20.0); // Unused
+  desc.add<unsigned>("electronIDBit", 0)->setComment("Index of electron ID in LeptonPreselector electronIDs");
+  desc.add<unsigned>("muonIDBit", 0)->setComment("Index of muon ID in LeptonPreselector muonIDs");
+  descriptions.add("wJetFilter", desc);
 }
 //define this as a plug-in
 DEFINE_FWK_MODULE(WJetFilter);
@@ -2,8 +2,7 @@ import FWCore.ParameterSet.Config as cms
 
 process.wJetFilter = cms.EDFilter("WJetFilter",
     isData = cms.bool( False ),
-    srcMuons = cms.InputTag("slimmedMuons"),
-    srcElectrons = cms.InputTag("slimmedElectrons"),
+    srcLeptons = cms.InputTag("leptonPreselector"),
     srcJets = cms.InputTag("slimmedJets"),
     srcMET = cms.InputTag("slimmedMETs"),
     minPtMuon = cms.double(20.0),
@@ -15,6 +14,6 @@ process.wJetFilter = cms.EDFilter("WJetFilter",
     maxDeltaPhi = cms.double(0.4), # Doesn't do anything
     minPtSelectedJet = cms.double(20.0),
     maxPtAdditionalJets = cms.double(20.0), # Doesn't do anything
-    electronID = cms.string('cutBasedElectronID-Spring15-25ns-V1-standalone-loose'),
-    # electronID = cms.string('cutBasedElectronID-CSA14-50ns-V1-standalone-medium'),
+    electronIDBit = cms.uint32(0), # Index in leptonPreselector.electronIDs
+    muonIDBit = cms.uint32(0), # Index in leptonPreselector.muonIDs
 )
@@ -141,17 +141,24 @@ else:
 ############################################################
 # Private modules
 ############################################################
+from EmergingJetAnalysis.LeptonPreselector.leptonPreselector_cff import leptonPreselector
+process.leptonPreselector = leptonPreselector.clone()
 process.wJetFilter = cms.EDFilter("WJetFilter",
-    srcMuons = cms.InputTag("slimmedMuons"),
-    srcElectrons = cms.InputTag("slimmedElectrons"),
+    isData = cms.bool( False ),
+    srcLeptons = cms.InputTag("leptonPreselector"),
     srcJets = cms.InputTag("slimmedJets"),
     srcMET = cms.InputTag("slimmedMETs"),
     minPtMuon = cms.double(20.0),
     minPtElectron = cms.double(20.0),
     minPtMET = cms.double(20.0),
-    maxDeltaPhi = cms.double(0.4),
+    minMt = cms.double(50.0),
+    maxMt = cms.double(100.0),
+    minDeltaR = cms.double(0.4),
+    maxDeltaPhi = cms.double(0.4), # Doesn't do anything
     minPtSelectedJet = cms.double(50.0),
-    maxPtAdditionalJets = cms.double(50.0),
+    maxPtAdditionalJets = cms.double(50.0), # Doesn't do anything
+    electronIDBit = cms.uint32(0), # Index in leptonPreselector.electronIDs
+    muonIDBit = cms.uint32(0), # Index in leptonPreselector.muonIDs
 )
 # process.jetFilter = cms.EDFilter("JetFilter",
 #     srcJets = cms.InputTag("ak4PFJetsCHS"),
@@ -206,7 +213,7 @@ process.TFileService = cms.Service("TFileService",
 #     printVertex = cms.untracked.bool(False)
 #   )
 #
-process.p = cms.Path( process.wJetFilter )
+process.p = cms.Path( process.leptonPreselector * process.wJetFilter )
 
 
 
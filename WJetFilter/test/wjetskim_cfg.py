@@ -66,11 +66,20 @@ options.register ('data',
                   VarParsing.VarParsing.varType.int,          # string, int, or float
                   "Set to 1 for data.")
 options.data = 0
+options.register ('nThreads',
+                  1, # default value
+                  VarParsing.VarParsing.multiplicity.singleton, # singleton or list
+                  VarParsing.VarParsing.varType.int,          # string, int, or float
+                  "Number of threads (and streams) for cmsRun.")
 
 
 # get and parse the command line arguments
 options.parseArguments()
 
+# Skim filters are edm::global modules and do not serialize the job
+process.options.numberOfThreads = cms.untracked.uint32(options.nThreads)
+process.options.numberOfStreams = cms.untracked.uint32(0) # 0: same as numberOfThreads
+
 
 # Unscheduled mode
 # process.options.allowUnscheduled = cms.untracked.bool(False)
@@ -174,10 +183,19 @@ process.triggerSelection = cms.EDFilter( "TriggerResultsFilter",
 )
 
 
+from EmergingJetAnalysis.LeptonPreselector.leptonPreselector_cff import leptonPreselector
+process.leptonPreselector = leptonPreselector.clone(
+    # electronIDs = cms.vstring('cutBasedElectronID-Spring15-25ns-V1-standalone-loose'),
+    electronIDs = cms.vstring('cutBasedElectronID-CSA14-50ns-V1-standalone-medium'),
+)
+if 'CMSSW_7_4_12' in cmssw_version:
+    process.leptonPreselector.electronIDs = cms.vstring('cutBasedElectronID-Spring15-25ns-V1-standalone-medium')
+elif 'CMSSW_7_4_1_patch4' in cmssw_version:
+    process.leptonPreselector.electronIDs = cms.vstring('cutBasedElectronID-CSA14-50ns-V1-standalone-medium')
+
 process.wJetFilter = cms.EDFilter("WJetFilter",
     isData = cms.bool( False ),
-    srcMuons = cms.InputTag("slimmedMuons"),
-    srcElectrons = cms.InputTag("slimmedElectrons"),
+    srcLeptons = cms.InputTag("leptonPreselector"),
     srcJets = cms.InputTag("slimmedJets"),
     srcMET = cms.InputTag("slimmedMETs"),
     minPtMuon = cms.double(20.0),
@@ -189,14 +207,10 @@ process.wJetFilter = cms.EDFilter("WJetFilter",
     maxDeltaPhi = cms.double(0.4), # Doesn't do anything
     minPtSelectedJet = cms.double(20.0),
     maxPtAdditionalJets = cms.double(20.0), # Doesn't do anything
-    # electronID = cms.string('cutBasedElectronID-Spring15-25ns-V1-standalone-loose'),
-    electronID = cms.string('cutBasedElectronID-CSA14-50ns-V1-standalone-medium'),
+    electronIDBit = cms.uint32(0), # Index in leptonPreselector.electronIDs
+    muonIDBit = cms.uint32(0), # Index in leptonPreselector.muonIDs
 )
 if options.data: process.wJetFilter.isData = cms.bool( True )
-if 'CMSSW_7_4_12' in cmssw_version:
-    process.wJetFilter.electronID = cms.string('cutBasedElectronID-Spring15-25ns-V1-standalone-medium')
-elif 'CMSSW_7_4_1_patch4' in cmssw_version:
-    process.wJetFilter.electronID = cms.string('cutBasedElectronID-CSA14-50ns-V1-standalone-medium')
 
 process.genJetFilter = cms.EDFilter("GenJetFilter",
     srcJets = cms.InputTag("ak4GenJets"),
@@ -264,6 +278,7 @@ process.p = cms.Path(
     process.eventCountPreFilter*
     process.triggerSelection*
     process.genJetFilter*
+    process.leptonPreselector*
     process.wJetFilter*
     process.eventCountPostFilter
     # process.emergingJetAnalyzer
@@ -273,6 +288,7 @@ if options.data:
     process.p = cms.Path(
         process.eventCountPreFilter*
         process.triggerSelection*
+        process.leptonPreselector*
         process.wJetFilter*
         process.eventCountPostFilter
     )
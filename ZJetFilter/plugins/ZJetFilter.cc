@@ -26,7 +26,7 @@ Saves selected hard jet.
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
-#include "FWCore/Framework/interface/EDFilter.h"
+#include "FWCore/Framework/interface/global/EDFilter.h"
 
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
@@ -34,7 +34,6 @@ Saves selected hard jet.
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
 #include <TVector3.h>
-#include <Math/VectorUtil.h>
 
 // For creating/writing histograms
 #include "FWCore/ServiceRegistry/interface/Service.h"
@@ -50,6 +49,10 @@ Saves selected hard jet.
 
 // #include "DataFormats/JetReco/interface/PFJetCollection.h"
 
+#include "EmergingJetAnalysis/LeptonPreselector/interface/PreselectedLeptons.h"
+#include "EmergingJetAnalysis/Utils/interface/TreeCollector.h"
+#include "EmergingJetAnalysis/Utils/interface/Kinematics.h"
+
 // Namespace shorthands
 using std::string;
 using std::vector;
@@ -58,7 +61,7 @@ using std::vector;
 // class declaration
 //
 
-class ZJetFilter : public edm::EDFilter {
+class ZJetFilter : public edm::global::EDFilter<> {
   public:
     explicit ZJetFilter(const edm::ParameterSet&);
     ~ZJetFilter();
@@ -67,7 +70,7 @@ class ZJetFilter : public edm::EDFilter {
 
   private:
     virtual void beginJob() override;
-    virtual bool filter(edm::Event&, const edm::EventSetup&) override;
+    virtual bool filter(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
     virtual void endJob() override;
 
     //virtual void beginRun(edm::Run const&, edm::EventSetup const&) override;
@@ -80,8 +83,8 @@ class ZJetFilter : public edm::EDFilter {
     // Retrieve once 
     string alias_; // Alias suffix for all products
     // Retrieve once per event
-    edm::EDGetTokenT< pat::MuonCollection > muonCollectionToken_;
-    edm::EDGetTokenT< pat::ElectronCollection > electronCollectionToken_;
+    emjet::PreselectedLeptonTokens electronTokens_; // From LeptonPreselector
+    emjet::PreselectedLeptonTokens muonTokens_;
     edm::EDGetTokenT< pat::JetCollection > jetCollectionToken_;
     double minPtMuon_;
     double minPtElectron_;
@@ -90,9 +93,10 @@ class ZJetFilter : public edm::EDFilter {
     double maxDeltaPhi_;
     double minPtSelectedJet_;
     double maxPtAdditionalJets_;
+    unsigned electronIDBit_; // Index of electron ID in LeptonPreselector electronIDs
+    unsigned muonIDBit_;     // Index of muon ID in LeptonPreselector muonIDs
 
     // Outputs
-    TTree* outputTree;
     struct outputClass {
       public:
         double m_ee;
@@ -102,7 +106,7 @@ class ZJetFilter : public edm::EDFilter {
         vector<double> jets_phi;
         vector<double> jets_dPhi_Z;
     };
-    outputClass output;
+    emjet::TreeCollector<outputClass> outputTree;
 };
 
 //
@@ -123,6 +127,8 @@ typedef math::PtEtaPhiMLorentzVector PolarLorentzVector;
 // constructors and destructor
 //
 ZJetFilter::ZJetFilter(const edm::ParameterSet& iConfig) :
+    electronTokens_      (  iConfig.getParameter<edm::InputTag>("srcLeptons"), "electron", consumesCollector() ),
+    muonTokens_          (  iConfig.getParameter<edm::InputTag>("srcLeptons"), "muon"    , consumesCollector() ),
     minPtMuon_           (  iConfig.getParameter<double>("minPtMuon") ),
     minPtElectron_       (  iConfig.getParameter<double>("minPtElectron") ),
     minZMass_            (  iConfig.getParameter<double>("minZMass") ),
@@ -130,14 +136,13 @@ ZJetFilter::ZJetFilter(const edm::ParameterSet& iConfig) :
     maxDeltaPhi_         (  iConfig.getParameter<double>("maxDeltaPhi") ),
     minPtSelectedJet_    (  iConfig.getParameter<double>("minPtSelectedJet") ),
     maxPtAdditionalJets_ (  iConfig.getParameter<double>("maxPtAdditionalJets") ),
-    output( {0.0, 0.0, std::vector<double>(), std::vector<double>(), std::vector<double>(), std::vector<double>() } )
+    electronIDBit_       (  iConfig.getParameter<unsigned>("electronIDBit") ),
+    muonIDBit_           (  iConfig.getParameter<unsigned>("muonIDBit") )
 {
   //now do what ever initialization is needed
 
   alias_ = iConfig.getParameter<string>("@module_label");
 
-  muonCollectionToken_ = consumes< pat::MuonCollection > (iConfig.getParameter<edm::InputTag>("srcMuons"));
-  electronCollectionToken_ = consumes< pat::ElectronCollection > (iConfig.getParameter<edm::InputTag>("srcElectrons"));
   jetCollectionToken_ = consumes< pat::JetCollection > (iConfig.getParameter<edm::InputTag>("srcJets"));
 
   //Register products
@@ -149,14 +154,13 @@ ZJetFilter::ZJetFilter(const edm::ParameterSet& iConfig) :
   // produces< vector<double> > ("deltaPhi")  . setBranchAlias( string("deltaPhi_").append(alias_) );
   // produces< bool > ("eventPassed")  . setBranchAlias( string("eventPassed_").append(alias_) );
 
-  edm::Service<TFileService> fs;
-  outputTree = fs->make<TTree>("ZJetFilterTree", "ZJetFilterTree");
-  outputTree->Branch("m_ee"        , &output.m_ee        ) ;
-  outputTree->Branch("m_uu"        , &output.m_uu        ) ;
-  outputTree->Branch("jets_pt"     , &output.jets_pt     ) ;
-  outputTree->Branch("jets_eta"    , &output.jets_eta    ) ;
-  outputTree->Branch("jets_phi"    , &output.jets_phi    ) ;
-  outputTree->Branch("jets_dPhi_Z" , &output.jets_dPhi_Z ) ;
+  outputTree.book("ZJetFilterTree", "ZJetFilterTree");
+  outputTree.branch("m_ee"        , &outputClass::m_ee        ) ;
+  outputTree.branch("m_uu"        , &outputClass::m_uu        ) ;
+  outputTree.branch("jets_pt"     , &outputClass::jets_pt     ) ;
+  outputTree.branch("jets_eta"    , &outputClass::jets_eta    ) ;
+  outputTree.branch("jets_phi"    , &outputClass::jets_phi    ) ;
+  outputTree.branch("jets_dPhi_Z" , &outputClass::jets_dPhi_Z ) ;
 }
 
 
@@ -175,14 +179,13 @@ ZJetFilter::~ZJetFilter()
 
 // ------------ method called on each new Event  ------------
   bool
-ZJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
+ZJetFilter::filter(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
 {
   using namespace edm;
+  outputClass output = {0.0, 0.0, std::vector<double>(), std::vector<double>(), std::vector<double>(), std::vector<double>() };
 
-  edm::Handle< pat::MuonCollection > muonCollection;
-  iEvent.getByToken(muonCollectionToken_, muonCollection);
-  edm::Handle< pat::ElectronCollection > electronCollection;
-  iEvent.getByToken(electronCollectionToken_, electronCollection);
+  const emjet::PreselectedLeptons electrons = electronTokens_.get(iEvent);
+  const emjet::PreselectedLeptons muons = muonTokens_.get(iEvent);
   edm::Handle< pat::JetCollection > jetCollection;
   iEvent.getByToken(jetCollectionToken_, jetCollection);
 
@@ -198,23 +201,21 @@ ZJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
     // Select good leptons
     bool& zValidity = zValidity_ee;
     auto& m_ll = output.m_ee;
-    auto leptons = electronCollection.product();
+    const emjet::PreselectedLeptons& leptons = electrons;
     int nGoodLepton = 0;
-    pat::ElectronCollection goodLeptons;
+    vector<unsigned> goodLeptons;
     // Lepton-specific criteria
-    for ( auto it = leptons->begin(); it != leptons->end(); it++ ) {
-      auto lepton = *it;
-      if ( lepton.pt() < minPtElectron_ ) continue;
-      if ( abs(lepton.eta()) > 2.5 ) continue;
-      if ( lepton.electronID("cutBasedElectronID-CSA14-PU20bx25-V0-standalone-medium") < 1 ) continue;
+    for ( unsigned i = 0; i < leptons.size(); i++ ) {
+      if ( leptons.p4(i).pt() < minPtElectron_ ) continue;
+      if ( !leptons.passID(i, electronIDBit_) ) continue;
       nGoodLepton++;
-      goodLeptons.push_back(lepton);
+      goodLeptons.push_back(i);
     }
 
     if ( goodLeptons.size() >= 2 ) {
       // Assuming collection is sorted by pt
       RecoLorentzVector zP4_;
-      zP4_ = goodLeptons[0].p4() + goodLeptons[1].p4();
+      zP4_ = RecoLorentzVector(leptons.p4(goodLeptons[0])) + RecoLorentzVector(leptons.p4(goodLeptons[1]));
       LogTrace("ZJetFilter") << "Printing Z mass: " << zP4_.mass();
       m_ll = zP4_.mass();
       if ( minZMass_ < zP4_.mass() && zP4_.mass() < maxZMass_ ) {
@@ -228,23 +229,21 @@ ZJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
     // Select good leptons
     bool& zValidity = zValidity_uu;
     auto& m_ll = output.m_uu;
-    auto leptons = muonCollection.product();
+    const emjet::PreselectedLeptons& leptons = muons;
     int nGoodLepton = 0;
-    pat::MuonCollection goodLeptons;
+    vector<unsigned> goodLeptons;
     // Lepton-specific criteria
-    for ( auto it = leptons->begin(); it != leptons->end(); it++ ) {
-      auto lepton = *it;
-      if ( lepton.pt() < minPtElectron_ ) continue;
-      if ( abs(lepton.eta()) > 2.5 ) continue;
-      if ( !lepton.muonID("AllGlobalMuons") ) continue;
+    for ( unsigned i = 0; i < leptons.size(); i++ ) {
+      if ( leptons.p4(i).pt() < minPtElectron_ ) continue;
+      if ( !leptons.passID(i, muonIDBit_) ) continue;
       nGoodLepton++;
-      goodLeptons.push_back(lepton);
+      goodLeptons.push_back(i);
     }
 
     if ( goodLeptons.size() >= 2 ) {
       // Assuming collection is sorted by pt
       RecoLorentzVector zP4_;
-      zP4_ = goodLeptons[0].p4() + goodLeptons[1].p4();
+      zP4_ = RecoLorentzVector(leptons.p4(goodLeptons[0])) + RecoLorentzVector(leptons.p4(goodLeptons[1]));
       LogTrace("ZJetFilter") << "Printing Z mass: " << zP4_.mass();
       m_ll = zP4_.mass();
       if ( minZMass_ < zP4_.mass() && zP4_.mass() < maxZMass_ ) {
@@ -278,10 +277,12 @@ ZJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
     auto jets = jetCollection.product();
     pat::JetCollection::const_iterator jetSelected = jets->end();
     // Loop over jets to find first jet that is within dR cut of -zP4
+    // Direction of -zP4 is computed once, jet eta/phi are cached by pat::Jet
+    auto zOpposite = emjet::kin::EtaPhi::fromPtEtaPhi(zP4.pt(), zP4.eta(), zP4.phi()).opposite();
     int iJet = 0;
     for ( auto jet = jets->begin(); jet!= jets->end(); jet++ ) {
-      float dR = ROOT::Math::VectorUtil::DeltaR( jet->p4(), - zP4 );
-      float dPhi = ROOT::Math::VectorUtil::DeltaPhi( jet->p4(), -zP4 );
+      float dR = emjet::kin::deltaR( jet->eta(), jet->phi(), zOpposite.eta, zOpposite.phi );
+      float dPhi = emjet::kin::deltaPhi( zOpposite.phi, jet->phi() ); // Same sign as ROOT::Math::VectorUtil::DeltaPhi( jet->p4(), -zP4 )
       // std::cout << "dR: " << dR << " \n";
       // std::cout << "jet->pt(): " << jet->pt() << " \n";
       // std::cout << iJet << "\t" << dR << " \t" << jet->pt() << " \n";
@@ -317,7 +318,7 @@ ZJetFilter::filter(edm::Event& iEvent, const edm::EventSetup& iSetup)
   // std::auto_ptr< bool > _eventPassed( new bool (eventPassed) );
   // iEvent.put(_eventPassed, "eventPassed");
 
-  outputTree->Fill();
+  outputTree.fill(output);
   return eventPassed;
 }
 
@@ -134,9 +134,12 @@ else:
 ############################################################
 # Private modules
 ############################################################
+from EmergingJetAnalysis.LeptonPreselector.leptonPreselector_cff import leptonPreselector
+process.leptonPreselector = leptonPreselector.clone(
+    electronIDs = cms.vstring('cutBasedElectronID-CSA14-PU20bx25-V0-standalone-medium'),
+)
 process.zJetFilter = cms.EDFilter("ZJetFilter",
-    srcMuons = cms.InputTag("slimmedMuons"),
-    srcElectrons = cms.InputTag("slimmedElectrons"),
+    srcLeptons = cms.InputTag("leptonPreselector"),
     srcJets = cms.InputTag("slimmedJets"),
     minPtMuon = cms.double(20.0),
     minPtElectron = cms.double(30.0),
@@ -145,6 +148,8 @@ process.zJetFilter = cms.EDFilter("ZJetFilter",
     maxDeltaPhi = cms.double(0.4),
     minPtSelectedJet = cms.double(50.0),
     maxPtAdditionalJets = cms.double(50.0),
+    electronIDBit = cms.uint32(0), # Index in leptonPreselector.electronIDs
+    muonIDBit = cms.uint32(0), # Index in leptonPreselector.muonIDs
 )
 # process.jetFilter = cms.EDFilter("JetFilter",
 #     srcJets = cms.InputTag("ak4PFJetsCHS"),
@@ -199,7 +204,7 @@ process.TFileService = cms.Service("TFileService",
 #     printVertex = cms.untracked.bool(False)
 #   )
 #
-process.p = cms.Path( process.zJetFilter )
+process.p = cms.Path( process.leptonPreselector * process.zJetFilter )
 
 
 
@@ -4,7 +4,7 @@ STARTINGDIR=${PWD}
 echo $STARTINGDIR
 # cd cogFiles
 export PYTHONPATH=${PWD}/cogFiles
-declare -a FILES_TO_COG=("EmergingJetAnalyzer/plugins/EmergingJetAnalyzer.cc" "EmergingJetAnalyzer/interface/OutputTree.h" "EmJetAnalyzer/interface/OutputTree.h" "EmJetAnalyzer/interface/EmJetEvent.h")
+declare -a FILES_TO_COG=("EmergingJetAnalyzer/plugins/EmergingJetAnalyzer.cc" "EmergingJetAnalyzer/interface/OutputTree.h" "EmJetAnalyzer/interface/OutputTree.h" "EmJetAnalyzer/interface/EmJetEvent.h" "EmJetAnalyzer/interface/EmJetColumns.h" "EmJetAnalyzer/interface/EventHistograms.h")
 for file in "${FILES_TO_COG[@]}"
 do
     # echo "Trying to cog file: ${file}"
@@ -21,5 +21,10 @@ done
 # cog.py -r ${STARTINGDIR}/EmergingJetAnalyzer/interface/OutputTree.h
 # echo "WARNING: Replacing EmergingJetAnalyzer/plugins/EmergingJetAnalyzer.cc"
 # cog.py -r ${STARTINGDIR}/EmergingJetAnalyzer/plugins/EmergingJetAnalyzer.cc
-USER_CXXFLAGS="-Wno-error=unused-variable -Wno-error=unused-but-set-variable -DEDM_ML_DEBUG -g" scram b -v -j8
+USER_CXXFLAGS="-Wno-error=unused-variable -Wno-error=unused-but-set-variable -DEDM_ML_DEBUG -g" scram b -v -j8 || exit 1
 cd $STARTINGDIR
+# Optional output/throughput regression check on a pinned sample, fails the build on divergence
+# e.g. EMJET_REGRESSION_INPUT=sample.bin EMJET_REGRESSION_REFERENCE=regression-ref ./buildAll.sh
+if [ -n "${EMJET_REGRESSION_REFERENCE}" ]; then
+    emjetRegression.py --mode ${EMJET_REGRESSION_MODE:-replay} --input ${EMJET_REGRESSION_INPUT} --reference ${EMJET_REGRESSION_REFERENCE} || exit 1
+fi
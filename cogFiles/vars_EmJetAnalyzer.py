@@ -65,6 +65,8 @@ event_vars = [
     Var("HLT_HT350"           , "bool"  , 0 , ) , #HT350_DisplacedDijet40_DisplacedTrack
     Var("HLT_HT400"           , "bool"  , 0 , ) , #HT400_DisplacedDijet40_Inclusive
     Var("HLT_HT500"           , "bool"  , 0 , ) , #HT500_DisplacedDijet40_Inclusive
+    Var("HLT_bits"            , "int"   , 0 , ) , # Bit i set if i-th entry of hltPaths fired (names stored in tree UserInfo)
+    Var("budgetFlags"         , "int"   , 0 , ) , # Non-zero if event was processed in degraded mode, see EventBudget.h
 
 ]
 jet_vars = [
@@ -270,9 +272,10 @@ def var_to_dict(var):
     return vardict
 
 def make_fullname_builder(prefix="", postfix=""):
-    """Return lambda that adds input['fullname'] = prefix + input['name'] to input dictionary"""
+    """Return lambda that adds input['fullname'] = prefix + input['name'] to input dictionary
+    input['branchname'] is the same without padding"""
     # Hacky way to make a lambda that returns the dictionary after updating it
-    return lambda x : x.update({'fullname': prefix + x['name'] + postfix}) or x
+    return lambda x : x.update({'fullname': prefix + x['name'] + postfix, 'branchname': prefix + x['name'].strip() + postfix}) or x
 
 # Turn list of Var objects, to dictionary objects
 event_vardicts       = map( var_to_dict, event_vars       )
@@ -328,3 +331,42 @@ def gen_Branch():
         varname = vardict['fullname']
         typename = vardict['branchtype']
         outputline("BRANCH(tree, %s);" % varname)
+
+def gen_ColumnIds():
+    """Generate column identifiers for EmJetColumns.h"""
+    # Output <varname>,
+    for vardict in all_vardicts:
+        outputline("%s," % vardict['fullname'])
+
+def gen_ColumnNames():
+    """Generate branch name table for EmJetColumns.h"""
+    # Output "<branchname>",
+    for vardict in all_vardicts:
+        outputline('"%s",' % vardict['branchname'])
+
+def gen_ColumnMembers():
+    """Generate ColumnReader members for EmJetColumns.h"""
+    # Output <typename> <varname>; with vector branches read through pointers
+    for vardict in all_vardicts:
+        typename = vardict['branchtype'].strip()
+        if vardict['level'] > 0: typename += '*'
+        outputline("%s %s;" % (pad(typename, 5+18), vardict['fullname']))
+
+def gen_ColumnInit():
+    """Generate ColumnReader constructor body for EmJetColumns.h"""
+    # Output <varname>= 0;
+    for vardict in all_vardicts:
+        outputline("%s= 0;" % vardict['fullname'])
+
+def gen_ColumnAttach():
+    """Generate ColumnReader::Attach() for EmJetColumns.h"""
+    # Output ATTACH(tree, <varname>);
+    for vardict in all_vardicts:
+        outputline("ATTACH(tree, %s);" % vardict['fullname'])
+
+def gen_ColumnDelete():
+    """Generate ColumnReader destructor body for EmJetColumns.h"""
+    # Output delete <varname>; for vector branches, allocated by ROOT
+    for vardict in all_vardicts:
+        if vardict['level'] > 0:
+            outputline("delete %s;" % vardict['fullname'])
@@ -0,0 +1,225 @@
+#!/usr/bin/env python
+"""Run cmsRun jobs on the local machine instead of CRAB
+
+Splits a list of input files into units (files, or luminosity block ranges of a lumi mask), and runs up to N cmsRun
+workers at a time. Each free worker takes the next unit from a shared queue, so slow files do not hold up the other
+workers. Failed units are put back at the end of the queue and retried. Outputs of all jobs are merged at the end,
+with several merge processes in parallel.
+Works offline: input lists contain local files, file: urls, root:// urls or /store LFNs, one per line. Lines starting
+with '#' are skipped (same convention as dataset_lists). Dataset names (e.g. a line from dataset_lists) are resolved
+with dasgoclient, which needs network access.
+
+Job directories and a status file are kept in the work directory, rerunning the same command resumes the task and
+only reruns units that did not succeed. Each job directory contains the cmsRun log and FrameworkJobReport.xml, which
+splitPlanner.py can use to measure per-dataset throughput.
+
+Usage:
+  localRunner.py files.txt [--pset Configuration/test/test_cfg.py] [-j 8] [--files-per-job 1]
+                           [--lumi-mask golden.json --lumis-per-job 50] [--data] [--sample signal]
+                           [--workdir localTasks/NAME] [--retries 2] [-- steps=analyze ...]
+Arguments after '--' are passed to cmsRun as additional config options.
+"""
+from __future__ import print_function
+import argparse
+import json
+import multiprocessing
+import os
+import subprocess
+import sys
+import time
+from collections import deque
+
+
+def read_list(filename):
+    """Read input files from list, resolving dataset names with dasgoclient"""
+    files = []
+    with open(filename) as ifile:
+        for line in ifile:
+            line = line.strip()
+            if not line or line[0]=='#': continue # Skip comment lines
+            if line.endswith('.root'):
+                files.append(line)
+            else:
+                # Dataset name, e.g. /Primary/Processed/TIER
+                output = subprocess.check_output(['dasgoclient', '-query', 'file dataset=%s' % line])
+                files.extend(f for f in output.decode().split() if f.endswith('.root'))
+    return files
+
+
+def input_url(filename):
+    """cmsRun input file name: LFNs and urls are kept, local paths become file: urls"""
+    if filename.startswith('/store/') or ':' in filename.split('/')[0]: return filename
+    return 'file:' + os.path.abspath(filename)
+
+
+def lumi_ranges(maskfile, lumis_per_job):
+    """Split lumi mask (run: [[first, last], ...]) into lists of run:first-run:last ranges of lumis_per_job lumis"""
+    with open(maskfile) as ifile:
+        mask = json.load(ifile)
+    chunks, chunk, n = [], [], 0
+    for run in sorted(mask, key=int):
+        for first, last in mask[run]:
+            while first <= last:
+                end = min(last, first + lumis_per_job - n - 1)
+                chunk.append('%s:%d-%s:%d' % (run, first, run, end))
+                n += end - first + 1
+                first = end + 1
+                if n == lumis_per_job:
+                    chunks.append(chunk)
+                    chunk, n = [], 0
+    if chunk: chunks.append(chunk)
+    return chunks
+
+
+def make_units(files, args):
+    """Units of work, each with input files and optional lumi ranges"""
+    if args.lumi_mask:
+        # Every unit reads all files, PoolSource skips files without lumis in the unit's ranges using the file index
+        return [{'files': files, 'lumis': lumis} for lumis in lumi_ranges(args.lumi_mask, args.lumis_per_job)]
+    n = args.files_per_job
+    return [{'files': files[i:i+n], 'lumis': []} for i in range(0, len(files), n)]
+
+
+class Runner(object):
+    def __init__(self, units, args):
+        self.units = units
+        self.args = args
+        self.statusFile = os.path.join(args.workdir, 'status.json')
+        self.status = {}
+        if os.path.exists(self.statusFile):
+            with open(self.statusFile) as ifile:
+                self.status = json.load(ifile)
+
+    def jobdir(self, i):
+        return os.path.join(self.args.workdir, 'job%d' % i)
+
+    def save_status(self):
+        tmpname = self.statusFile + '.tmp'
+        with open(tmpname, 'w') as ofile:
+            json.dump(self.status, ofile, indent=1, sort_keys=True)
+        os.rename(tmpname, self.statusFile)
+
+    def start(self, i):
+        unit = self.units[i]
+        jobdir = self.jobdir(i)
+        if not os.path.exists(jobdir): os.makedirs(jobdir)
+        # Job report is the instrumentation used by splitPlanner.py
+        command = ['cmsRun', '-j', 'FrameworkJobReport.xml', os.path.abspath(self.args.pset),
+                   'inputFiles=%s' % ','.join(input_url(f) for f in unit['files']),
+                   'outputLabel=job%d' % i,
+                   'data=%d' % self.args.data,
+                   'sample=%s' % self.args.sample]
+        if unit['lumis']: command.append('lumis=%s' % ','.join(unit['lumis']))
+        command.extend(self.args.cmsRunArgs)
+        log = open(os.path.join(jobdir, 'cmsRun.log'), 'w')
+        log.write(' '.join(command) + '\n')
+        log.flush()
+        return subprocess.Popen(command, cwd=jobdir, stdout=log, stderr=subprocess.STDOUT)
+
+    def run(self):
+        """Run all units that are not done yet, return number of units that failed after all retries"""
+        queue = deque(i for i in range(len(self.units)) if self.status.get(str(i), {}).get('status') != 'done')
+        attempts = dict((i, 0) for i in queue)
+        running = {}
+        ndone, nfailed, ntotal = 0, 0, len(queue)
+        print('localRunner: %d units to run, %d already done, %d workers' % (ntotal, len(self.units) - ntotal, self.args.jobs))
+        while queue or running:
+            # Free workers take the next unit from the queue
+            while queue and len(running) < self.args.jobs:
+                i = queue.popleft()
+                attempts[i] += 1
+                running[i] = (self.start(i), time.time())
+            time.sleep(0.2)
+            for i in list(running):
+                process, start = running[i]
+                if process.poll() is None: continue
+                del running[i]
+                ok = process.returncode == 0
+                self.status[str(i)] = {'status': 'done' if ok else 'failed', 'attempts': attempts[i],
+                                       'exitCode': process.returncode, 'seconds': round(time.time() - start, 1)}
+                if ok:
+                    ndone += 1
+                elif attempts[i] <= self.args.retries:
+                    print('localRunner: job%d failed with exit code %d, retrying' % (i, process.returncode))
+                    queue.append(i)
+                else:
+                    print('localRunner: job%d failed with exit code %d, giving up, see %s' %
+                          (i, process.returncode, os.path.join(self.jobdir(i), 'cmsRun.log')))
+                    nfailed += 1
+                self.save_status()
+                print('localRunner: %d/%d done, %d failed, %d running' % (ndone, ntotal, nfailed, len(running)))
+        return nfailed
+
+
+def merge(outputs, merged, command, jobs, workdir):
+    """Merge outputs into merged, in up to jobs groups in parallel followed by one final merge"""
+    if not outputs: return True
+    ngroups = max(1, min(jobs, len(outputs) // 2))
+    groups = [outputs[k::ngroups] for k in range(ngroups)]
+    if ngroups == 1:
+        return subprocess.call(command(merged, outputs)) == 0
+    parts = [os.path.join(workdir, 'merge%d-%s' % (k, os.path.basename(merged))) for k in range(ngroups)]
+    processes = [subprocess.Popen(command(part, group)) for part, group in zip(parts, groups)]
+    ok = all([p.wait() == 0 for p in processes])
+    ok = ok and subprocess.call(command(merged, parts)) == 0
+    for part in parts:
+        if os.path.exists(part): os.remove(part)
+    return ok
+
+
+def hadd(output, inputs):
+    return ['hadd', '-f', output] + inputs
+
+def edmMerge(output, inputs):
+    return ['edmCopyPickMerge', 'outputFile=%s' % output,
+            'inputFiles=%s' % ','.join('file:' + os.path.abspath(f) for f in inputs)]
+
+
+if __name__ == '__main__':
+    argv = sys.argv[1:]
+    cmsRunArgs = []
+    if '--' in argv:
+        cmsRunArgs = argv[argv.index('--')+1:]
+        argv = argv[:argv.index('--')]
+    parser = argparse.ArgumentParser(description='Run cmsRun jobs on the local machine instead of CRAB')
+    parser.add_argument('lists', nargs='+', help='Input file lists (dataset_lists format)')
+    parser.add_argument('--pset', default='Configuration/test/test_cfg.py', help='cmsRun config')
+    parser.add_argument('-j', '--jobs', type=int, default=multiprocessing.cpu_count(), help='Number of cmsRun workers')
+    parser.add_argument('--files-per-job', type=int, default=1, help='Input files per unit')
+    parser.add_argument('--lumi-mask', default='', help='Split by luminosity block ranges of this JSON lumi mask instead of by files')
+    parser.add_argument('--lumis-per-job', type=int, default=50, help='Luminosity blocks per unit with --lumi-mask')
+    parser.add_argument('--data', type=int, default=0, help='Set to 1 for data')
+    parser.add_argument('--sample', default='signal', help='Sample type, see test_cfg.py')
+    parser.add_argument('--retries', type=int, default=2, help='Number of retries per failed unit')
+    parser.add_argument('--workdir', default='', help='Work directory, default localTasks/<first list name>')
+    parser.add_argument('--no-merge', action='store_true', help='Do not merge job outputs')
+    args = parser.parse_args(argv)
+    args.cmsRunArgs = cmsRunArgs
+    if not args.workdir:
+        args.workdir = os.path.join('localTasks', os.path.splitext(os.path.basename(args.lists[0]))[0])
+    if not os.path.exists(args.workdir): os.makedirs(args.workdir)
+
+    files = []
+    for filename in args.lists: files.extend(read_list(filename))
+    units = make_units(files, args)
+    if not units:
+        print('localRunner: no input files')
+        sys.exit(1)
+    nfailed = Runner(units, args).run()
+    if nfailed:
+        print('localRunner: %d units failed, rerun the same command to retry them' % nfailed)
+        sys.exit(1)
+
+    if not args.no_merge:
+        # Outputs named by test_cfg.py outputLabel option
+        ok = True
+        for pattern, merged, command in [('ntuple-job%d.root', 'ntuple.root', hadd), ('output-job%d.root', 'output.root', edmMerge)]:
+            outputs = [os.path.join(os.path.abspath(args.workdir), 'job%d' % i, pattern % i) for i in range(len(units))]
+            outputs = [f for f in outputs if os.path.exists(f)]
+            merged = os.path.join(args.workdir, merged)
+            if merge(outputs, merged, command, args.jobs, args.workdir):
+                if outputs: print('localRunner: merged %d files into %s' % (len(outputs), merged))
+            else:
+                print('localRunner: merging into %s failed' % merged)
+                ok = False
+        if not ok: sys.exit(1)
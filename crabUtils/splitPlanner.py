@@ -0,0 +1,223 @@
+#!/usr/bin/env python
+"""Plan CRAB job splitting from measured per-dataset throughput
+
+Instead of a fixed unitsPerJob for every dataset, learns seconds and bytes per event of each dataset from the
+FrameworkJobReport.xml of previous jobs (cmsRun -j, written by localRunner.py and by CRAB), and chooses unitsPerJob
+so that every job takes about the same time.
+
+Cost model per dataset, fitted to all measured jobs:
+  seconds(job) = overhead + secondsPerEvent * events
+overhead is the fixed cost per job (startup, conditions, ...), fitted when jobs with different numbers of events
+were measured, otherwise taken from --overhead. Events per job are then
+  (targetSeconds - overhead) / (secondsPerEvent * safety)
+limited so that the output of a job stays below --max-output-mb. MC is split with EventAwareLumiBased (unitsPerJob in
+events), data with LumiBased (unitsPerJob in lumis, using measured events per lumi).
+
+Datasets are read either from the dataset(...) list of a multicrab script, whose isData, priority, label, inputDBS,
+doHLT and doJetFilter are kept in the plan (the script imports wrappers.py, so this needs the CRAB environment), or
+from the alias variables of a datasets_*.py file, which only hold the dataset path: there data has to be marked with
+--data ALIAS, and priority and label are taken from --priority and --label.
+
+Usage:
+  # Record measurements, ALIAS is the variable name of the dataset in datasets_*.py
+  splitPlanner.py measure --dataset ALIAS localTasks/ALIAS [more FrameworkJobReport.xml files or directories]
+  # Print dataset(...) entries for a multicrab script, for every dataset of datasets_*.py with measurements
+  splitPlanner.py plan datasets_AODSIM_2017_09_11re.py --target-hours 8 --priority 99 --label signal
+  splitPlanner.py plan datasets_Data.py --data JetHT_B --data JetHT_C
+  # Same, for the datasets of an existing multicrab script
+  splitPlanner.py plan multicrab_Analysis-20171103-mc.py --target-hours 8
+Measurements are stored in splitCosts.json (--costs).
+"""
+from __future__ import print_function
+import argparse
+import json
+import os
+import runpy
+import sys
+import xml.etree.ElementTree as ET
+
+
+def find_reports(paths):
+    """FrameworkJobReport xml files in paths, directories are searched recursively"""
+    reports = []
+    for path in paths:
+        if os.path.isdir(path):
+            for dirpath, dirnames, filenames in os.walk(path):
+                reports.extend(os.path.join(dirpath, f) for f in sorted(filenames)
+                               if f.startswith('FrameworkJobReport') and f.endswith('.xml'))
+        else:
+            reports.append(path)
+    return reports
+
+
+def parse_report(filename):
+    """Events, lumis, job time and bytes of one job, None for failed or empty jobs"""
+    try:
+        root = ET.parse(filename).getroot()
+    except ET.ParseError:
+        return None # Truncated report of a job that crashed
+    if root.find('FrameworkError') is not None: return None
+    events, lumis = 0, 0
+    for inputFile in root.findall('InputFile'):
+        events += int(inputFile.findtext('EventsRead', '0'))
+        lumis += len(inputFile.findall('Runs/Run/LumiSection'))
+    metrics = {}
+    for summary in root.findall('PerformanceReport/PerformanceSummary'):
+        for metric in summary.findall('Metric'):
+            metrics[metric.get('Name')] = metric.get('Value')
+    if events == 0 or 'TotalJobTime' not in metrics: return None
+    # Output size from the files, if still present next to the report
+    directory = os.path.dirname(os.path.abspath(filename))
+    outputBytes = 0
+    outputs = [f.findtext('PFN', '').strip() for f in root.findall('File')]
+    outputs += [f.find('FileName').get('Value') for f in root.findall('AnalysisFile') if f.find('FileName') is not None]
+    for output in outputs:
+        path = os.path.join(directory, output.replace('file:', ''))
+        if output and os.path.exists(path): outputBytes += os.path.getsize(path)
+    readMegabytes = float(metrics.get('Timing-tstoragefile-read-totalMegabytes', 0))
+    return {'events': events, 'lumis': lumis, 'seconds': float(metrics['TotalJobTime']),
+            'readBytes': int(readMegabytes * 1024 * 1024), 'outputBytes': outputBytes}
+
+
+def fit(jobs, overhead):
+    """Least squares fit of seconds = overhead + secondsPerEvent * events, fixed overhead if events do not vary"""
+    n = len(jobs)
+    x = [float(j['events']) for j in jobs]
+    y = [j['seconds'] for j in jobs]
+    mx, my = sum(x)/n, sum(y)/n
+    sxx = sum((xi - mx)**2 for xi in x)
+    if n >= 2 and sxx > 0:
+        slope = sum((xi - mx)*(yi - my) for xi, yi in zip(x, y)) / sxx
+        intercept = my - slope*mx
+        if slope > 0 and intercept >= 0: return intercept, slope
+    if sum(y) > n*overhead: return overhead, (sum(y) - n*overhead) / sum(x)
+    return 0., sum(y) / sum(x) # Jobs shorter than the assumed overhead
+
+
+def cost_model(jobs, overhead):
+    events = sum(j['events'] for j in jobs)
+    lumis = sum(j['lumis'] for j in jobs)
+    jobOverhead, secondsPerEvent = fit(jobs, overhead)
+    return {'jobs': len(jobs), 'events': events,
+            'overhead': jobOverhead, 'secondsPerEvent': secondsPerEvent,
+            'eventsPerLumi': float(events) / lumis if lumis else 0.,
+            'readBytesPerEvent': float(sum(j['readBytes'] for j in jobs)) / events,
+            'outputBytesPerEvent': float(sum(j['outputBytes'] for j in jobs)) / events}
+
+
+def load_costs(filename):
+    if not os.path.exists(filename): return {}
+    with open(filename) as ifile:
+        return json.load(ifile)
+
+
+def measure(args):
+    costs = load_costs(args.costs)
+    jobs = costs.setdefault(args.dataset, {})
+    nnew = 0
+    for report in find_reports(args.reports):
+        job = parse_report(report)
+        if job is None: continue
+        jobs[os.path.abspath(report)] = job # Keyed by report, measuring the same jobs again does not double count
+        nnew += 1
+    with open(args.costs, 'w') as ofile:
+        json.dump(costs, ofile, indent=1, sort_keys=True)
+    if not jobs:
+        print('splitPlanner: no successful jobs for %s' % args.dataset)
+        return 1
+    model = cost_model(list(jobs.values()), args.overhead)
+    print('splitPlanner: %s: %d reports read, %d jobs, %.3g s/event + %.3g s/job, %.3g kB/event read, %.3g kB/event written' %
+          (args.dataset, nnew, model['jobs'], model['secondsPerEvent'], model['overhead'],
+           model['readBytesPerEvent']/1024, model['outputBytesPerEvent']/1024))
+    return 0
+
+
+def plan_dataset(model, isData, args):
+    """unitsPerJob, splitting and expected job duration"""
+    target = args.target_hours * 3600.
+    eventsPerJob = max(1., (target - model['overhead']) / (model['secondsPerEvent'] * args.safety))
+    if model['outputBytesPerEvent'] > 0:
+        eventsPerJob = min(eventsPerJob, args.max_output_mb * 1024 * 1024 / model['outputBytesPerEvent'])
+    if isData and model['eventsPerLumi'] > 0:
+        units = max(1, int(eventsPerJob / model['eventsPerLumi']))
+        eventsPerJob = units * model['eventsPerLumi']
+        splitting = 'LumiBased'
+    else:
+        units = max(1, int(eventsPerJob))
+        eventsPerJob = units
+        splitting = 'EventAwareLumiBased'
+    seconds = model['overhead'] + eventsPerJob * model['secondsPerEvent']
+    return units, splitting, seconds
+
+
+def load_datasets(filename, args):
+    """dataset objects of a multicrab script, or datasets built from the alias variables of a datasets_*.py file,
+    and whether the entries are aliases (printed as variable names, for multicrab scripts importing the file)"""
+    # Multicrab scripts import datasets.py and wrappers.py from crabUtils
+    for path in (os.path.dirname(os.path.abspath(filename)), os.path.dirname(os.path.abspath(__file__))):
+        if path not in sys.path: sys.path.insert(0, path)
+    from datasets import dataset
+    definitions = runpy.run_path(filename)
+    if isinstance(definitions.get('datasets'), list):
+        return [d for d in definitions['datasets'] if hasattr(d, 'fullpath')], False
+    aliases = sorted(k for k, v in definitions.items() if not k.startswith('_') and isinstance(v, str) and v.startswith('/'))
+    unknown = set(args.data) - set(aliases)
+    if unknown: raise SystemExit('splitPlanner: --data aliases not in %s: %s' % (filename, ', '.join(sorted(unknown))))
+    return [dataset(alias, definitions[alias], alias in args.data, priority=args.priority, label=args.label,
+                    inputDBS='phys03' if definitions[alias].endswith('/USER') else 'global')
+            for alias in aliases], True
+
+
+def plan(args):
+    costs = load_costs(args.costs)
+    plans = []
+    datasets, fromAliases = load_datasets(args.datasets, args)
+    for d in datasets:
+        alias = d.alias
+        isData = bool(d.isData)
+        jobs = costs.get(alias) or costs.get(args.fallback, {})
+        if not jobs:
+            print('    # %s: no measurements, run splitPlanner.py measure --dataset %s first' % (alias, alias))
+            continue
+        model = cost_model(list(jobs.values()), args.overhead)
+        units, splitting, seconds = plan_dataset(model, isData, args)
+        options = ", splitting='%s' , priority=%d , label='%s'" % (splitting, d.priority, d.label)
+        if d.inputDBS != 'global': options += " , inputDBS='%s'" % d.inputDBS
+        if getattr(d, 'doHLT', 1) != 1: options += ' , doHLT=%d' % d.doHLT
+        if getattr(d, 'doJetFilter', 0) != 0: options += ' , doJetFilter=%d' % d.doJetFilter
+        print('    dataset( "%s" , %s , %s , %d , 100000000 %s ) , # %.3g s/event, %.0f kB/event, ~%.1f h/job' %
+              (alias, alias if fromAliases else '"%s"' % d.fullpath, 'DATA' if isData else 'MC', units, options,
+               model['secondsPerEvent'], model['outputBytesPerEvent']/1024, seconds/3600.))
+        plans.append({'alias': alias, 'fullpath': d.fullpath, 'isData': isData, 'priority': d.priority, 'label': d.label,
+                      'inputDBS': d.inputDBS, 'unitsPerJob': units, 'splitting': splitting,
+                      'expectedSeconds': seconds, 'model': model})
+    if args.json:
+        with open(args.json, 'w') as ofile:
+            json.dump(plans, ofile, indent=1, sort_keys=True)
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Plan CRAB job splitting from measured per-dataset throughput')
+    parser.add_argument('--costs', default='splitCosts.json', help='Measurement database')
+    parser.add_argument('--overhead', type=float, default=60., help='Fixed seconds per job, if it can not be fitted')
+    subparsers = parser.add_subparsers(dest='command')
+    parser_measure = subparsers.add_parser('measure', help='Record job reports of a dataset')
+    parser_measure.add_argument('--dataset', required=True, help='Dataset alias, as in datasets_*.py')
+    parser_measure.add_argument('reports', nargs='+', help='FrameworkJobReport xml files or directories containing them')
+    parser_plan = subparsers.add_parser('plan', help='Print dataset entries with balanced splitting')
+    parser_plan.add_argument('datasets', help='datasets_*.py file, or multicrab script with a datasets list')
+    parser_plan.add_argument('--data', action='append', default=[], metavar='ALIAS',
+                             help='Alias of a data dataset in a datasets_*.py file, can be repeated')
+    parser_plan.add_argument('--priority', type=int, default=1, help='JobType.priority of datasets from a datasets_*.py file')
+    parser_plan.add_argument('--label', default='', help='Label of datasets from a datasets_*.py file')
+    parser_plan.add_argument('--target-hours', type=float, default=8., help='Target job duration')
+    parser_plan.add_argument('--safety', type=float, default=1.2, help='Factor applied to seconds per event')
+    parser_plan.add_argument('--max-output-mb', type=float, default=4000., help='Maximum output size per job')
+    parser_plan.add_argument('--fallback', default='', help='Alias whose measurements are used for datasets without any')
+    parser_plan.add_argument('--json', default='', help='Also write plan to this json file')
+    args = parser.parse_args()
+    if args.command == 'measure': sys.exit(measure(args))
+    elif args.command == 'plan': sys.exit(plan(args))
+    parser.print_help()
+    sys.exit(1)